@@ -0,0 +1,286 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_TOOL_THREAD_H_
+#define SINSY_TOOL_THREAD_H_
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+// threads and mutexes of command line tools (tools use only public headers of the library)
+namespace sinsy
+{
+
+class ToolCondition;
+
+class ToolMutex
+{
+public:
+   //! constructor
+   ToolMutex() {
+#ifdef _WIN32
+      InitializeCriticalSection(&mutex);
+#else
+      pthread_mutex_init(&mutex, NULL);
+#endif
+   }
+
+   //! destructor
+   virtual ~ToolMutex() {
+#ifdef _WIN32
+      DeleteCriticalSection(&mutex);
+#else
+      pthread_mutex_destroy(&mutex);
+#endif
+   }
+
+   //! lock
+   void lock() {
+#ifdef _WIN32
+      EnterCriticalSection(&mutex);
+#else
+      pthread_mutex_lock(&mutex);
+#endif
+   }
+
+   //! unlock
+   void unlock() {
+#ifdef _WIN32
+      LeaveCriticalSection(&mutex);
+#else
+      pthread_mutex_unlock(&mutex);
+#endif
+   }
+
+private:
+   //! copy constructor (donot use)
+   ToolMutex(const ToolMutex&);
+
+   //! assignment operator (donot use)
+   ToolMutex& operator=(const ToolMutex&);
+
+#ifdef _WIN32
+   //! critical section
+   CRITICAL_SECTION mutex;
+#else
+   //! mutex
+   pthread_mutex_t mutex;
+#endif
+
+   friend class ToolCondition;
+};
+
+class ToolLock
+{
+public:
+   //! constructor (lock)
+   explicit ToolLock(ToolMutex& m) : mutex(m) {
+      mutex.lock();
+   }
+
+   //! destructor (unlock)
+   virtual ~ToolLock() {
+      mutex.unlock();
+   }
+
+private:
+   //! copy constructor (donot use)
+   ToolLock(const ToolLock&);
+
+   //! assignment operator (donot use)
+   ToolLock& operator=(const ToolLock&);
+
+   //! mutex
+   ToolMutex& mutex;
+};
+
+class ToolCondition
+{
+public:
+   //! constructor
+   ToolCondition() {
+#ifdef _WIN32
+      InitializeConditionVariable(&condition);
+#else
+      pthread_cond_init(&condition, NULL);
+#endif
+   }
+
+   //! destructor
+   virtual ~ToolCondition() {
+#ifndef _WIN32
+      pthread_cond_destroy(&condition);
+#endif
+   }
+
+   //! wait for signal (mutex has to be locked)
+   void wait(ToolMutex& mutex) {
+#ifdef _WIN32
+      SleepConditionVariableCS(&condition, &mutex.mutex, INFINITE);
+#else
+      pthread_cond_wait(&condition, &mutex.mutex);
+#endif
+   }
+
+   //! wake up one waiting thread
+   void signal() {
+#ifdef _WIN32
+      WakeConditionVariable(&condition);
+#else
+      pthread_cond_signal(&condition);
+#endif
+   }
+
+   //! wake up all waiting threads
+   void broadcast() {
+#ifdef _WIN32
+      WakeAllConditionVariable(&condition);
+#else
+      pthread_cond_broadcast(&condition);
+#endif
+   }
+
+private:
+   //! copy constructor (donot use)
+   ToolCondition(const ToolCondition&);
+
+   //! assignment operator (donot use)
+   ToolCondition& operator=(const ToolCondition&);
+
+#ifdef _WIN32
+   //! condition variable
+   CONDITION_VARIABLE condition;
+#else
+   //! condition variable
+   pthread_cond_t condition;
+#endif
+};
+
+class IToolRunnable
+{
+public:
+   //! destructor
+   virtual ~IToolRunnable() {}
+
+   //! run in thread
+   virtual void run() = 0;
+};
+
+#ifdef _WIN32
+//! entry point of thread
+inline unsigned __stdcall runToolThread(void* runnable)
+{
+   static_cast<IToolRunnable*>(runnable)->run();
+   return 0;
+}
+#else
+//! entry point of thread
+extern "C" inline void* runToolThread(void* runnable)
+{
+   static_cast<IToolRunnable*>(runnable)->run();
+   return NULL;
+}
+#endif
+
+class ToolThread
+{
+public:
+   //! constructor
+   explicit ToolThread(IToolRunnable& r) : runnable(r), started(false) {}
+
+   //! destructor (wait for the thread if it is running)
+   virtual ~ToolThread() {
+      join();
+   }
+
+   //! start thread
+   bool start() {
+#ifdef _WIN32
+      thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, runToolThread, &runnable, 0, NULL));
+      started = (0 != thread);
+#else
+      started = (0 == pthread_create(&thread, NULL, runToolThread, &runnable));
+#endif
+      return started;
+   }
+
+   //! wait for thread
+   void join() {
+      if (!started) {
+         return;
+      }
+#ifdef _WIN32
+      WaitForSingleObject(thread, INFINITE);
+      CloseHandle(thread);
+#else
+      pthread_join(thread, NULL);
+#endif
+      started = false;
+   }
+
+private:
+   //! copy constructor (donot use)
+   ToolThread(const ToolThread&);
+
+   //! assignment operator (donot use)
+   ToolThread& operator=(const ToolThread&);
+
+   //! runnable object
+   IToolRunnable& runnable;
+
+   //! thread is started or not
+   bool started;
+
+#ifdef _WIN32
+   //! handle of thread
+   HANDLE thread;
+#else
+   //! thread
+   pthread_t thread;
+#endif
+};
+
+};  // namespace sinsy
+
+#endif // SINSY_TOOL_THREAD_H_
@@ -43,13 +43,313 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <iomanip>
+#include <vector>
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
 #include "sinsy.h"
+#include "ToolThread.h"
 
 namespace
 {
 const char* DEFAULT_LANGS = "j";
+const char* VALUE_OPTIONS = "wxmojbnlLte"; // options followed by a value
+
+/*!
+ get current time in seconds
+ */
+double getTime()
+{
+#ifdef _WIN32
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+   return static_cast<double>(counter.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+   struct timeval tv;
+   gettimeofday(&tv, NULL);
+   return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1.0e-6;
+#endif
+}
+
+/*!
+ settings shared by batch workers
+ */
+struct BatchSetting {
+   const sinsy::Languages* languages; //!< languages set up once
+   const sinsy::Voice* voice; //!< voice loaded once
+   size_t threadNum; //!< number of threads for each job
+   bool phraseSplitFlag; //!< phrase split flag
+};
+
+/*!
+ jobs of batch mode: each line of manifest is "infile outfile" ('#' begins comment)
+ */
+class BatchJobs
+{
+public:
+   //! constructor
+   explicit BatchJobs(std::istream& s) : stream(s), lineNum(0), jobNum(0), failedNum(0) {}
+
+   //! get next job (return false if there is no job)
+   bool next(std::string& xml, std::string& wav) {
+      sinsy::ToolLock lock(mutex);
+      std::string line;
+      while (std::getline(stream, line)) {
+         ++lineNum;
+         const size_t commentPos(line.find('#'));
+         if (std::string::npos != commentPos) {
+            line.erase(commentPos);
+         }
+         std::istringstream iss(line);
+         std::string rest;
+         if (!(iss >> xml)) {
+            continue; // empty line
+         }
+         if (!(iss >> wav) || (iss >> rest)) {
+            std::cout << "[ERROR] invalid line " << lineNum << " of manifest : " << line << std::endl;
+            ++jobNum;
+            ++failedNum;
+            continue;
+         }
+         ++jobNum;
+         return true;
+      }
+      return false;
+   }
+
+   //! report result of job
+   void report(const std::string& xml, const std::string& wav, bool result, double time) {
+      sinsy::ToolLock lock(mutex);
+      if (result) {
+         std::cout << "[OK] " << xml << " -> " << wav << " : " << std::fixed << std::setprecision(3) << time << " sec" << std::endl;
+      } else {
+         std::cout << "[ERROR] " << xml << " -> " << wav << " : failed" << std::endl;
+         ++failedNum;
+      }
+   }
+
+   //! get number of jobs
+   size_t getJobNum() const {
+      return jobNum;
+   }
+
+   //! get number of failed jobs
+   size_t getFailedNum() const {
+      return failedNum;
+   }
+
+private:
+   //! copy constructor (donot use)
+   BatchJobs(const BatchJobs&);
+
+   //! assignment operator (donot use)
+   BatchJobs& operator=(const BatchJobs&);
+
+   //! mutex
+   sinsy::ToolMutex mutex;
+
+   //! manifest
+   std::istream& stream;
+
+   //! number of read lines
+   size_t lineNum;
+
+   //! number of jobs
+   size_t jobNum;
+
+   //! number of failed jobs
+   size_t failedNum;
+};
+
+/*!
+ worker of batch mode: synthesizes jobs with one Sinsy object
+ */
+class BatchWorker : public sinsy::IToolRunnable
+{
+public:
+   //! constructor
+   BatchWorker(BatchJobs& j, const BatchSetting& s) : jobs(j), setting(s) {}
+
+   //! destructor
+   virtual ~BatchWorker() {}
+
+   //! synthesize jobs until there is no job
+   virtual void run() {
+      sinsy::Sinsy sinsy;
+      sinsy.setThreadNum(setting.threadNum);
+      const bool ready(sinsy.setLanguages(*setting.languages) && sinsy.attachVoice(*setting.voice));
+
+      std::string xml;
+      std::string wav;
+      while (jobs.next(xml, wav)) {
+         const double begin(getTime());
+         bool result(ready);
+         if (result) {
+            sinsy.clearScore();
+            result = sinsy.loadScoreFromMusicXML(xml);
+         }
+         if (result) {
+            sinsy::SynthCondition condition;
+            if (setting.phraseSplitFlag) {
+               condition.setPhraseSplitFlag();
+            }
+            condition.setSaveFilePath(wav);
+            result = sinsy.synthesize(condition);
+         }
+         jobs.report(xml, wav, result, getTime() - begin);
+      }
+   }
+
+private:
+   //! copy constructor (donot use)
+   BatchWorker(const BatchWorker&);
+
+   //! assignment operator (donot use)
+   BatchWorker& operator=(const BatchWorker&);
+
+   //! jobs
+   BatchJobs& jobs;
+
+   //! settings
+   const BatchSetting& setting;
+};
+
+/*!
+ synthesize all jobs in manifest by workers
+ */
+int runBatch(const std::string& manifest, size_t workerNum, BatchSetting& setting,
+             const std::string& languageFlags, const std::string& config, const std::string& voicePath)
+{
+   const double begin(getTime());
+
+   // dictionaries and voices are shared by all workers
+   sinsy::Languages languages;
+   if (!languages.set(languageFlags, config)) {
+      std::cout << "[ERROR] failed to set languages : " << languageFlags << ", config dir : " << config << std::endl;
+      return -1;
+   }
+   setting.languages = &languages;
+
+   std::vector<std::string> voices;
+   voices.push_back(voicePath);
+   sinsy::Voice voice;
+   if (!voice.load(voices)) {
+      std::cout << "[ERROR] failed to load voices : " << voicePath << std::endl;
+      return -1;
+   }
+   setting.voice = &voice;
+
+   std::ifstream ifs;
+   if ("-" != manifest) {
+      ifs.open(manifest.c_str());
+      if (!ifs) {
+         std::cout << "[ERROR] failed to open manifest : " << manifest << std::endl;
+         return -1;
+      }
+   }
+   BatchJobs jobs(("-" == manifest) ? std::cin : ifs);
+
+   // first worker runs in this thread
+   std::vector<BatchWorker*> workers;
+   std::vector<sinsy::ToolThread*> threads;
+   for (size_t i(0); i < workerNum; ++i) {
+      workers.push_back(new BatchWorker(jobs, setting));
+   }
+   for (size_t i(1); i < workerNum; ++i) {
+      sinsy::ToolThread* thread(new sinsy::ToolThread(*workers[i]));
+      if (!thread->start()) {
+         delete thread;
+         break;
+      }
+      threads.push_back(thread);
+   }
+   workers[0]->run();
+   for (size_t i(0); i < threads.size(); ++i) {
+      delete threads[i];
+   }
+   for (size_t i(0); i < workers.size(); ++i) {
+      delete workers[i];
+   }
+
+   std::cout << "[INFO] " << jobs.getJobNum() << " files, " << jobs.getFailedNum() << " failed : "
+             << std::fixed << std::setprecision(3) << (getTime() - begin) << " sec" << std::endl;
+   return (0 == jobs.getFailedNum()) ? 0 : -1;
+}
 };
 
+int outputLabel(const std::string& xml, const std::string& label, const std::string& languages, const std::string& config,
+                size_t threadNum, bool monophoneFlag, int overwriteEnableFlag, int timeFlag)
+{
+   sinsy::Sinsy sinsy;
+   sinsy.setThreadNum(threadNum);
+
+   if (!sinsy.setLanguages(languages, config)) {
+      std::cerr << "[ERROR] failed to set languages : " << languages << ", config dir : " << config << std::endl;
+      return -1;
+   }
+
+   if (!sinsy.loadScoreFromMusicXML(xml)) {
+      std::cerr << "[ERROR] failed to load score from MusicXML file : " << xml << std::endl;
+      return -1;
+   }
+
+   // labels are written one by one, so stdout can be piped to other tools
+   bool result(false);
+   if ("-" == label) {
+      sinsy::LabelStream stream(std::cout);
+      result = sinsy.outputLabel(stream, monophoneFlag, overwriteEnableFlag, timeFlag);
+      std::cout.flush();
+   } else {
+      std::ofstream ofs(label.c_str());
+      if (!ofs) {
+         std::cerr << "[ERROR] cannot open label file : " << label << std::endl;
+         return -1;
+      }
+      sinsy::LabelStream stream(ofs);
+      result = sinsy.outputLabel(stream, monophoneFlag, overwriteEnableFlag, timeFlag);
+      ofs.close();
+      if (!ofs) {
+         result = false;
+      }
+   }
+   if (!result) {
+      std::cerr << "[ERROR] failed to output labels : " << label << std::endl;
+      return -1;
+   }
+   return 0;
+}
+
+int synthesizeFromLabel(const std::string& label, bool timeFlag, const std::string& voice, const std::string& wav, size_t threadNum)
+{
+   sinsy::Sinsy sinsy;
+   sinsy.setThreadNum(threadNum);
+
+   std::vector<std::string> voices;
+   voices.push_back(voice);
+
+   if (!sinsy.loadVoices(voices)) {
+      std::cout << "[ERROR] failed to load voices : " << voice << std::endl;
+      return -1;
+   }
+
+   sinsy::SynthCondition condition;
+
+   if (wav.empty()) {
+      condition.setPlayFlag();
+   } else {
+      condition.setSaveFilePath(wav);
+   }
+
+   if (!sinsy.synthesizeFromLabelFile(label, condition, timeFlag)) {
+      std::cout << "[ERROR] failed to synthesize from label file : " << label << std::endl;
+      return -1;
+   }
+   return 0;
+}
+
 void usage()
 {
    std::cout << "The HMM-Based Singing Voice Syntheis System \"Sinsy\"" << std::endl;
@@ -67,6 +367,9 @@ void usage()
    std::cout << "" << std::endl;
    std::cout << "  usage:" << std::endl;
    std::cout << "    sinsy [ options ] [ infile ]" << std::endl;
+   std::cout << "    sinsy [ options ] -b manifest" << std::endl;
+   std::cout << "    sinsy [ options ] -l labfile infile" << std::endl;
+   std::cout << "    sinsy [ options ] -L labfile" << std::endl;
    std::cout << "  options:                                           [def]" << std::endl;
    std::cout << "    -w langs    : languages                          [  j]" << std::endl;
    std::cout << "                  j: Japanese                             " << std::endl;
@@ -74,6 +377,23 @@ void usage()
    std::cout << "    -x dir      : dictionary directory               [N/A]" << std::endl;
    std::cout << "    -m htsvoice : HTS voice file                     [N/A]" << std::endl;
    std::cout << "    -o file     : filename of output wav audio       [N/A]" << std::endl;
+   std::cout << "    -j num      : number of threads                  [  1]" << std::endl;
+   std::cout << "    -p          : synthesize phrase by phrase        [N/A]" << std::endl;
+   std::cout << "    -b manifest : batch mode (\"-\" for stdin)         [N/A]" << std::endl;
+   std::cout << "                  each line is \"infile outfile\"         " << std::endl;
+   std::cout << "    -n num      : number of workers in batch mode    [  1]" << std::endl;
+   std::cout << "    -l file     : output labels instead of audio     [N/A]" << std::endl;
+   std::cout << "                  (\"-\" for stdout, no voice needed)    " << std::endl;
+   std::cout << "    -M          : output monophone labels            [N/A]" << std::endl;
+   std::cout << "    -t num      : time of labels                     [  0]" << std::endl;
+   std::cout << "                  0: no time                              " << std::endl;
+   std::cout << "                  1: begin and end time of all phonemes   " << std::endl;
+   std::cout << "                  2: begin and end time of notes only     " << std::endl;
+   std::cout << "    -e num      : overwrite enable flag of labels    [  0]" << std::endl;
+   std::cout << "                  (0 ... 2)                               " << std::endl;
+   std::cout << "    -L file     : synthesize from label file         [N/A]" << std::endl;
+   std::cout << "                  (full-context labels instead of infile) " << std::endl;
+   std::cout << "    -I          : ignore times in labels of -L       [N/A]" << std::endl;
    std::cout << "  infile:" << std::endl;
    std::cout << "    MusicXML file" << std::endl;
 }
@@ -90,6 +410,16 @@ int main(int argc, char **argv)
    std::string config;
    std::string wav;
    std::string languages(DEFAULT_LANGS);
+   size_t threadNum(1);
+   bool phraseSplitFlag(false);
+   std::string manifest;
+   size_t workerNum(1);
+   std::string label;
+   bool monophoneFlag(false);
+   int timeFlag(0);
+   int overwriteEnableFlag(0);
+   std::string inputLabel;
+   bool labelTimeFlag(true);
 
    int i(1);
    for(; i < argc; ++i) {
@@ -102,6 +432,11 @@ int main(int argc, char **argv)
             return -1;
          }
       } else {
+         if (('\0' != argv[i][1]) && (NULL != strchr(VALUE_OPTIONS, argv[i][1])) && (argc <= i + 1)) {
+            std::cout << "[ERROR] no value for option : '-" << argv[i][1] << "'" << std::endl;
+            usage();
+            return -1;
+         }
          switch (argv[i][1]) {
          case 'w' :
             languages = argv[++i];
@@ -115,6 +450,56 @@ int main(int argc, char **argv)
          case 'o' :
             wav = argv[++i];
             break;
+         case 'j' : {
+            std::istringstream iss(argv[++i]);
+            if (!(iss >> threadNum) || (0 == threadNum)) {
+               std::cout << "[ERROR] invalid number of threads : " << argv[i] << std::endl;
+               return -1;
+            }
+            break;
+         }
+         case 'p' :
+            phraseSplitFlag = true;
+            break;
+         case 'b' :
+            manifest = argv[++i];
+            break;
+         case 'n' : {
+            std::istringstream iss(argv[++i]);
+            if (!(iss >> workerNum) || (0 == workerNum)) {
+               std::cout << "[ERROR] invalid number of workers : " << argv[i] << std::endl;
+               return -1;
+            }
+            break;
+         }
+         case 'l' :
+            label = argv[++i];
+            break;
+         case 'L' :
+            inputLabel = argv[++i];
+            break;
+         case 'I' :
+            labelTimeFlag = false;
+            break;
+         case 'M' :
+            monophoneFlag = true;
+            break;
+         case 't' : {
+            std::istringstream iss(argv[++i]);
+            if (!(iss >> timeFlag) || (timeFlag < 0) || (2 < timeFlag)) {
+               std::cout << "[ERROR] invalid time flag : " << argv[i] << std::endl;
+               return -1;
+            }
+            break;
+         }
+         case 'e' : {
+            std::istringstream iss(argv[++i]);
+            if (!(iss >> overwriteEnableFlag) || (overwriteEnableFlag < 0) || (2 < overwriteEnableFlag)) {
+               std::cout << "[ERROR] invalid overwrite enable flag : " << argv[i] << std::endl;
+               return -1;
+            }
+            break;
+         }
          case 'h' :
             usage();
             return 0;
@@ -126,12 +511,42 @@ int main(int argc, char **argv)
       }
    }
 
+   if (!label.empty()) {
+      if (xml.empty() || !manifest.empty() || !wav.empty()) {
+         usage();
+         return -1;
+      }
+      return outputLabel(xml, label, languages, config, threadNum, monophoneFlag, overwriteEnableFlag, timeFlag);
+   }
+
+   if (!manifest.empty()) {
+      if (!xml.empty() || !wav.empty() || voice.empty()) {
+         usage();
+         return -1;
+      }
+      BatchSetting setting;
+      setting.languages = NULL;
+      setting.voice = NULL;
+      setting.threadNum = threadNum;
+      setting.phraseSplitFlag = phraseSplitFlag;
+      return runBatch(manifest, workerNum, setting, languages, config, voice);
+   }
+
+   if (!inputLabel.empty()) {
+      if (!xml.empty() || voice.empty()) {
+         usage();
+         return -1;
+      }
+      return synthesizeFromLabel(inputLabel, labelTimeFlag, voice, wav, threadNum);
+   }
+
    if(xml.empty() || voice.empty()) {
       usage();
       return -1;
    }
 
    sinsy::Sinsy sinsy;
+   sinsy.setThreadNum(threadNum);
 
    std::vector<std::string> voices;
    voices.push_back(voice);
@@ -153,6 +568,10 @@ int main(int argc, char **argv)
 
    sinsy::SynthCondition condition;
 
+   if (phraseSplitFlag) {
+      condition.setPhraseSplitFlag();
+   }
+
    if (wav.empty()) {
       condition.setPlayFlag();
    } else {
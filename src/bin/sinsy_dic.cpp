@@ -0,0 +1,117 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <iostream>
+#include <string>
+#include "sinsy.h"
+
+namespace
+{
+const char* DEFAULT_IMAGE_NAME = "japanese.dic";
+
+/*!
+ usage
+ */
+void usage()
+{
+   std::cout << "The HMM-Based Singing Voice Syntheis System \"Sinsy\"" << std::endl;
+   std::cout << "Version 0.92 (http://sinsy.sourceforge.net/)" << std::endl;
+   std::cout << "Copyright (C) 2009-2015 Nagoya Institute of Technology" << std::endl;
+   std::cout << "All rights reserved." << std::endl;
+   std::cout << "" << std::endl;
+   std::cout << "sinsy_dic - Dictionary compiler of \"Sinsy\"" << std::endl;
+   std::cout << "" << std::endl;
+   std::cout << "  usage:" << std::endl;
+   std::cout << "    sinsy_dic [ options ]" << std::endl;
+   std::cout << "  options:                                           [def]" << std::endl;
+   std::cout << "    -x dir      : dictionary directory               [N/A]" << std::endl;
+   std::cout << "    -o file     : filename of dictionary image       [N/A]" << std::endl;
+   std::cout << "                  (dir/japanese.dic if not specified)     " << std::endl;
+   std::cout << "  note:" << std::endl;
+   std::cout << "    sinsy uses japanese.dic in dictionary directory instead of" << std::endl;
+   std::cout << "    text files. If they are edited after compiling it, sinsy" << std::endl;
+   std::cout << "    warns and uses text files until it is compiled again." << std::endl;
+}
+};
+
+int main(int argc, char **argv)
+{
+   if (argc < 2) {
+      usage();
+      return -1;
+   }
+
+   std::string config;
+   std::string image;
+
+   for (int i(1); i < argc; ++i) {
+      if (('-' != argv[i][0]) || (argc <= i + 1)) {
+         std::cout << "[ERROR] invalid option : " << argv[i] << std::endl;
+         usage();
+         return -1;
+      }
+      switch (argv[i][1]) {
+      case 'x' :
+         config = argv[++i];
+         break;
+      case 'o' :
+         image = argv[++i];
+         break;
+      default :
+         std::cout << "[ERROR] invalid option : '-" << argv[i][1] << "'" << std::endl;
+         usage();
+         return -1;
+      }
+   }
+
+   if (config.empty()) {
+      usage();
+      return -1;
+   }
+   if (image.empty()) {
+      image = config + "/" + DEFAULT_IMAGE_NAME;
+   }
+
+   if (!sinsy::Sinsy::compileDictionary(config, image)) {
+      std::cout << "[ERROR] failed to compile dictionary : " << config << std::endl;
+      return -1;
+   }
+   return 0;
+}
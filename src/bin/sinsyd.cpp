@@ -0,0 +1,869 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <iostream>
+#include <sstream>
+#include "sinsy.h"
+#include "ToolThread.h"
+
+#ifdef _WIN32
+
+int main(int argc, char **argv)
+{
+   std::cout << "[ERROR] sinsyd is not supported on this platform" << std::endl;
+   return -1;
+}
+
+#else
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace
+{
+const char* DEFAULT_LANGS = "j";
+const size_t MAX_HEADER_SIZE = 256;
+const size_t MAX_REQUEST_SIZE = 64 * 1024 * 1024;
+const size_t MAX_IDLE_CLIENTS = 256;
+const size_t PENDING_REQUESTS_PER_WORKER = 4;
+const size_t RECEIVE_SIZE = 64 * 1024;
+const int IDLE_TIMEOUT = 5; // sec
+const int SEND_TIMEOUT = 30; // sec
+const int POLL_INTERVAL = 1000; // msec
+
+volatile sig_atomic_t stopFlag = 0;
+
+/*!
+ signal handler
+ */
+extern "C" void handleSignal(int)
+{
+   stopFlag = 1;
+}
+
+/*!
+ write all data to socket
+ */
+bool writeAll(int fd, const void* data, size_t size)
+{
+   const char* ptr(static_cast<const char*>(data));
+   while (0 < size) {
+      const ssize_t result(::write(fd, ptr, size));
+      if (result < 0) {
+         if (EINTR == errno) {
+            continue;
+         }
+         return false;
+      }
+      ptr += result;
+      size -= static_cast<size_t>(result);
+   }
+   return true;
+}
+
+/*!
+ write string to socket
+ */
+bool writeString(int fd, const std::string& str)
+{
+   return writeAll(fd, str.data(), str.size());
+}
+
+/*!
+ write short reply from main loop without blocking (return false if whole reply cannot be written at once)
+ */
+bool writeReply(int fd, const std::string& str)
+{
+   return static_cast<ssize_t>(str.size()) == send(fd, str.data(), str.size(), MSG_DONTWAIT);
+}
+
+/*!
+ read full-context labels (one label per line)
+ */
+bool readLabels(const std::string& data, sinsy::LabelStrings& label)
+{
+   std::string::size_type begin(0);
+   while (begin < data.size()) {
+      std::string::size_type end(data.find('\n', begin));
+      if (std::string::npos == end) {
+         end = data.size();
+      }
+      std::string line(data, begin, end - begin);
+      begin = end + 1;
+      const std::string::size_type last(line.find_last_not_of(" \t\r"));
+      if (std::string::npos == last) {
+         continue; // empty line
+      }
+      line.erase(last + 1);
+      label.output(line);
+   }
+   return 0 < label.size();
+}
+
+/*!
+ write chunk ("<size>\n" and data)
+ */
+bool writeChunk(int fd, const char* data, size_t size)
+{
+   std::ostringstream oss;
+   oss << size << "\n";
+   return writeString(fd, oss.str()) && writeAll(fd, data, size);
+}
+
+/*!
+ connection with client
+ */
+struct Connection {
+   int fd; //!< socket
+   std::string received; //!< received data which is not taken as request yet
+   time_t lastTime; //!< time when data was received last
+};
+
+/*!
+ close connection
+ */
+void closeConnection(Connection* connection)
+{
+   ::close(connection->fd);
+   delete connection;
+}
+
+/*!
+ receive data from client (return false at end of connection)
+ */
+bool receive(Connection& connection)
+{
+   char buffer[RECEIVE_SIZE];
+   const ssize_t result(::read(connection.fd, buffer, sizeof(buffer)));
+   if (result < 0) {
+      return (EINTR == errno) || (EAGAIN == errno);
+   }
+   if (0 == result) {
+      return false;
+   }
+   connection.received.append(buffer, static_cast<size_t>(result));
+   return true;
+}
+
+/*!
+ complete request
+ */
+struct Request {
+   Connection* connection; //!< connection (returned to main loop after response)
+   std::string type; //!< type of request
+   std::string format; //!< format of response
+   std::string body; //!< data of request
+};
+
+/*!
+ take complete request from received data
+
+ @return 1 if request is taken, 0 if more data is needed, -1 if connection should be closed
+ */
+int takeRequest(Connection& connection, Request& request)
+{
+   std::string& received(connection.received);
+   const std::string::size_type end(received.find('\n'));
+   if (std::string::npos == end) {
+      return (MAX_HEADER_SIZE <= received.size()) ? -1 : 0;
+   }
+   if (MAX_HEADER_SIZE <= end) {
+      return -1;
+   }
+   std::istringstream iss(received.substr(0, end));
+   size_t size(0);
+   std::string rest;
+   if (!(iss >> request.type >> request.format >> size) || (iss >> rest)) {
+      writeReply(connection.fd, "ERR invalid request\n");
+      return -1;
+   }
+   if (("xml" != request.type) && ("label" != request.type)) {
+      writeReply(connection.fd, "ERR unknown type : " + request.type + "\n");
+      return -1;
+   }
+   if (("wav" != request.format) && ("pcm" != request.format)) {
+      writeReply(connection.fd, "ERR unknown format : " + request.format + "\n");
+      return -1;
+   }
+   if (MAX_REQUEST_SIZE < size) {
+      writeReply(connection.fd, "ERR request is too large\n");
+      return -1;
+   }
+   if (received.size() - (end + 1) < size) {
+      return 0;
+   }
+   request.body.assign(received, end + 1, size);
+   received.erase(0, end + 1 + size);
+   return 1;
+}
+
+/*!
+ queue of complete requests which are passed to workers
+ */
+class RequestQueue
+{
+public:
+   //! constructor
+   explicit RequestQueue(size_t m) : maxSize(m), closed(false) {}
+
+   //! destructor
+   virtual ~RequestQueue() {
+      close();
+   }
+
+   //! push request (return false if queue is full)
+   bool push(Request* request) {
+      sinsy::ToolLock lock(mutex);
+      if (closed || (maxSize <= requests.size())) {
+         return false;
+      }
+      requests.push_back(request);
+      condition.signal();
+      return true;
+   }
+
+   //! pop request (return NULL if queue is closed)
+   Request* pop() {
+      sinsy::ToolLock lock(mutex);
+      while (requests.empty() && !closed) {
+         condition.wait(mutex);
+      }
+      if (requests.empty()) {
+         return NULL;
+      }
+      Request* request(requests.front());
+      requests.pop_front();
+      return request;
+   }
+
+   //! close queue (connections of requests which are not popped are closed)
+   void close() {
+      sinsy::ToolLock lock(mutex);
+      closed = true;
+      for (std::deque<Request*>::iterator itr(requests.begin()); requests.end() != itr; ++itr) {
+         closeConnection((*itr)->connection);
+         delete *itr;
+      }
+      requests.clear();
+      condition.broadcast();
+   }
+
+private:
+   //! copy constructor (donot use)
+   RequestQueue(const RequestQueue&);
+
+   //! assignment operator (donot use)
+   RequestQueue& operator=(const RequestQueue&);
+
+   //! mutex
+   sinsy::ToolMutex mutex;
+
+   //! condition
+   sinsy::ToolCondition condition;
+
+   //! requests
+   std::deque<Request*> requests;
+
+   //! max number of requests in queue
+   size_t maxSize;
+
+   //! closed or not
+   bool closed;
+};
+
+/*!
+ connections returned from workers to main loop (main loop is woken up by pipe)
+ */
+class ReturnQueue
+{
+public:
+   //! constructor
+   ReturnQueue() : readFd(-1), writeFd(-1) {}
+
+   //! destructor
+   virtual ~ReturnQueue() {
+      for (std::vector<Connection*>::iterator itr(connections.begin()); connections.end() != itr; ++itr) {
+         closeConnection(*itr);
+      }
+      if (0 <= readFd) {
+         ::close(readFd);
+         ::close(writeFd);
+      }
+   }
+
+   //! open pipe
+   bool open() {
+      int fds[2];
+      if (0 != pipe(fds)) {
+         return false;
+      }
+      readFd = fds[0];
+      writeFd = fds[1];
+      fcntl(readFd, F_SETFL, fcntl(readFd, F_GETFL) | O_NONBLOCK);
+      fcntl(writeFd, F_SETFL, fcntl(writeFd, F_GETFL) | O_NONBLOCK);
+      return true;
+   }
+
+   //! get file descriptor to wait for returned connections
+   int getFd() const {
+      return readFd;
+   }
+
+   //! return connection to main loop
+   void push(Connection* connection) {
+      {
+         sinsy::ToolLock lock(mutex);
+         connections.push_back(connection);
+      }
+      // pipe may be full of wake-up bytes already
+      const char c(0);
+      while ((::write(writeFd, &c, 1) < 0) && (EINTR == errno)) {
+      }
+   }
+
+   //! take returned connections
+   void take(std::vector<Connection*>& result) {
+      char buffer[64];
+      while (0 < ::read(readFd, buffer, sizeof(buffer))) {
+      }
+      sinsy::ToolLock lock(mutex);
+      result.insert(result.end(), connections.begin(), connections.end());
+      connections.clear();
+   }
+
+private:
+   //! copy constructor (donot use)
+   ReturnQueue(const ReturnQueue&);
+
+   //! assignment operator (donot use)
+   ReturnQueue& operator=(const ReturnQueue&);
+
+   //! mutex
+   sinsy::ToolMutex mutex;
+
+   //! returned connections
+   std::vector<Connection*> connections;
+
+   //! read end of pipe
+   int readFd;
+
+   //! write end of pipe
+   int writeFd;
+};
+
+/*!
+ pass complete requests of connection to workers (connection waits in main loop while more data is needed)
+ */
+void dispatch(Connection* connection, RequestQueue& queue, std::vector<Connection*>& waiting)
+{
+   for (;;) {
+      Request* request(new Request);
+      request->connection = connection;
+      const int result(takeRequest(*connection, *request));
+      if (0 < result) {
+         if (queue.push(request)) {
+            return;
+         }
+         delete request;
+         if (!writeReply(connection->fd, "ERR server is busy\n")) {
+            closeConnection(connection);
+            return;
+         }
+         continue;
+      }
+      delete request;
+      if (0 == result) {
+         waiting.push_back(connection);
+      } else {
+         closeConnection(connection);
+      }
+      return;
+   }
+}
+
+/*!
+ output of waveform which sends 16bit raw PCM phrase by phrase
+ */
+class PcmOutput : public sinsy::IWaveformOutput
+{
+public:
+   //! constructor
+   explicit PcmOutput(int f) : fd(f), failed(false) {}
+
+   //! destructor
+   virtual ~PcmOutput() {}
+
+   //! send waveform of phrase
+   virtual void output(const double* waveform, size_t size) {
+      if (failed) {
+         return;
+      }
+      // samples are sent in little endian as data chunk of RIFF format
+      buffer.resize(size * 2);
+      for (size_t i(0); i < size; ++i) {
+         const double x(waveform[i]);
+         const unsigned short value(static_cast<unsigned short>(static_cast<short>((32767.0 < x) ? 32767.0 : ((x < -32768.0) ? -32768.0 : x))));
+         buffer[i * 2] = static_cast<char>(value & 0xff);
+         buffer[i * 2 + 1] = static_cast<char>((value >> 8) & 0xff);
+      }
+      if (!writeChunk(fd, buffer.data(), buffer.size())) {
+         failed = true;
+      }
+   }
+
+   //! failed or not
+   bool isFailed() const {
+      return failed;
+   }
+
+private:
+   //! copy constructor (donot use)
+   PcmOutput(const PcmOutput&);
+
+   //! assignment operator (donot use)
+   PcmOutput& operator=(const PcmOutput&);
+
+   //! socket
+   int fd;
+
+   //! buffer to send
+   std::string buffer;
+
+   //! failed or not
+   bool failed;
+};
+
+/*!
+ settings shared by workers
+ */
+struct DaemonSetting {
+   const sinsy::Languages* languages; //!< languages set up once
+   const sinsy::Voice* voice; //!< voice loaded once
+   size_t threadNum; //!< number of threads for each request
+   bool phraseSplitFlag; //!< phrase split flag
+};
+
+/*!
+ worker which serves complete requests with one Sinsy object
+ */
+class DaemonWorker : public sinsy::IToolRunnable
+{
+public:
+   //! constructor
+   DaemonWorker(RequestQueue& q, ReturnQueue& r, const DaemonSetting& s) : queue(q), returnQueue(r), setting(s) {}
+
+   //! destructor
+   virtual ~DaemonWorker() {}
+
+   //! serve requests until queue is closed
+   virtual void run() {
+      sinsy::Sinsy sinsy;
+      sinsy.setThreadNum(setting.threadNum);
+      const bool ready(sinsy.setLanguages(*setting.languages) && sinsy.attachVoice(*setting.voice));
+      if (!ready) {
+         std::cout << "[ERROR] failed to prepare worker" << std::endl;
+      }
+
+      Request* request(NULL);
+      while (NULL != (request = queue.pop())) {
+         Connection* connection(request->connection);
+         const bool keepFlag(ready && serve(sinsy, *request));
+         delete request;
+         if (keepFlag) {
+            returnQueue.push(connection);
+         } else {
+            closeConnection(connection);
+         }
+      }
+   }
+
+private:
+   //! copy constructor (donot use)
+   DaemonWorker(const DaemonWorker&);
+
+   //! assignment operator (donot use)
+   DaemonWorker& operator=(const DaemonWorker&);
+
+   //! serve one request (return false if connection should be closed)
+   bool serve(sinsy::Sinsy& sinsy, const Request& request) {
+      const int fd(request.connection->fd);
+      sinsy.clearScore();
+      sinsy::LabelStrings label;
+      const bool labelFlag("label" == request.type);
+      if (labelFlag) {
+         if (!readLabels(request.body, label)) {
+            return writeString(fd, "ERR failed to load labels\n");
+         }
+      } else if (request.body.empty() || !sinsy.loadScoreFromMusicXMLData(request.body.data(), request.body.size())) {
+         return writeString(fd, "ERR failed to load score\n");
+      }
+
+      std::ostringstream oss;
+      oss << "OK " << sinsy.get_sampling_frequency() << "\n";
+
+      sinsy::SynthCondition condition;
+      if (setting.phraseSplitFlag) {
+         condition.setPhraseSplitFlag();
+      }
+      if ("wav" == request.format) {
+         std::vector<char> wave;
+         condition.setSaveBuffer(wave);
+         if (!synthesize(sinsy, labelFlag ? &label : NULL, condition)) {
+            return writeString(fd, "ERR failed to synthesize\n");
+         }
+         return writeString(fd, oss.str()) && writeChunk(fd, wave.empty() ? NULL : &wave[0], wave.size()) && writeString(fd, "END\n");
+      }
+
+      // raw PCM is sent phrase by phrase
+      if (!writeString(fd, oss.str())) {
+         return false;
+      }
+      PcmOutput output(fd);
+      condition.setWaveformOutput(output);
+      const bool result(synthesize(sinsy, labelFlag ? &label : NULL, condition));
+      if (output.isFailed()) {
+         return false;
+      }
+      return writeString(fd, result ? "END\n" : "ERR failed to synthesize\n");
+   }
+
+   //! synthesize from labels if given, otherwise from loaded score
+   static bool synthesize(sinsy::Sinsy& sinsy, const sinsy::LabelStrings* label, sinsy::SynthCondition& condition) {
+      if (NULL != label) {
+         return sinsy.synthesizeFromLabel(*label, condition);
+      }
+      return sinsy.synthesize(condition);
+   }
+
+   //! queue of requests
+   RequestQueue& queue;
+
+   //! queue of connections returned to main loop
+   ReturnQueue& returnQueue;
+
+   //! settings
+   const DaemonSetting& setting;
+};
+};
+
+void usage()
+{
+   std::cout << "The HMM-Based Singing Voice Syntheis System \"Sinsy\"" << std::endl;
+   std::cout << "Version 0.92 (http://sinsy.sourceforge.net/)" << std::endl;
+   std::cout << "Copyright (C) 2009-2015 Nagoya Institute of Technology" << std::endl;
+   std::cout << "All rights reserved." << std::endl;
+   std::cout << "" << std::endl;
+   std::cout << "sinsyd - synthesis daemon of \"Sinsy\"" << std::endl;
+   std::cout << "" << std::endl;
+   std::cout << "  usage:" << std::endl;
+   std::cout << "    sinsyd [ options ] -s socket" << std::endl;
+   std::cout << "  options:                                           [def]" << std::endl;
+   std::cout << "    -w langs    : languages                          [  j]" << std::endl;
+   std::cout << "    -x dir      : dictionary directory               [N/A]" << std::endl;
+   std::cout << "    -m htsvoice : HTS voice file                     [N/A]" << std::endl;
+   std::cout << "    -s socket   : path of Unix domain socket         [N/A]" << std::endl;
+   std::cout << "    -n num      : number of workers                  [  1]" << std::endl;
+   std::cout << "    -j num      : number of threads for each request [  1]" << std::endl;
+   std::cout << "    -p          : synthesize phrase by phrase        [N/A]" << std::endl;
+   std::cout << "  request:" << std::endl;
+   std::cout << "    \"<type> <format> <size>\\n\" followed by <size> bytes of data" << std::endl;
+   std::cout << "    type   : xml (MusicXML) or label (full-context labels, one per line)" << std::endl;
+   std::cout << "    format : wav (one chunk of RIFF data) or pcm (16bit raw PCM chunks of phrases)" << std::endl;
+   std::cout << "  response:" << std::endl;
+   std::cout << "    \"OK <sampling frequency>\\n\", chunks (\"<size>\\n\" and data) and \"END\\n\"" << std::endl;
+   std::cout << "    or \"ERR <message>\\n\" (pcm: ERR may follow some chunks)" << std::endl;
+   std::cout << "    several requests can be sent on one connection one after another;" << std::endl;
+   std::cout << "    after ERR of a malformed request header, the connection is closed" << std::endl;
+   std::cout << "    connections are closed if no data comes for " << IDLE_TIMEOUT << " sec while waiting for request" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+   if (argc < 2) {
+      usage();
+      return -1;
+   }
+
+   std::string voicePath;
+   std::string languageFlags(DEFAULT_LANGS);
+   std::string config;
+   std::string socketPath;
+   DaemonSetting setting;
+   setting.languages = NULL;
+   setting.voice = NULL;
+   setting.threadNum = 1;
+   setting.phraseSplitFlag = false;
+   size_t workerNum(1);
+
+   for (int i(1); i < argc; ++i) {
+      if ('-' != argv[i][0]) {
+         std::cout << "[ERROR] invalid option : " << argv[i] << std::endl;
+         usage();
+         return -1;
+      }
+      if (('\0' != argv[i][1]) && (NULL != strchr("wxmsnj", argv[i][1])) && (argc <= i + 1)) {
+         std::cout << "[ERROR] no argument of option : " << argv[i] << std::endl;
+         usage();
+         return -1;
+      }
+      switch (argv[i][1]) {
+      case 'w' :
+         languageFlags = argv[++i];
+         break;
+      case 'x' :
+         config = argv[++i];
+         break;
+      case 'm' :
+         voicePath = argv[++i];
+         break;
+      case 's' :
+         socketPath = argv[++i];
+         break;
+      case 'n' : {
+         std::istringstream iss(argv[++i]);
+         if (!(iss >> workerNum) || (0 == workerNum)) {
+            std::cout << "[ERROR] invalid number of workers : " << argv[i] << std::endl;
+            return -1;
+         }
+         break;
+      }
+      case 'j' : {
+         std::istringstream iss(argv[++i]);
+         if (!(iss >> setting.threadNum) || (0 == setting.threadNum)) {
+            std::cout << "[ERROR] invalid number of threads : " << argv[i] << std::endl;
+            return -1;
+         }
+         break;
+      }
+      case 'p' :
+         setting.phraseSplitFlag = true;
+         break;
+      case 'h' :
+         usage();
+         return 0;
+      default :
+         std::cout << "[ERROR] invalid option : '-" << argv[i][1] << "'" << std::endl;
+         usage();
+         return -1;
+      }
+   }
+
+   if (voicePath.empty() || socketPath.empty()) {
+      usage();
+      return -1;
+   }
+
+   // dictionaries are read once before clients come, and shared by all workers
+   sinsy::Languages languages;
+   if (!languages.set(languageFlags, config) || !languages.preload()) {
+      std::cout << "[ERROR] failed to set languages : " << languageFlags << ", config dir : " << config << std::endl;
+      return -1;
+   }
+   setting.languages = &languages;
+
+   std::vector<std::string> voices;
+   voices.push_back(voicePath);
+   sinsy::Voice voice;
+   if (!voice.load(voices)) {
+      std::cout << "[ERROR] failed to load voices : " << voicePath << std::endl;
+      return -1;
+   }
+   setting.voice = &voice;
+
+   struct sockaddr_un addr;
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   if (sizeof(addr.sun_path) <= socketPath.size()) {
+      std::cout << "[ERROR] socket path is too long : " << socketPath << std::endl;
+      return -1;
+   }
+   strcpy(addr.sun_path, socketPath.c_str());
+
+   const int listenFd(socket(AF_UNIX, SOCK_STREAM, 0));
+   if (listenFd < 0) {
+      std::cout << "[ERROR] failed to create socket" << std::endl;
+      return -1;
+   }
+   unlink(socketPath.c_str());
+   if ((0 != bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))) || (0 != listen(listenFd, 16))) {
+      std::cout << "[ERROR] failed to listen : " << socketPath << std::endl;
+      ::close(listenFd);
+      return -1;
+   }
+
+   struct sigaction action;
+   memset(&action, 0, sizeof(action));
+   action.sa_handler = handleSignal;
+   sigemptyset(&action.sa_mask);
+   sigaction(SIGINT, &action, NULL);
+   sigaction(SIGTERM, &action, NULL);
+   signal(SIGPIPE, SIG_IGN);
+
+   RequestQueue queue(workerNum * PENDING_REQUESTS_PER_WORKER);
+   ReturnQueue returnQueue;
+   std::vector<DaemonWorker*> workers;
+   std::vector<sinsy::ToolThread*> threads;
+   if (returnQueue.open()) {
+      for (size_t i(0); i < workerNum; ++i) {
+         workers.push_back(new DaemonWorker(queue, returnQueue, setting));
+         sinsy::ToolThread* thread(new sinsy::ToolThread(*workers.back()));
+         if (!thread->start()) {
+            delete thread;
+            break;
+         }
+         threads.push_back(thread);
+      }
+   }
+
+   int result(0);
+   if (threads.empty()) {
+      std::cout << "[ERROR] failed to start workers" << std::endl;
+      result = -1;
+   } else {
+      std::cout << "[INFO] listening on " << socketPath << " with " << threads.size() << " workers" << std::endl;
+   }
+
+   // requests are received here, and only complete requests are passed to workers
+   std::vector<Connection*> connections;
+   std::vector<struct pollfd> fds;
+   while (!threads.empty() && !stopFlag) {
+      fds.resize(2 + connections.size());
+      fds[0].fd = listenFd;
+      fds[1].fd = returnQueue.getFd();
+      for (size_t i(0); i < connections.size(); ++i) {
+         fds[2 + i].fd = connections[i]->fd;
+      }
+      for (size_t i(0); i < fds.size(); ++i) {
+         fds[i].events = POLLIN;
+         fds[i].revents = 0;
+      }
+      if (poll(&fds[0], fds.size(), POLL_INTERVAL) < 0) {
+         if (EINTR == errno) {
+            continue;
+         }
+         std::cout << "[ERROR] failed to poll" << std::endl;
+         result = -1;
+         break;
+      }
+      const time_t now(time(NULL));
+
+      std::vector<Connection*> waiting;
+      for (size_t i(0); i < connections.size(); ++i) {
+         Connection* connection(connections[i]);
+         if (0 != fds[2 + i].revents) {
+            if (!receive(*connection)) {
+               closeConnection(connection);
+               continue;
+            }
+            connection->lastTime = now;
+            dispatch(connection, queue, waiting);
+         } else if (IDLE_TIMEOUT <= now - connection->lastTime) {
+            closeConnection(connection);
+         } else {
+            waiting.push_back(connection);
+         }
+      }
+
+      // connections come back after response (next request may be received already)
+      if (0 != fds[1].revents) {
+         std::vector<Connection*> returned;
+         returnQueue.take(returned);
+         for (size_t i(0); i < returned.size(); ++i) {
+            returned[i]->lastTime = now;
+            dispatch(returned[i], queue, waiting);
+         }
+      }
+
+      if (0 != (fds[0].revents & POLLIN)) {
+         const int fd(accept(listenFd, NULL, NULL));
+         if (fd < 0) {
+            if ((EINTR != errno) && (ECONNABORTED != errno)) {
+               std::cout << "[ERROR] failed to accept" << std::endl;
+               result = -1;
+               connections.swap(waiting);
+               break;
+            }
+         } else if (MAX_IDLE_CLIENTS <= waiting.size()) {
+            writeReply(fd, "ERR server is busy\n");
+            ::close(fd);
+         } else {
+            // client which does not read response cannot keep worker
+            struct timeval timeout;
+            timeout.tv_sec = SEND_TIMEOUT;
+            timeout.tv_usec = 0;
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            Connection* connection(new Connection);
+            connection->fd = fd;
+            connection->lastTime = now;
+            waiting.push_back(connection);
+         }
+      }
+      connections.swap(waiting);
+   }
+
+   queue.close();
+   for (size_t i(0); i < threads.size(); ++i) {
+      delete threads[i];
+   }
+   for (size_t i(0); i < workers.size(); ++i) {
+      delete workers[i];
+   }
+   for (size_t i(0); i < connections.size(); ++i) {
+      closeConnection(connections[i]);
+   }
+   ::close(listenFd);
+   unlink(socketPath.c_str());
+
+   return result;
+}
+
+#endif // _WIN32
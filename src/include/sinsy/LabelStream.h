@@ -43,7 +43,7 @@
 #define SINSY_LABEL_STREAM_H_
 
 #include <string>
-#include <fstream>
+#include <ostream>
 #include "ILabelOutput.h"
 
 namespace sinsy
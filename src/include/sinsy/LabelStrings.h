@@ -61,7 +61,8 @@ public:
    //! get size
    size_t size() const;
 
-   //! get data
+   //! get data (read only: labels can be read by several threads at once)
+   //! strings of labels are valid until destruction, but the returned array is invalidated by output()
    const char* const* getData() const;
 
    //! output label
@@ -74,10 +75,17 @@ private:
    //! assignment operator (donot use)
    LabelStrings& operator=(const LabelStrings&);
 
-   typedef std::vector<char*> StringList;
+   //! blocks of labels (each label is terminated by '\0' and never moved)
+   std::vector<char*> blocks;
 
-   //! list of strings
-   StringList stringList;
+   //! unused part of last block
+   char* rest;
+
+   //! size of unused part of last block
+   size_t restSize;
+
+   //! pointers to labels
+   std::vector<const char*> pointers;
 };
 
 };
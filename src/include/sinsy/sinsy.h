@@ -48,6 +48,8 @@
 #include <vector>
 
 #include "LabelStrings.h"
+#include "LabelStream.h"
+#include "IWaveformOutput.h"
 
 namespace sinsy
 {
@@ -98,6 +100,10 @@ const ClefType CLEFTYPE_C = 3;
 
 
 class SynthConditionImpl;
+class VoiceImpl;
+class LanguagesImpl;
+class SynthSessionImpl;
+class SynthCacheImpl;
 class SinsyImpl;
 
 class IScore
@@ -152,12 +158,45 @@ public:
    //! unset file path to save RIFF format file
    void unsetSaveFilePath();
 
+   //! set buffer to save RIFF format data (contents of buffer are replaced)
+   void setSaveBuffer(std::vector<char>& data);
+
+   //! unset buffer to save RIFF format data
+   void unsetSaveBuffer();
+
    //! set waveform buffer
    void setWaveformBuffer(std::vector<double>& waveform);
 
+   //! set waveform buffer (float)
+   void setWaveformBuffer(std::vector<float>& waveform);
+
+   //! set waveform buffer (16bit integer, clipped)
+   void setWaveformBuffer(std::vector<short>& waveform);
+
+   //! set waveform buffer owned by user: at most capacity samples are stored and number of stored samples is set to size
+   void setWaveformBuffer(double* waveform, size_t capacity, size_t& size);
+
+   //! set waveform buffer owned by user (float)
+   void setWaveformBuffer(float* waveform, size_t capacity, size_t& size);
+
+   //! set waveform buffer owned by user (16bit integer, clipped)
+   void setWaveformBuffer(short* waveform, size_t capacity, size_t& size);
+
    //! unset waveform buffer
    void unsetWaveformBuffer();
 
+   //! set phrase split flag: score is split at rests between phrases and synthesized phrase by phrase
+   void setPhraseSplitFlag();
+
+   //! unset phrase split flag
+   void unsetPhraseSplitFlag();
+
+   //! set waveform output: waveform is output phrase by phrase while synthesizing
+   void setWaveformOutput(IWaveformOutput& output);
+
+   //! unset waveform output
+   void unsetWaveformOutput();
+
 
 private:
    //! copy constructor (donot use)
@@ -172,6 +211,136 @@ private:
    friend class Sinsy;
 };
 
+class SynthSession
+{
+public:
+   //! constructor
+   SynthSession();
+
+   //! destructor
+   virtual ~SynthSession();
+
+   //! clear waveforms of phrases kept in session
+   void clear();
+
+   //! set exact flag: song-wide label fields are also compared, so phrases are reused only if their waveforms are same as synthesized again
+   void setExactFlag();
+
+   //! unset exact flag (default)
+   void unsetExactFlag();
+
+   //! get number of phrases not reused from session by last synthesis (synthesized or found in cache)
+   size_t getSynthesizedPhraseNum() const;
+
+   //! get number of phrases reused by last synthesis
+   size_t getReusedPhraseNum() const;
+
+private:
+   //! copy constructor (donot use)
+   SynthSession(const SynthSession&);
+
+   //! assignment operator (donot use)
+   SynthSession& operator=(const SynthSession&);
+
+   //! implementation
+   SynthSessionImpl* impl;
+
+   friend class Sinsy;
+};
+
+class SynthCache
+{
+public:
+   //! constructor
+   SynthCache();
+
+   //! destructor
+   virtual ~SynthCache();
+
+   //! set max size of waveforms kept in memory in bytes (default: 64MB)
+   void setMaxMemorySize(size_t size);
+
+   //! set directory to spill waveforms evicted from memory and max size of spilled files in bytes
+   void setSpillDirectory(const std::string& dir, size_t maxSize);
+
+   //! unset spill directory (spilled files are not removed)
+   void unsetSpillDirectory();
+
+   //! clear waveforms kept in memory
+   void clear();
+
+private:
+   //! copy constructor (donot use)
+   SynthCache(const SynthCache&);
+
+   //! assignment operator (donot use)
+   SynthCache& operator=(const SynthCache&);
+
+   //! implementation
+   SynthCacheImpl* impl;
+
+   friend class Sinsy;
+};
+
+class Voice
+{
+public:
+   //! constructor
+   Voice();
+
+   //! destructor (voices are kept while they are attached to Sinsy objects)
+   virtual ~Voice();
+
+   //! load voice files (voices attached to Sinsy objects before are not changed)
+   bool load(const std::vector<std::string>& voices);
+
+   //! loaded or not
+   bool isLoaded() const;
+
+private:
+   //! copy constructor (donot use)
+   Voice(const Voice&);
+
+   //! assignment operator (donot use)
+   Voice& operator=(const Voice&);
+
+   //! implementation
+   VoiceImpl* impl;
+
+   friend class Sinsy;
+};
+
+class Languages
+{
+public:
+   //! constructor
+   Languages();
+
+   //! destructor (dictionaries are kept while they are set to Sinsy objects)
+   virtual ~Languages();
+
+   //! set languages (languages set to Sinsy objects before are not changed)
+   bool set(const std::string& languages, const std::string& configs);
+
+   //! read dictionaries of languages now instead of on first use
+   bool preload();
+
+   //! set or not
+   bool isSet() const;
+
+private:
+   //! copy constructor (donot use)
+   Languages(const Languages&);
+
+   //! assignment operator (donot use)
+   Languages& operator=(const Languages&);
+
+   //! implementation
+   LanguagesImpl* impl;
+
+   friend class Sinsy;
+};
+
 class Sinsy
 {
 public:
@@ -184,9 +353,21 @@ public:
    //! set languages
    bool setLanguages(const std::string& languages, const std::string& configs);
 
+   //! set languages set up by Languages object: dictionaries are shared read-only, not copied
+   bool setLanguages(const Languages& languages);
+
+   //! read dictionaries of languages now instead of on first use (for servers that need constant latency)
+   bool preloadLanguages();
+
+   //! compile dictionary files in directory into one dictionary image (used by setLanguages if it is in the directory)
+   static bool compileDictionary(const std::string& dirPath, const std::string& imagePath);
+
    //! load voice files
    bool loadVoices(const std::vector<std::string>& voices);
 
+   //! attach voices loaded by Voice object: voices are shared read-only, not copied
+   bool attachVoice(const Voice& voice);
+
    //! set encoding
    virtual bool setEncoding(const std::string& encoding);
 
@@ -223,13 +404,34 @@ public:
    //! set interpolation weight for synthesis
    bool setInterpolationWeight(size_t index, double weight);
 
+   //! set cache of waveforms of phrases: phrases are synthesized separately and reused (cache can be shared and has to live longer than this)
+   bool setSynthCache(SynthCache& cache);
+
+   //! unset cache of waveforms of phrases
+   bool unsetSynthCache();
+
+   //! set number of threads for label generation and phrase split synthesis (default: 1)
+   bool setThreadNum(size_t num);
+
    LabelStrings* createLabelData(bool monophoneFlag, int overwriteEnableFlag, int timeFlag);
 
+   //! output labels one by one as they are made (voices are not needed)
+   bool outputLabel(ILabelOutput& output, bool monophoneFlag, int overwriteEnableFlag, int timeFlag);
+
    //! synthesize
    bool synthesize(SynthCondition& consition);
 
    bool synthesize(SynthCondition* consition);
 
+   //! synthesize phrase by phrase: only phrases edited since last synthesis with session (and their neighbours) are synthesized, and the others are reused even if song-wide label fields are changed unless exact flag of session is set (session is not used if waveform is played)
+   bool synthesize(SynthCondition& condition, SynthSession& session);
+
+   //! synthesize from full-context labels without score (times in labels are used for alignment if timeFlag is true)
+   bool synthesizeFromLabel(const LabelStrings& label, SynthCondition& condition, bool timeFlag = true);
+
+   //! synthesize from full-context label file without score (times in labels are used for alignment if timeFlag is true)
+   bool synthesizeFromLabelFile(const std::string& filePath, SynthCondition& condition, bool timeFlag = true);
+
    //! stop synthesizing
    bool stop();
 
@@ -242,9 +444,18 @@ public:
    //! load score from MusicXML
    bool loadScoreFromMusicXML(const std::string& xml);
 
+   //! load score from MusicXML data in memory
+   bool loadScoreFromMusicXMLData(const char* data, size_t size);
+
    //! save score to MusicXML
    bool saveScoreToMusicXML(const std::string& xml, ClefType clefType = CLEFTYPE_DEFAULT);
 
+   //! load score from binary score file (saved by saveScoreBinary)
+   bool loadScoreBinary(const std::string& path);
+
+   //! save score to binary score file: it is loaded much faster than MusicXML
+   bool saveScoreBinary(const std::string& path);
+
    size_t get_sampling_frequency();
 
 private:
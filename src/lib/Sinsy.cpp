@@ -39,24 +39,38 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
+#include <algorithm>
 #include <fstream>
+#include <set>
 #include "sinsy.h"
 #include "util_log.h"
 #include "Converter.h"
+#include "ConfManager.h"
+#include "LanguagesImpl.h"
 #include "TempScore.h"
 #include "XmlReader.h"
 #include "XmlWriter.h"
+#include "ScoreBinaryReader.h"
+#include "ScoreBinaryWriter.h"
 #include "InputFile.h"
+#include "InputBuffer.h"
+#include "MappedFile.h"
 #include "OutputFile.h"
+#include "WaveFile.h"
 #include "WritableStrStream.h"
 #include "LabelStream.h"
 #include "LabelStrings.h"
 #include "LabelMaker.h"
 #include "HtsEngine.h"
+#include "HtsEnginePool.h"
+#include "VoiceImpl.h"
 #include "SynthConditionImpl.h"
+#include "SynthSessionImpl.h"
+#include "SynthCacheImpl.h"
 #include "ScorePosition.h"
 #include "ScoreDoctor.h"
 #include "util_score.h"
+#include "Deleter.h"
 
 namespace sinsy
 {
@@ -65,6 +79,230 @@ namespace
 {
 const std::string DEFAULT_LANGUAGES = "j";
 
+class SegmentOutput : public IWaveformOutput
+{
+public:
+   //! constructor
+   SegmentOutput(IWaveformOutput* o, WaveformBuffer* b, WaveFile& f, WaveFile& d) : waveformOutput(o), waveformBuffer(b), waveFile(f), waveData(d), failed(false) {}
+
+   //! destructor
+   virtual ~SegmentOutput() {}
+
+   //! output waveform of segment
+   virtual void output(const double* waveform, size_t size) {
+      if (0 == size) {
+         return;
+      }
+      if (NULL != waveformOutput) {
+         waveformOutput->output(waveform, size);
+      }
+      if ((NULL != waveformBuffer) && !waveformBuffer->append(waveform, size)) {
+         if (!failed) {
+            WARN_MSG("Waveform buffer is too small");
+         }
+         failed = true;
+      }
+      if (waveFile.isValid() && !waveFile.write(waveform, size)) {
+         failed = true;
+      }
+      if (waveData.isValid() && !waveData.write(waveform, size)) {
+         failed = true;
+      }
+   }
+
+   //! failed or not
+   bool isFailed() const {
+      return failed;
+   }
+
+private:
+   //! copy constructor (donot use)
+   SegmentOutput(const SegmentOutput&);
+
+   //! assignment operator (donot use)
+   SegmentOutput& operator=(const SegmentOutput&);
+
+   //! output given by user
+   IWaveformOutput* waveformOutput;
+
+   //! waveform buffer given by user
+   WaveformBuffer* waveformBuffer;
+
+   //! RIFF format file
+   WaveFile& waveFile;
+
+   //! RIFF format data in memory
+   WaveFile& waveData;
+
+   //! failed or not
+   bool failed;
+};
+
+class PhraseOutput : public IWaveformOutput
+{
+public:
+   //! constructor
+   PhraseOutput(IWaveformOutput& o, SynthSessionImpl* s, SynthCacheImpl* c, const std::vector<std::string>& k, const std::vector<std::string>& sk,
+                const std::string& ck, std::vector<const std::vector<double>*>& w, std::vector<std::vector<double>*>& ow, const std::vector<size_t>& i,
+                const std::vector<bool>& d)
+      : segmentOutput(o), session(s), cache(c), keys(k), sessionKeys(sk), conditionKey(ck), waveforms(w), ownedWaveforms(ow), indexes(i),
+        duplicated(d), synthesizedNum(0), outputNum(0) {}
+
+   //! destructor
+   virtual ~PhraseOutput() {}
+
+   //! store waveform of synthesized segment and output waveforms in order
+   virtual void output(const double* waveform, size_t size) {
+      if (synthesizedNum < indexes.size()) {
+         const size_t idx(indexes[synthesizedNum]);
+         if (NULL != cache) {
+            cache->store(keys[idx] + conditionKey, waveform, size);
+         }
+         if (NULL != session) {
+            waveforms[idx] = session->store(sessionKeys[idx], waveform, size);
+         } else {
+            ownedWaveforms[idx] = new std::vector<double>(waveform, waveform + size);
+            waveforms[idx] = ownedWaveforms[idx];
+         }
+         ++synthesizedNum;
+      }
+      flush();
+   }
+
+   //! output waveforms which are ready
+   void flush() {
+      while (outputNum < waveforms.size()) {
+         if ((NULL == waveforms[outputNum]) && duplicated[outputNum]) {
+            // same key as preceding segment: found in session after the segment is stored
+            waveforms[outputNum] = session->find(sessionKeys[outputNum]);
+         }
+         if (NULL == waveforms[outputNum]) {
+            break;
+         }
+         const std::vector<double>& waveform(*waveforms[outputNum]);
+         if (!waveform.empty()) {
+            segmentOutput.output(&waveform[0], waveform.size());
+         }
+         delete ownedWaveforms[outputNum];
+         ownedWaveforms[outputNum] = NULL;
+         ++outputNum;
+      }
+   }
+
+   //! all segments are output or not
+   bool isCompleted() const {
+      return outputNum == waveforms.size();
+   }
+
+private:
+   //! copy constructor (donot use)
+   PhraseOutput(const PhraseOutput&);
+
+   //! assignment operator (donot use)
+   PhraseOutput& operator=(const PhraseOutput&);
+
+   //! output of segments
+   IWaveformOutput& segmentOutput;
+
+   //! session (NULL if not used)
+   SynthSessionImpl* session;
+
+   //! cache (NULL if not used)
+   SynthCacheImpl* cache;
+
+   //! labels of segments
+   const std::vector<std::string>& keys;
+
+   //! keys of segments in session
+   const std::vector<std::string>& sessionKeys;
+
+   //! key of voices and conditions of engine
+   const std::string& conditionKey;
+
+   //! waveforms of segments (NULL if not synthesized yet)
+   std::vector<const std::vector<double>*>& waveforms;
+
+   //! waveforms owned by this (not kept in session)
+   std::vector<std::vector<double>*>& ownedWaveforms;
+
+   //! indexes of segments to be synthesized
+   const std::vector<size_t>& indexes;
+
+   //! segments which have same key in session as preceding segment to be synthesized
+   const std::vector<bool>& duplicated;
+
+   //! number of synthesized segments
+   size_t synthesizedNum;
+
+   //! number of output segments
+   size_t outputNum;
+};
+
+/*!
+ @internal
+
+ join label strings into one string
+ */
+void joinLabel(const LabelStrings& label, std::string& str)
+{
+   const char* const* data(label.getData());
+   const size_t size(label.size());
+   str.clear();
+   for (size_t i(0); i < size; ++i) {
+      str.append(data[i]);
+      str.push_back('\n');
+   }
+}
+
+/*!
+ @internal
+
+ copy labels without times (durations are predicted by voices instead)
+ */
+void removeLabelTime(const LabelStrings& src, LabelStrings& dst)
+{
+   const char* const* data(src.getData());
+   const size_t size(src.size());
+   for (size_t i(0); i < size; ++i) {
+      // "start end label" or "label" (label has no space)
+      const char* label(data[i]);
+      for (const char* c(data[i]); '\0' != *c; ++c) {
+         if ((' ' == *c) || ('\t' == *c)) {
+            label = c + 1;
+         }
+      }
+      dst.output(label);
+   }
+}
+
+/*!
+ @internal
+
+ read label file
+ */
+bool readLabelFile(const std::string& filePath, LabelStrings& label)
+{
+   std::ifstream ifs(filePath.c_str());
+   if (!ifs) {
+      ERR_MSG("Cannot open label file : " << filePath);
+      return false;
+   }
+   std::string line;
+   while (std::getline(ifs, line)) {
+      const std::string::size_type end(line.find_last_not_of(" \t\r"));
+      if (std::string::npos == end) {
+         continue; // empty line
+      }
+      line.erase(end + 1);
+      label.output(line);
+   }
+   if (ifs.bad()) {
+      ERR_MSG("Cannot read label file : " << filePath);
+      return false;
+   }
+   return true;
+}
+
 class ScoreConverter : public IScoreWritable
 {
 public:
@@ -326,6 +564,218 @@ void ScoreConverter::addNote(const Note& note)
 
 };
 
+/*!
+ constructor
+ */
+SynthSession::SynthSession() : impl(NULL)
+{
+   this->impl = new SynthSessionImpl();
+}
+
+/*!
+ destructor
+ */
+SynthSession::~SynthSession()
+{
+   delete this->impl;
+}
+
+/*!
+ clear waveforms of phrases
+ */
+void SynthSession::clear()
+{
+   this->impl->clear();
+}
+
+/*!
+ set exact flag
+ */
+void SynthSession::setExactFlag()
+{
+   this->impl->setExactFlag(true);
+}
+
+/*!
+ unset exact flag
+ */
+void SynthSession::unsetExactFlag()
+{
+   this->impl->setExactFlag(false);
+}
+
+/*!
+ get number of phrases synthesized by last synthesis
+ */
+size_t SynthSession::getSynthesizedPhraseNum() const
+{
+   return this->impl->getSynthesizedPhraseNum();
+}
+
+/*!
+ get number of phrases reused by last synthesis
+ */
+size_t SynthSession::getReusedPhraseNum() const
+{
+   return this->impl->getReusedPhraseNum();
+}
+
+/*!
+ constructor
+ */
+SynthCache::SynthCache() : impl(NULL)
+{
+   this->impl = new SynthCacheImpl();
+}
+
+/*!
+ destructor
+ */
+SynthCache::~SynthCache()
+{
+   delete this->impl;
+}
+
+/*!
+ set max size of waveforms kept in memory
+ */
+void SynthCache::setMaxMemorySize(size_t size)
+{
+   this->impl->setMaxMemorySize(size);
+}
+
+/*!
+ set spill directory
+ */
+void SynthCache::setSpillDirectory(const std::string& dir, size_t maxSize)
+{
+   this->impl->setSpillDirectory(dir, maxSize);
+}
+
+/*!
+ unset spill directory
+ */
+void SynthCache::unsetSpillDirectory()
+{
+   this->impl->unsetSpillDirectory();
+}
+
+/*!
+ clear waveforms kept in memory
+ */
+void SynthCache::clear()
+{
+   this->impl->clear();
+}
+
+/*!
+ constructor
+ */
+Voice::Voice() : impl(NULL)
+{
+   this->impl = new VoiceImpl();
+}
+
+/*!
+ destructor
+ */
+Voice::~Voice()
+{
+   this->impl->release();
+}
+
+/*!
+ load voices
+ */
+bool Voice::load(const std::vector<std::string>& voices)
+{
+   try {
+      // voices attached to Sinsy objects are immutable: load into new implementation
+      VoiceImpl* newImpl(new VoiceImpl());
+      if (!newImpl->load(voices)) {
+         newImpl->release();
+         return false;
+      }
+      this->impl->release();
+      this->impl = newImpl;
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ loaded or not
+ */
+bool Voice::isLoaded() const
+{
+   return this->impl->isLoaded();
+}
+
+/*!
+ constructor
+ */
+Languages::Languages() : impl(NULL)
+{
+   this->impl = new LanguagesImpl();
+}
+
+/*!
+ destructor
+ */
+Languages::~Languages()
+{
+   this->impl->release();
+}
+
+/*!
+ set languages
+ */
+bool Languages::set(const std::string& languages, const std::string& dirPath)
+{
+   try {
+      // languages set to Sinsy objects are immutable: set up new implementation
+      LanguagesImpl* newImpl(new LanguagesImpl());
+      if (!newImpl->set(languages, dirPath)) {
+         newImpl->release();
+         return false;
+      }
+      this->impl->release();
+      this->impl = newImpl;
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME(languages << ", " << dirPath) << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ read dictionaries of languages now
+
+ Dictionaries are loaded safely even if Sinsy objects sharing them are converting lyrics.
+ */
+bool Languages::preload()
+{
+   try {
+      if (!this->impl->preload()) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ set or not
+ */
+bool Languages::isSet() const
+{
+   return this->impl->isSet();
+}
+
 /*!
  constructor
  */
@@ -374,6 +824,22 @@ void SynthCondition::unsetSaveFilePath()
    this->impl->unsetSaveFilePath();
 }
 
+/*!
+ set save buffer
+ */
+void SynthCondition::setSaveBuffer(std::vector<char>& data)
+{
+   this->impl->setSaveBuffer(data);
+}
+
+/*!
+ unset save buffer
+ */
+void SynthCondition::unsetSaveBuffer()
+{
+   this->impl->unsetSaveBuffer();
+}
+
 /*!
  set waveform buffer
  */
@@ -382,6 +848,46 @@ void SynthCondition::setWaveformBuffer(std::vector<double>& waveform)
    this->impl->setWaveformBuffer(waveform);
 }
 
+/*!
+ set waveform buffer (float)
+ */
+void SynthCondition::setWaveformBuffer(std::vector<float>& waveform)
+{
+   this->impl->setWaveformBuffer(waveform);
+}
+
+/*!
+ set waveform buffer (16bit integer)
+ */
+void SynthCondition::setWaveformBuffer(std::vector<short>& waveform)
+{
+   this->impl->setWaveformBuffer(waveform);
+}
+
+/*!
+ set waveform buffer (owned by user)
+ */
+void SynthCondition::setWaveformBuffer(double* waveform, size_t capacity, size_t& size)
+{
+   this->impl->setWaveformBuffer(waveform, capacity, size);
+}
+
+/*!
+ set waveform buffer (float, owned by user)
+ */
+void SynthCondition::setWaveformBuffer(float* waveform, size_t capacity, size_t& size)
+{
+   this->impl->setWaveformBuffer(waveform, capacity, size);
+}
+
+/*!
+ set waveform buffer (16bit integer, owned by user)
+ */
+void SynthCondition::setWaveformBuffer(short* waveform, size_t capacity, size_t& size)
+{
+   this->impl->setWaveformBuffer(waveform, capacity, size);
+}
+
 /*!
  unset waveform buffer
  */
@@ -390,24 +896,105 @@ void SynthCondition::unsetWaveformBuffer()
    this->impl->unsetWaveformBuffer();
 }
 
+/*!
+ set phrase split flag
+ */
+void SynthCondition::setPhraseSplitFlag()
+{
+   this->impl->setPhraseSplitFlag();
+}
+
+/*!
+ unset phrase split flag
+ */
+void SynthCondition::unsetPhraseSplitFlag()
+{
+   this->impl->unsetPhraseSplitFlag();
+}
+
+/*!
+ set waveform output
+ */
+void SynthCondition::setWaveformOutput(IWaveformOutput& output)
+{
+   this->impl->setWaveformOutput(output);
+}
+
+/*!
+ unset waveform output
+ */
+void SynthCondition::unsetWaveformOutput()
+{
+   this->impl->unsetWaveformOutput();
+}
+
 
 class SinsyImpl : public IScoreWriter
 {
 public:
    //! constructor
-   SinsyImpl() {}
+   SinsyImpl() : languages(NULL), pool(engine), voice(NULL), revision(0), cache(NULL), threadNum(1) {
+      languages = new LanguagesImpl();
+   }
 
    //! destructor
-   virtual ~SinsyImpl() {}
+   virtual ~SinsyImpl() {
+      engine.reset();
+      releaseVoice();
+      languages->release();
+   }
 
    //! set languages
    bool setLanguages(const std::string& languages, const std::string& dirPath) {
-      return converter.setLanguages(languages, dirPath);
+      // languages may be shared with other Sinsy objects: set up new one
+      LanguagesImpl* newLanguages(new LanguagesImpl());
+      const bool result(newLanguages->set(languages, dirPath));
+      this->languages->release();
+      this->languages = newLanguages;
+      return result;
+   }
+
+   //! set shared languages
+   bool setLanguages(LanguagesImpl& l) {
+      if (!l.isSet()) {
+         return false;
+      }
+      l.addRef();
+      languages->release();
+      languages = &l;
+      return true;
+   }
+
+   //! read dictionaries of languages now
+   bool preloadLanguages() {
+      return languages->preload();
    }
 
    //! load voice files
    bool loadVoices(const std::vector<std::string>& voices) {
-      return engine.load(voices);
+      ++revision;
+      const bool result(engine.load(voices));
+      releaseVoice();
+      return result;
+   }
+
+   //! attach shared voices
+   bool attachVoice(VoiceImpl& v) {
+      ++revision;
+      if (!v.isLoaded()) {
+         return false;
+      }
+      if (&v == voice) {
+         return true;
+      }
+      if (!engine.share(v.getEngine())) {
+         releaseVoice();
+         return false;
+      }
+      v.addRef();
+      releaseVoice();
+      voice = &v;
+      return true;
    }
 
    //! set encoding
@@ -467,44 +1054,312 @@ public:
 
    //! set alpha for synthesis
    bool setAlpha(double alpha) {
+      ++revision;
       return engine.setAlpha(alpha);
    }
 
    //! set volume for synthesis
    bool setVolume(double volume) {
+      ++revision;
       return engine.setVolume(volume);
    }
 
    //! set interpolation weight for synthesis
    bool setInterpolationWeight(size_t index, double weight) {
+      ++revision;
       return engine.setInterpolationWeight(index, weight);
    }
 
+   //! set cache of waveforms of phrases
+   void setSynthCache(SynthCacheImpl* c) {
+      cache = c;
+   }
+
+   //! set number of threads
+   bool setThreadNum(size_t num) {
+      if (0 == num) {
+         return false;
+      }
+      threadNum = num;
+      return true;
+   }
+
    LabelStrings* createLabelData(bool monophoneFlag, int overwriteEnableFlag, int timeFlag) {
-      LabelMaker labelMaker(converter);
+      LabelMaker labelMaker(languages->getConverter());
       labelMaker << score;
       labelMaker.fix();
       LabelStrings *label = new LabelStrings;
-      labelMaker.outputLabel(*label, monophoneFlag, overwriteEnableFlag, timeFlag);
+      labelMaker.outputLabel(*label, monophoneFlag, overwriteEnableFlag, timeFlag, threadNum);
 
       return label;
    }
 
+   //! output labels
+   bool outputLabel(ILabelOutput& output, bool monophoneFlag, int overwriteEnableFlag, int timeFlag) {
+      LabelMaker labelMaker(languages->getConverter());
+      labelMaker << score;
+      labelMaker.fix();
+      labelMaker.outputLabel(output, monophoneFlag, overwriteEnableFlag, timeFlag, threadNum);
+      return true;
+   }
+
    //! synthesize
-   bool synthesize(SynthConditionImpl& condition) {
-      LabelMaker labelMaker(converter);
+   bool synthesize(SynthConditionImpl& condition, SynthSessionImpl* session = NULL) {
+      LabelMaker labelMaker(languages->getConverter());
       labelMaker << score;
       labelMaker.fix();
+
+      if (NULL != session) {
+         session->resetPhraseNum();
+         return synthesizeSegments(labelMaker, condition, session);
+      }
+      if (condition.phraseSplitFlag || (NULL != condition.waveformOutput) || (NULL != cache)) {
+         return synthesizeSegments(labelMaker, condition);
+      }
+
       LabelStrings label;
 
-      labelMaker.outputLabel(label, false, 1, 2);
+      labelMaker.outputLabel(label, false, 1, 2, threadNum);
 
       return engine.synthesize(label, condition);
    }
 
+   //! synthesize from labels
+   bool synthesizeFromLabel(const LabelStrings& label, SynthConditionImpl& condition, bool timeFlag) {
+      if (0 == label.size()) {
+         ERR_MSG("Label is empty");
+         return false;
+      }
+      if (!timeFlag) {
+         LabelStrings labelWithoutTime;
+         removeLabelTime(label, labelWithoutTime);
+         return synthesizeFromLabel(labelWithoutTime, condition, true);
+      }
+
+      engine.resetStopFlag();
+      if (NULL == condition.waveformOutput) {
+         return engine.synthesize(label, condition);
+      }
+
+      // waveform output is given whole waveform at once
+      const bool saveFlag(!condition.saveFilePath.empty());
+      const bool storeFlag(condition.waveformBuffer.isValid());
+      WaveFile waveFile;
+      if (saveFlag) {
+         if (!waveFile.open(condition.saveFilePath, engine.get_sampling_frequency())) {
+            return false;
+         }
+      }
+      WaveFile waveData;
+      if (NULL != condition.saveBuffer) {
+         waveData.open(*condition.saveBuffer, engine.get_sampling_frequency());
+      }
+      if (storeFlag) {
+         condition.waveformBuffer.clear();
+      }
+      SegmentOutput segmentOutput(condition.waveformOutput, storeFlag ? &condition.waveformBuffer : NULL, waveFile, waveData);
+
+      std::vector<double> waveform;
+      SynthConditionImpl labelCondition;
+      if (condition.playFlag) {
+         labelCondition.setPlayFlag();
+      }
+      labelCondition.setWaveformBuffer(waveform);
+      if (!engine.synthesize(label, labelCondition)) {
+         return false;
+      }
+      if (!waveform.empty()) {
+         segmentOutput.output(&waveform[0], waveform.size());
+      }
+      return !segmentOutput.isFailed();
+   }
+
+   //! synthesize segment by segment and splice waveforms of segments
+   bool synthesizeSegments(const LabelMaker& labelMaker, SynthConditionImpl& condition, SynthSessionImpl* session = NULL) {
+      const bool playFlag(condition.playFlag);
+      const bool saveFlag(!condition.saveFilePath.empty());
+      const bool saveBufferFlag(NULL != condition.saveBuffer);
+      const bool storeFlag(condition.waveformBuffer.isValid());
+      const bool outputFlag(NULL != condition.waveformOutput);
+
+      // nothing to do
+      if (!playFlag && !saveFlag && !saveBufferFlag && !storeFlag && !outputFlag) {
+         return true;
+      }
+
+      WaveFile waveFile;
+      if (saveFlag) {
+         if (!waveFile.open(condition.saveFilePath, engine.get_sampling_frequency())) {
+            return false;
+         }
+      }
+      WaveFile waveData;
+      if (saveBufferFlag) {
+         waveData.open(*condition.saveBuffer, engine.get_sampling_frequency());
+      }
+      if (storeFlag) {
+         condition.waveformBuffer.clear();
+      }
+      SegmentOutput segmentOutput(condition.waveformOutput, storeFlag ? &condition.waveformBuffer : NULL, waveFile, waveData);
+
+      engine.resetStopFlag();
+      const size_t segmentNum(labelMaker.getSegmentNum());
+
+      // waveforms kept in session or cache are reused unless waveform is played
+      if (!playFlag && ((NULL != session) || (NULL != cache))) {
+         return synthesizePhrases(labelMaker, segmentOutput, session) && !segmentOutput.isFailed();
+      }
+
+      // segments are synthesized in parallel unless waveform is played
+      if (!playFlag && (1 < threadNum) && (1 < segmentNum)) {
+         std::vector<LabelStrings*> labels;
+         bool result(false);
+         try {
+            labels.reserve(segmentNum);
+            for (size_t i(0); i < segmentNum; ++i) {
+               labels.push_back(new LabelStrings);
+               labelMaker.outputSegmentLabel(*labels.back(), i, false, 1, 2);
+            }
+            result = pool.synthesize(labels, threadNum, segmentOutput, revision);
+         } catch (...) {
+            std::for_each(labels.begin(), labels.end(), Deleter<LabelStrings>());
+            throw;
+         }
+         std::for_each(labels.begin(), labels.end(), Deleter<LabelStrings>());
+         return result && !segmentOutput.isFailed();
+      }
+
+      std::vector<double> waveform;
+      SynthConditionImpl segmentCondition;
+      if (playFlag) {
+         segmentCondition.setPlayFlag();
+      }
+      if (saveFlag || saveBufferFlag || storeFlag || outputFlag) {
+         segmentCondition.setWaveformBuffer(waveform);
+      }
+      for (size_t i(0); i < segmentNum; ++i) {
+         LabelStrings label;
+         labelMaker.outputSegmentLabel(label, i, false, 1, 2);
+         if (!engine.synthesize(label, segmentCondition)) {
+            return false;
+         }
+         if (engine.isStopped()) {
+            break;
+         }
+         if (!waveform.empty()) {
+            segmentOutput.output(&waveform[0], waveform.size());
+            if (segmentOutput.isFailed()) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+   //! synthesize only segments whose waveforms are not kept in session or cache
+   bool synthesizePhrases(const LabelMaker& labelMaker, IWaveformOutput& output, SynthSessionImpl* session) {
+      if (NULL != session) {
+         session->validate(this, revision);
+      }
+      std::string conditionKey;
+      if (NULL != cache) {
+         engine.appendConditionKey(conditionKey);
+      }
+
+      const size_t segmentNum(labelMaker.getSegmentNum());
+      std::vector<std::string> keys(segmentNum);
+      std::vector<std::string> sessionKeys((NULL != session) ? segmentNum : 0);
+      std::vector<const std::vector<double>*> waveforms(segmentNum, static_cast<const std::vector<double>*>(NULL));
+      std::vector<std::vector<double>*> ownedWaveforms(segmentNum, static_cast<std::vector<double>*>(NULL));
+      std::vector<size_t> indexes;
+      std::vector<bool> duplicated(segmentNum, false);
+      std::set<std::string> synthesizedKeys;
+      std::vector<LabelStrings*> labels;
+      PhraseOutput phraseOutput(output, session, cache, keys, sessionKeys, conditionKey, waveforms, ownedWaveforms, indexes, duplicated);
+      bool result(false);
+      try {
+         for (size_t i(0); i < segmentNum; ++i) {
+            LabelStrings* label(new LabelStrings);
+            labels.push_back(label);
+            labelMaker.outputSegmentLabel(*label, i, false, 1, 2);
+            joinLabel(*label, keys[i]);
+            if (NULL != session) {
+               // phrases are reused unless they or their neighbours are edited
+               labelMaker.makeSegmentKey(sessionKeys[i], i, session->isExact());
+               waveforms[i] = session->find(sessionKeys[i]);
+               if ((NULL == waveforms[i]) && (synthesizedKeys.end() != synthesizedKeys.find(sessionKeys[i]))) {
+                  // same phrase is synthesized only once
+                  duplicated[i] = true;
+                  delete label;
+                  labels.pop_back();
+                  continue;
+               }
+            }
+            if ((NULL == waveforms[i]) && (NULL != cache)) {
+               ownedWaveforms[i] = new std::vector<double>;
+               if (cache->find(keys[i] + conditionKey, *ownedWaveforms[i])) {
+                  waveforms[i] = ownedWaveforms[i];
+                  if (NULL != session) {
+                     const std::vector<double>& waveform(*ownedWaveforms[i]);
+                     waveforms[i] = session->store(sessionKeys[i], waveform.empty() ? NULL : &waveform[0], waveform.size());
+                     delete ownedWaveforms[i];
+                     ownedWaveforms[i] = NULL;
+                  }
+               } else {
+                  delete ownedWaveforms[i];
+                  ownedWaveforms[i] = NULL;
+               }
+            }
+            if (NULL != waveforms[i]) {
+               delete label;
+               labels.pop_back();
+            } else {
+               indexes.push_back(i);
+               if (NULL != session) {
+                  synthesizedKeys.insert(sessionKeys[i]);
+               }
+            }
+         }
+         phraseOutput.flush();
+         result = synthesizeLabels(labels, phraseOutput);
+      } catch (...) {
+         std::for_each(labels.begin(), labels.end(), Deleter<LabelStrings>());
+         std::for_each(ownedWaveforms.begin(), ownedWaveforms.end(), Deleter<std::vector<double> >());
+         throw;
+      }
+      std::for_each(labels.begin(), labels.end(), Deleter<LabelStrings>());
+      std::for_each(ownedWaveforms.begin(), ownedWaveforms.end(), Deleter<std::vector<double> >());
+
+      // waveforms of segments removed from score are not kept
+      if (result && (NULL != session) && phraseOutput.isCompleted()) {
+         session->sweep();
+      }
+      return result;
+   }
+
+   //! synthesize labels and output waveforms in order (one output per label)
+   bool synthesizeLabels(const std::vector<LabelStrings*>& labels, IWaveformOutput& output) {
+      if ((1 < threadNum) && (1 < labels.size())) {
+         return pool.synthesize(labels, threadNum, output, revision);
+      }
+      std::vector<double> waveform;
+      SynthConditionImpl condition;
+      condition.setWaveformBuffer(waveform);
+      for (size_t i(0); i < labels.size(); ++i) {
+         if (!engine.synthesize(*labels[i], condition)) {
+            return false;
+         }
+         if (engine.isStopped()) {
+            break;
+         }
+         output.output(waveform.empty() ? NULL : &waveform[0], waveform.size());
+      }
+      return true;
+   }
+
    //! stop synthesizing
    void stop() {
-      engine.stop();
+      pool.stop();
    }
 
    //! reset stop flag
@@ -518,13 +1373,15 @@ public:
    }
 
    //! load score from MusicXML
-   bool loadScoreFromMusicXML(InputFile& xml) {
+   bool loadScoreFromMusicXML(IReadableStream& xml) {
+      // measures are read into temporary score so that current score is kept if parsing fails halfway
+      TempScore tempScore;
       XmlReader xmlReader;
-      if (!xmlReader.readXml(xml)) {
+      if (!xmlReader.readXml(xml, tempScore)) {
          ERR_MSG("Cannot parse Xml file");
          return false;
       }
-      score << xmlReader;
+      score << tempScore;
       return true;
    }
 
@@ -548,6 +1405,40 @@ public:
       return true;
    }
 
+   //! load score from binary score
+   bool loadScoreBinary(const std::string& path) {
+      MappedFile file;
+      if (!file.open(path)) {
+         ERR_MSG("Cannot open binary score file : " << path);
+         return false;
+      }
+      TempScore tempScore;
+      ScoreBinaryReader reader;
+      if (!reader.readBinary(file.getData(), file.getSize(), tempScore)) {
+         ERR_MSG("Cannot read binary score file : " << path);
+         return false;
+      }
+      score << tempScore;
+      return true;
+   }
+
+   //! save score to binary score
+   bool saveScoreBinary(const std::string& path) {
+      ScoreBinaryWriter writer;
+      writer << score;
+
+      OutputFile outputFile(path);
+      if (!outputFile.isValid()) {
+         ERR_MSG("Cannot open binary score file : " << path);
+         return false;
+      }
+      if (!writer.writeBinary(outputFile)) {
+         ERR_MSG("Cannot write binary score file : " << path);
+         return false;
+      }
+      return true;
+   }
+
    size_t get_sampling_frequency() {
       return engine.get_sampling_frequency();
    }
@@ -559,14 +1450,37 @@ private:
    //! assignment operator (donot use)
    SinsyImpl& operator=(const SinsyImpl&);
 
+   //! release shared voices (engine must not use them any more)
+   void releaseVoice() {
+      if (NULL != voice) {
+         voice->release();
+         voice = NULL;
+      }
+   }
+
    //! score
    ScoreDoctor score;
 
-   //! converter
-   Converter converter;
+   //! languages (shared with Languages and other Sinsy objects, never NULL)
+   LanguagesImpl* languages;
 
    //! hts_engine API
    HtsEngine engine;
+
+   //! engines sharing voices with engine (for parallel synthesis)
+   HtsEnginePool pool;
+
+   //! shared voices attached to engine (NULL if voices are owned by engine)
+   VoiceImpl* voice;
+
+   //! revision of voices and parameters for synthesis (waveforms in sessions are cleared if changed)
+   size_t revision;
+
+   //! cache of waveforms of phrases (NULL if not used)
+   SynthCacheImpl* cache;
+
+   //! number of threads
+   size_t threadNum;
 };
 
 /*!
@@ -606,6 +1520,59 @@ bool Sinsy::setLanguages(const std::string& languages, const std::string& dirPat
    return true;
 }
 
+/*!
+ set shared languages
+
+ Converter and dictionaries are not copied, so Sinsy objects on several threads
+ can share the dictionaries which are set up once.
+ */
+bool Sinsy::setLanguages(const Languages& languages)
+{
+   try {
+      if (!impl->setLanguages(*languages.impl)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ read dictionaries of languages now
+
+ Dictionaries of each encoding are read on first use by default.
+ */
+bool Sinsy::preloadLanguages()
+{
+   try {
+      if (!impl->preloadLanguages()) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ compile dictionary files in directory into one dictionary image
+ */
+bool Sinsy::compileDictionary(const std::string& dirPath, const std::string& imagePath)
+{
+   try {
+      if (!ConfManager::compileDictionary(dirPath, imagePath)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME(dirPath << ", " << imagePath) << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 /*!
  load voices
  */
@@ -622,6 +1589,22 @@ bool Sinsy::loadVoices(const std::vector<std::string>& voices)
    return true;
 }
 
+/*!
+ attach shared voices
+ */
+bool Sinsy::attachVoice(const Voice& voice)
+{
+   try {
+      if (!impl->attachVoice(*voice.impl)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 /*!
  set encoding
  */
@@ -914,10 +1897,52 @@ bool Sinsy::setInterpolationWeight(size_t index, double weight)
    return impl->setInterpolationWeight(index, weight);
 }
 
+/*!
+ set cache of waveforms of phrases
+ */
+bool Sinsy::setSynthCache(SynthCache& cache)
+{
+   impl->setSynthCache(cache.impl);
+   return true;
+}
+
+/*!
+ unset cache of waveforms of phrases
+ */
+bool Sinsy::unsetSynthCache()
+{
+   impl->setSynthCache(NULL);
+   return true;
+}
+
+/*!
+ set number of threads
+ */
+bool Sinsy::setThreadNum(size_t num)
+{
+   return impl->setThreadNum(num);
+}
+
 LabelStrings* Sinsy::createLabelData(bool monophoneFlag, int overwriteEnableFlag, int timeFlag) {
    return impl->createLabelData(monophoneFlag, overwriteEnableFlag, timeFlag);
 }
 
+/*!
+ output labels
+
+ Labels are passed to the output as soon as each one is made,
+ so that a long score does not have to be held as LabelStrings.
+ */
+bool Sinsy::outputLabel(ILabelOutput& output, bool monophoneFlag, int overwriteEnableFlag, int timeFlag)
+{
+   try {
+      return impl->outputLabel(output, monophoneFlag, overwriteEnableFlag, timeFlag);
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+}
+
 /*!
  synthesize
  */
@@ -939,6 +1964,61 @@ bool Sinsy::synthesize(SynthCondition* condition)
    return synthesize(*condition);
 }
 
+/*!
+ synthesize with session
+ */
+bool Sinsy::synthesize(SynthCondition& condition, SynthSession& session)
+{
+   try {
+      if (!impl->synthesize(*condition.impl, session.impl)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ synthesize from full-context labels
+
+ Score is not used: labels made by createLabelData or outputLabel
+ can be synthesized later (or by another process).
+ */
+bool Sinsy::synthesizeFromLabel(const LabelStrings& label, SynthCondition& condition, bool timeFlag)
+{
+   try {
+      if (!impl->synthesizeFromLabel(label, *condition.impl, timeFlag)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ synthesize from full-context label file
+ */
+bool Sinsy::synthesizeFromLabelFile(const std::string& filePath, SynthCondition& condition, bool timeFlag)
+{
+   try {
+      LabelStrings label;
+      if (!readLabelFile(filePath, label)) {
+         return false;
+      }
+      if (!impl->synthesizeFromLabel(label, *condition.impl, timeFlag)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 /*!
  stop
  */
@@ -1002,6 +2082,23 @@ bool Sinsy::loadScoreFromMusicXML(const std::string& xml)
    return true;
 }
 
+/*!
+ load score from MusicXML data in memory
+ */
+bool Sinsy::loadScoreFromMusicXMLData(const char* data, size_t size)
+{
+   try {
+      InputBuffer xmlBuffer(data, size);
+      if (!impl->loadScoreFromMusicXML(xmlBuffer)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 /*!
  save score to MusicXML
  */
@@ -1037,6 +2134,38 @@ bool Sinsy::saveScoreToMusicXML(const std::string& xml, ClefType clefType)
    return true;
 }
 
+/*!
+ load score from binary score file
+ */
+bool Sinsy::loadScoreBinary(const std::string& path)
+{
+   try {
+      if (!impl->loadScoreBinary(path)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ save score to binary score file
+ */
+bool Sinsy::saveScoreBinary(const std::string& path)
+{
+   try {
+      if (!impl->saveScoreBinary(path)) {
+         return false;
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("Exception in API " << FUNC_NAME("") << " : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 size_t Sinsy::get_sampling_frequency() {
    return impl->get_sampling_frequency();
 }
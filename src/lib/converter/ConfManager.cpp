@@ -40,6 +40,7 @@
 /* ----------------------------------------------------------------- */
 
 #include <stdexcept>
+#include <fstream>
 #include <algorithm>
 #include "util_log.h"
 #include "StringTokenizer.h"
@@ -47,7 +48,9 @@
 #include "ConfManager.h"
 #include "ConfGroup.h"
 #include "util_converter.h"
+#include "LazyJConf.h"
 #include "JConf.h"
+#include "DicImage.h"
 
 namespace sinsy
 {
@@ -58,13 +61,44 @@ const std::string UTF_8_STRS("utf_8, utf8, utf-8");
 const std::string SHIFT_JIS_STRS("shift_jis, shift-jis, sjis");
 const std::string EUC_JP_STRS("euc-jp, euc_jp, eucjp");
 const std::string CODE_SEPARATOR = "|";
+const std::string JAPANESE_DIC_IMAGE("japanese.dic");
+const std::string JAPANESE_MACRON("japanese.macron");
+const std::string JAPANESE_ENCODINGS[] = {UTF_8_STRS, SHIFT_JIS_STRS, EUC_JP_STRS};
+const std::string JAPANESE_ENCODING_NAMES[] = {"utf_8", "shift_jis", "euc_jp"};
+const size_t JAPANESE_ENCODING_NUM = sizeof(JAPANESE_ENCODING_NAMES) / sizeof(JAPANESE_ENCODING_NAMES[0]);
+
+/*!
+ get name of phoneme table of encoding (file name, or section name in dictionary image)
+ */
+std::string getJapaneseTableName(size_t idx)
+{
+   return "japanese." + JAPANESE_ENCODING_NAMES[idx] + ".table";
+}
+
+/*!
+ get name of config of encoding (file name, or section name in dictionary image)
+ */
+std::string getJapaneseConfName(size_t idx)
+{
+   return "japanese." + JAPANESE_ENCODING_NAMES[idx] + ".conf";
+}
+
+/*!
+ file exists or not
+ */
+bool existsFile(const std::string& path)
+{
+   std::ifstream ifs(path.c_str());
+   return ifs.is_open();
+}
 };
 
 /*!
  constructor
  */
-ConfManager::ConfManager() : uJConf(NULL), sJConf(NULL), eJConf(NULL), jConfs(NULL)
+ConfManager::ConfManager() : uJConf(NULL), sJConf(NULL), eJConf(NULL), jConfs(NULL), dicImage(NULL)
 {
+   defaultConfs.add(&uConf);
 }
 
 /*!
@@ -82,6 +116,7 @@ ConfManager::~ConfManager()
 */
 void ConfManager::clear()
 {
+   defaultConfs.clear();
    std::for_each(deleteList.begin(), deleteList.end(), Deleter<IConf>());
    deleteList.clear();
    uJConf = NULL;
@@ -89,6 +124,8 @@ void ConfManager::clear()
    eJConf = NULL;
    jConfs = NULL;
    confList.clear();
+   delete dicImage;
+   dicImage = NULL;
 }
 
 /*!
@@ -113,55 +150,62 @@ void ConfManager::addJConf(IConf* conf)
 bool ConfManager::setLanguages(const std::string& languages, const std::string& dirPath)
 {
    clear();
+   const bool result(addLanguages(languages, dirPath));
+
+   // confs are fixed here, and they are not changed until next call of this function
+   const ConfList::const_iterator itrEnd(confList.end());
+   for (ConfList::const_iterator itr(confList.begin()); itrEnd != itr ; ++itr) {
+      defaultConfs.add(*itr);
+   }
+   defaultConfs.add(&uConf);
+
+   return result;
+}
+
+/*!
+ @internal
 
+ add confs of languages
+ */
+bool ConfManager::addLanguages(const std::string& languages, const std::string& dirPath)
+{
    const std::string::const_iterator itrEnd(languages.end());
    for (std::string::const_iterator itr(languages.begin()); itrEnd != itr; ++itr) {
       char lang(*itr);
       switch (lang) {
       case 'j' : { // Japanese
-         const std::string TABLE_UTF_8(dirPath + "/japanese.utf_8.table");
-         const std::string CONF_UTF_8(dirPath + "/japanese.utf_8.conf");
-         const std::string TABLE_SHIFT_JIS(dirPath + "/japanese.shift_jis.table");
-         const std::string CONF_SHIFT_JIS(dirPath + "/japanese.shift_jis.conf");
-         const std::string TABLE_EUC_JP(dirPath + "/japanese.euc_jp.table");
-         const std::string CONF_EUC_JP(dirPath + "/japanese.euc_jp.conf");
-         const std::string MACRON_TABLE(dirPath + "/japanese.macron");
-
-         uJConf = new JConf(UTF_8_STRS);
-         sJConf = new JConf(SHIFT_JIS_STRS);
-         eJConf = new JConf(EUC_JP_STRS);
-
-         // utf-8
-         if (!uJConf->read(TABLE_UTF_8, CONF_UTF_8, MACRON_TABLE)) {
-            ERR_MSG("Cannot read Japanese table or config or macron file : " << TABLE_UTF_8 << ", " << CONF_UTF_8);
-            delete uJConf;
-            uJConf = NULL;
-            return false;
+         // precompiled dictionary image is used if it exists, otherwise text files are used
+         if ((NULL == dicImage) && existsFile(dirPath + "/" + JAPANESE_DIC_IMAGE)) {
+            dicImage = new DicImage();
+            std::string changedFile;
+            if (!dicImage->open(dirPath + "/" + JAPANESE_DIC_IMAGE)) {
+               WARN_MSG("Cannot use dictionary image, so dictionary files are used : " << dirPath << "/" << JAPANESE_DIC_IMAGE);
+               delete dicImage;
+               dicImage = NULL;
+            } else if (!dicImage->checkSources(dirPath, changedFile)) {
+               WARN_MSG("Dictionary image is older than " << changedFile << ", so dictionary files are used (recompile it by sinsy_dic) : " << dirPath << "/" << JAPANESE_DIC_IMAGE);
+               delete dicImage;
+               dicImage = NULL;
+            }
          }
-         addJConf(uJConf);
-         deleteList.push_back(uJConf);
-
+         const std::string prefix((NULL == dicImage) ? dirPath + "/" : "");
 
-         // shift_jis
-         if (!sJConf->read(TABLE_SHIFT_JIS, CONF_SHIFT_JIS, MACRON_TABLE)) {
-            ERR_MSG("Cannot read Japanese table or config or macron file :" << TABLE_SHIFT_JIS << ", " << CONF_SHIFT_JIS);
-            delete sJConf;
-            sJConf = NULL;
-            return false;
+         // tables of each encoding are read when lyrics in the encoding are converted for the first time
+         LazyJConf** jConfPtrs[] = {&uJConf, &sJConf, &eJConf};
+         for (size_t i(0); i < JAPANESE_ENCODING_NUM; ++i) {
+            LazyJConf* jConf(new LazyJConf(JAPANESE_ENCODINGS[i],
+                                           prefix + getJapaneseTableName(i),
+                                           prefix + getJapaneseConfName(i),
+                                           prefix + JAPANESE_MACRON,
+                                           dicImage));
+            if (!jConf->check()) {
+               delete jConf;
+               return false;
+            }
+            addJConf(jConf);
+            deleteList.push_back(jConf);
+            *jConfPtrs[i] = jConf;
          }
-         addJConf(sJConf);
-         deleteList.push_back(sJConf);
-
-         // euc-jp
-         if (!eJConf->read(TABLE_EUC_JP, CONF_EUC_JP, MACRON_TABLE)) {
-            ERR_MSG("Cannot read Japanese table or config or macron file : " << TABLE_EUC_JP << ", " << CONF_EUC_JP);
-            delete eJConf;
-            eJConf = NULL;
-            return false;
-         }
-         addJConf(eJConf);
-         deleteList.push_back(eJConf);
-
          break;
       }
       default :
@@ -173,19 +217,67 @@ bool ConfManager::setLanguages(const std::string& languages, const std::string&
 }
 
 /*!
- set default confs
+ read files of all confs now (otherwise they are read on first use)
  */
-void ConfManager::setDefaultConfs(ConfGroup& confs) const
+bool ConfManager::preload() const
 {
-   confs.clear();
-   const ConfList::const_iterator itrEnd(confList.end());
-   for (ConfList::const_iterator itr(confList.begin()); itrEnd != itr ; ++itr) {
-      confs.add(*itr);
+   const LazyJConf* jConfPtrs[] = {uJConf, sJConf, eJConf};
+   bool result(true);
+   for (size_t i(0); i < sizeof(jConfPtrs) / sizeof(jConfPtrs[0]); ++i) {
+      if ((NULL != jConfPtrs[i]) && !jConfPtrs[i]->load()) {
+         result = false;
+      }
    }
-   // unknown conf
-   confs.add(&uConf);
+   return result;
+}
+
+/*!
+ get default confs
+
+ Returned confs are shared, and they can be used from several threads at the same time.
+ */
+const ConfGroup& ConfManager::getDefaultConfs() const
+{
+   return defaultConfs;
+}
+
+/*!
+ compile dictionary files in directory into one dictionary image
+
+ Phoneme tables and configs of all encodings and macron table are stored as sections of the image,
+ so that they can be used by mapping the image without parsing text files.
 
-   return;
+ @param dirPath   directory of dictionary files
+ @param imagePath path of dictionary image to write
+ @return          true if success
+ */
+bool ConfManager::compileDictionary(const std::string& dirPath, const std::string& imagePath)
+{
+   DicImage::SectionList sections;
+   DicImage::SourceList sources;
+   const std::string macronPath(dirPath + "/" + JAPANESE_MACRON);
+   for (size_t i(0); i < JAPANESE_ENCODING_NUM; ++i) {
+      JConf jConf(JAPANESE_ENCODINGS[i]);
+      const std::string tablePath(dirPath + "/" + getJapaneseTableName(i));
+      const std::string confPath(dirPath + "/" + getJapaneseConfName(i));
+      if (!jConf.read(tablePath, confPath, macronPath)) {
+         ERR_MSG("Cannot read Japanese table or config or macron file : " << tablePath << ", " << confPath);
+         return false;
+      }
+      DicImage::Writer table;
+      DicImage::Writer conf;
+      DicImage::Writer macron;
+      jConf.write(table, conf, macron);
+      sections.push_back(std::make_pair(getJapaneseTableName(i), table.getData()));
+      sections.push_back(std::make_pair(getJapaneseConfName(i), conf.getData()));
+      sources.push_back(getJapaneseTableName(i));
+      sources.push_back(getJapaneseConfName(i));
+      if (0 == i) { // macron table is common to all encodings
+         sections.push_back(std::make_pair(JAPANESE_MACRON, macron.getData()));
+         sources.push_back(JAPANESE_MACRON);
+      }
+   }
+   return DicImage::write(imagePath, sections, dirPath, sources);
 }
 
 };  // namespace sinsy
@@ -49,8 +49,16 @@
 namespace sinsy
 {
 class Converter;
-class JConf;
+class LazyJConf;
+class DicImage;
 
+/*!
+ Manager of confs of languages
+
+ Confs are set up only by setLanguages(), and they are not changed by other methods,
+ so const methods can be called from several threads at the same time without locking.
+ Dictionaries which are read on first use are loaded safely by each conf.
+ */
 class ConfManager
 {
 public:
@@ -63,8 +71,14 @@ public:
    //! set confs to converter
    bool setLanguages(const std::string& languages, const std::string& dirPath);
 
-   //! set default confs
-   void setDefaultConfs(ConfGroup& confs) const;
+   //! read files of all confs now (otherwise they are read on first use)
+   bool preload() const;
+
+   //! get default confs (confs of languages and conf for unknown language)
+   const ConfGroup& getDefaultConfs() const;
+
+   //! compile dictionary files in directory into one dictionary image
+   static bool compileDictionary(const std::string& dirPath, const std::string& imagePath);
 
 private:
    //! copy constructor (donot use)
@@ -76,17 +90,20 @@ private:
    //! clear all confs
    void clear();
 
+   //! add confs of languages
+   bool addLanguages(const std::string& languages, const std::string& dirPath);
+
    //! add Japanese conf
    void addJConf(IConf* conf);
 
    //! Japanese conf (UTF-8)
-   JConf* uJConf;
+   LazyJConf* uJConf;
 
    //! Japanese conf (Shift_JIS)
-   JConf* sJConf;
+   LazyJConf* sJConf;
 
    //! Japanese conf (EUC-JP)
-   JConf* eJConf;
+   LazyJConf* eJConf;
 
    //! japanese confs
    ConfGroup* jConfs;
@@ -101,6 +118,12 @@ private:
 
    //!< list of IConf to delete
    ConfList deleteList;
+
+   //! default confs (made once by setLanguages)
+   ConfGroup defaultConfs;
+
+   //! dictionary image (deleted after confs which use it)
+   DicImage* dicImage;
 };
 
 };
@@ -58,7 +58,7 @@ namespace
 /*!
  convert resets
 */
-void convertRests(IConf::ConvertableList::iterator begin, IConf::ConvertableList::iterator end, const std::string& silStr)
+void convertRests(IConf::ConvertableList::iterator begin, IConf::ConvertableList::iterator end, const PhonemeSymbol& silSymbol, const PhonemeSymbol& pauSymbol)
 {
    if (begin == end) {
       return;
@@ -69,18 +69,18 @@ void convertRests(IConf::ConvertableList::iterator begin, IConf::ConvertableList
       IConvertable& convertable(**itr);
       if (convertable.isRest() && !convertable.isConverted()) {
          std::vector<PhonemeInfo> phonemes;
-         std::string restType(PhonemeInfo::TYPE_SILENT);
-         std::string restStr(silStr);
+         PhonemeSymbol restType(PhonemeInfo::TYPE_SILENT);
+         PhonemeSymbol restStr(silSymbol);
 
          if (begin != itr) { // not head
             if (!(*(itr - 1))->isRest()) { // prev note is not rest
-               restStr = DEFAULT_PAU_STR;
+               restStr = pauSymbol;
                restType = PhonemeInfo::TYPE_PAUSE;
             }
          }
          if (end - 1 != itr) { // not tail
             if (!(*(itr + 1))->isRest()) { // prev note is not rest
-               restStr = DEFAULT_PAU_STR;
+               restStr = pauSymbol;
                restType = PhonemeInfo::TYPE_PAUSE;
             }
          }
@@ -94,7 +94,7 @@ void convertRests(IConf::ConvertableList::iterator begin, IConf::ConvertableList
 /*!
  constructor
 */
-Converter::Converter()
+Converter::Converter() : silSymbol(DEFAULT_SIL_STR), pauSymbol(DEFAULT_PAU_STR)
 {
 }
 
@@ -103,23 +103,35 @@ Converter::Converter()
 */
 Converter::~Converter()
 {
-   clear();
 }
 
 /*!
- clear
+ clear confs of all languages
 */
 void Converter::clear()
 {
-   confs.clear();
+   confManager.setLanguages("", "");
+   silSymbol = PhonemeSymbol(getSilStr());
 }
 
 /*!
  set confs to converter
+
+ This must not be called while other threads use this converter.
  */
 bool Converter::setLanguages(const std::string& languages, const std::string& dirPath)
 {
-   return confManager.setLanguages(languages, dirPath);
+   const bool result(confManager.setLanguages(languages, dirPath));
+   silSymbol = PhonemeSymbol(getSilStr());
+   return result;
+}
+
+/*!
+ read dictionaries of all languages now
+ */
+bool Converter::preload() const
+{
+   return confManager.preload();
 }
 
 /*!
@@ -127,23 +139,21 @@ bool Converter::setLanguages(const std::string& languages, const std::string& di
  */
 std::string Converter::getSilStr() const
 {
-   if (!confs.empty()) {
-      return confs.front()->getSilStr();
-   }
-   return DEFAULT_SIL_STR;
+   return confManager.getDefaultConfs().getSilStr();
 }
 
 /*!
  convert
+
+ Only convertables in [begin, end) are changed, so this can be called from several threads at the same time.
 */
 bool Converter::convert(const std::string& enc, IConf::ConvertableList::iterator begin, IConf::ConvertableList::iterator end) const
 {
    // convert rests
-   convertRests(begin, end, this->getSilStr());
+   convertRests(begin, end, silSymbol, pauSymbol);
 
    // convert pitches
-   ConfGroup confs;
-   confManager.setDefaultConfs(confs);
+   const ConfGroup& confs(confManager.getDefaultConfs());
    IConf::ConvertableList::iterator b(begin);
    while (end != b) {
       IConvertable& bConv(**b);
@@ -45,10 +45,17 @@
 #include <vector>
 #include "IConf.h"
 #include "ConfManager.h"
+#include "PhonemeSymbol.h"
 
 namespace sinsy
 {
 
+/*!
+ Converter of lyrics to phonemes
+
+ After languages are set, converter is not changed by const methods,
+ so one converter can be shared by LabelMakers on several threads without copying or locking.
+ */
 class Converter
 {
 public:
@@ -58,12 +65,15 @@ public:
    //! destructor
    virtual ~Converter();
 
-   //! clear
+   //! clear (do not call while converter is shared)
    void clear();
 
-   //! set confs to converter
+   //! set confs to converter (do not call while converter is shared)
    bool setLanguages(const std::string& languages, const std::string& dirPath);
 
+   //! read dictionaries of all languages now (otherwise they are read on first use)
+   bool preload() const;
+
    //! get sil str
    std::string getSilStr() const;
 
@@ -80,11 +90,11 @@ private:
    //! config manager
    ConfManager confManager;
 
-   //! config list type
-   typedef std::vector<IConf*> ConfList;
+   //! symbol of silence at edges of score
+   PhonemeSymbol silSymbol;
 
-   //! config list
-   ConfList confs;
+   //! symbol of pause
+   const PhonemeSymbol pauSymbol;
 };
 
 };
@@ -0,0 +1,118 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include "LanguagesImpl.h"
+
+namespace sinsy
+{
+
+/*!
+ constructor
+ */
+LanguagesImpl::LanguagesImpl() : refCount(1), setFlag(false)
+{
+}
+
+/*!
+ destructor
+ */
+LanguagesImpl::~LanguagesImpl()
+{
+}
+
+/*!
+ set languages
+ */
+bool LanguagesImpl::set(const std::string& languages, const std::string& dirPath)
+{
+   setFlag = converter.setLanguages(languages, dirPath);
+   return setFlag;
+}
+
+/*!
+ read dictionaries of all languages now (otherwise they are read on first use)
+ */
+bool LanguagesImpl::preload() const
+{
+   return converter.preload();
+}
+
+/*!
+ set or not
+ */
+bool LanguagesImpl::isSet() const
+{
+   return setFlag;
+}
+
+/*!
+ get converter
+ */
+const Converter& LanguagesImpl::getConverter() const
+{
+   return converter;
+}
+
+/*!
+ add reference
+ */
+void LanguagesImpl::addRef()
+{
+   MutexLock lock(mutex);
+   ++refCount;
+}
+
+/*!
+ release reference
+ */
+void LanguagesImpl::release()
+{
+   bool deleteFlag(false);
+   {
+      MutexLock lock(mutex);
+      --refCount;
+      deleteFlag = (0 == refCount);
+   }
+   if (deleteFlag) {
+      delete this;
+   }
+}
+
+};  // namespace sinsy
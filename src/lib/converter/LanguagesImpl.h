@@ -0,0 +1,106 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_LANGUAGES_IMPL_H_
+#define SINSY_LANGUAGES_IMPL_H_
+
+#include <string>
+#include "Mutex.h"
+#include "Converter.h"
+
+namespace sinsy
+{
+
+/*!
+ Languages shared by Sinsy objects
+
+ Converter is set up only by set() before the object is shared,
+ so it is used from several threads at the same time without copying or locking.
+ */
+class LanguagesImpl
+{
+public:
+   //! constructor (reference count is 1)
+   LanguagesImpl();
+
+   //! set languages (do not call while this object is shared)
+   bool set(const std::string& languages, const std::string& dirPath);
+
+   //! read dictionaries of all languages now
+   bool preload() const;
+
+   //! set or not
+   bool isSet() const;
+
+   //! get converter
+   const Converter& getConverter() const;
+
+   //! add reference
+   void addRef();
+
+   //! release reference (this object is deleted when reference count is 0)
+   void release();
+
+private:
+   //! copy constructor (donot use)
+   LanguagesImpl(const LanguagesImpl&);
+
+   //! assignment operator (donot use)
+   LanguagesImpl& operator=(const LanguagesImpl&);
+
+   //! destructor (use release())
+   virtual ~LanguagesImpl();
+
+   //! mutex for reference count
+   Mutex mutex;
+
+   //! reference count
+   size_t refCount;
+
+   //! set or not
+   bool setFlag;
+
+   //! converter
+   Converter converter;
+};
+
+};
+
+#endif // SINSY_LANGUAGES_IMPL_H_
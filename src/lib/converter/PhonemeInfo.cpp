@@ -45,11 +45,11 @@
 namespace sinsy
 {
 
-const std::string PhonemeInfo::TYPE_SILENT    = "s";
-const std::string PhonemeInfo::TYPE_PAUSE     = "p";
-const std::string PhonemeInfo::TYPE_VOWEL     = "v";
-const std::string PhonemeInfo::TYPE_CONSONANT = "c";
-const std::string PhonemeInfo::TYPE_BREAK     = "b";
+const PhonemeSymbol PhonemeInfo::TYPE_SILENT    = PhonemeSymbol("s");
+const PhonemeSymbol PhonemeInfo::TYPE_PAUSE     = PhonemeSymbol("p");
+const PhonemeSymbol PhonemeInfo::TYPE_VOWEL     = PhonemeSymbol("v");
+const PhonemeSymbol PhonemeInfo::TYPE_CONSONANT = PhonemeSymbol("c");
+const PhonemeSymbol PhonemeInfo::TYPE_BREAK     = PhonemeSymbol("b");
 
 /*!
  constructor
@@ -61,7 +61,7 @@ PhonemeInfo::PhonemeInfo() : scoreFlag(0)
 /*!
  constructor
  */
-PhonemeInfo::PhonemeInfo(const std::string& t, const std::string& p, ScoreFlag f) : type(t), phoneme(p), scoreFlag(f)
+PhonemeInfo::PhonemeInfo(const PhonemeSymbol& t, const PhonemeSymbol& p, ScoreFlag f) : type(t), phoneme(p), scoreFlag(f)
 {
 }
 
@@ -93,7 +93,7 @@ PhonemeInfo& PhonemeInfo::operator=(const PhonemeInfo& obj)
 /*!
  get type
  */
-const std::string& PhonemeInfo::getType() const
+const PhonemeSymbol& PhonemeInfo::getType() const
 {
    return this->type;
 }
@@ -101,7 +101,7 @@ const std::string& PhonemeInfo::getType() const
 /*!
  get phoneme
  */
-const std::string& PhonemeInfo::getPhoneme() const
+const PhonemeSymbol& PhonemeInfo::getPhoneme() const
 {
    return this->phoneme;
 }
@@ -109,7 +109,7 @@ const std::string& PhonemeInfo::getPhoneme() const
 /*!
  set phoneme
  */
-void PhonemeInfo::setPhoneme(const std::string& p)
+void PhonemeInfo::setPhoneme(const PhonemeSymbol& p)
 {
    this->phoneme = p;
 }
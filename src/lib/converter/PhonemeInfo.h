@@ -44,6 +44,7 @@
 
 #include <string>
 #include "util_converter.h"
+#include "PhonemeSymbol.h"
 
 namespace sinsy
 {
@@ -51,17 +52,17 @@ namespace sinsy
 class PhonemeInfo
 {
 public:
-   static const std::string TYPE_SILENT;
-   static const std::string TYPE_PAUSE;
-   static const std::string TYPE_VOWEL;
-   static const std::string TYPE_CONSONANT;
-   static const std::string TYPE_BREAK;
+   static const PhonemeSymbol TYPE_SILENT;
+   static const PhonemeSymbol TYPE_PAUSE;
+   static const PhonemeSymbol TYPE_VOWEL;
+   static const PhonemeSymbol TYPE_CONSONANT;
+   static const PhonemeSymbol TYPE_BREAK;
 
    //! constructor
    PhonemeInfo();
 
    //! constructor
-   PhonemeInfo(const std::string& type, const std::string& phoneme, ScoreFlag flag = 0);
+   PhonemeInfo(const PhonemeSymbol& type, const PhonemeSymbol& phoneme, ScoreFlag flag = 0);
 
    //! copy constructor
    PhonemeInfo(const PhonemeInfo& obj);
@@ -73,22 +74,22 @@ public:
    PhonemeInfo& operator=(const PhonemeInfo&);
 
    //! get type
-   const std::string& getType() const;
+   const PhonemeSymbol& getType() const;
 
    //! get phoneme
-   const std::string& getPhoneme() const;
+   const PhonemeSymbol& getPhoneme() const;
 
    //! set phoneme
-   void setPhoneme(const std::string& p);
+   void setPhoneme(const PhonemeSymbol& p);
 
    ScoreFlag getScoreFlag() const;
 
 private:
    //! type (TYPE_SILENT, TYPE_PAUSE, ..., or TYPE_BREAK)
-   std::string type;
+   PhonemeSymbol type;
 
    //! phoneme
-   std::string phoneme;
+   PhonemeSymbol phoneme;
 
    ScoreFlag scoreFlag;
 };
@@ -54,7 +54,7 @@ namespace
 {
 const std::string SIL_STR = "sil";
 const std::string LANGUAGE_INFO = "";
-const std::string UNKNOWN_PHONEME = "xx";
+const PhonemeSymbol UNKNOWN_PHONEME("xx");
 };
 
 /*!
@@ -97,7 +97,7 @@ bool UnknownConf::convert(const std::string& enc, ConvertableList::iterator begi
          ScoreFlag flag(analyzeScoreFlags(lyric));
 
          std::vector<PhonemeInfo> phonemes;
-         phonemes.push_back(PhonemeInfo("", UNKNOWN_PHONEME, flag));
+         phonemes.push_back(PhonemeInfo(PhonemeSymbol(), UNKNOWN_PHONEME, flag));
          convertable.addInfo(phonemes, LANGUAGE_INFO, "");
       }
    }
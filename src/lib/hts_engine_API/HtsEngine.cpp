@@ -45,13 +45,50 @@
 #include <limits>
 #include <stdlib.h>
 #include <limits.h>
+#include <sstream>
+#include <sys/stat.h>
 #include "HtsEngine.h"
 #include "LabelStrings.h"
 #include "SynthConditionImpl.h"
+#include "WaveFile.h"
+
+// share() and clear() copy and free members of HTS_Condition and HTS_ModelSet directly,
+// so they depend on layout and ownership of these structures in hts_engine API 1.10
+// (do not access these structures in other functions)
+#ifndef HTS_VERSION
+#error "hts_engine API 1.10 is required"
+#endif
 
 namespace sinsy
 {
 
+namespace
+{
+const char SUPPORTED_HTS_VERSION[] = "1.10";
+
+// compilation fails if length of HTS_VERSION differs (the version itself is checked by share())
+typedef char HtsVersionCheck[(sizeof(HTS_VERSION) == sizeof(SUPPORTED_HTS_VERSION)) ? 1 : -1];
+
+/*!
+ make key of voice files (paths, sizes and modification times)
+
+ files replaced at same paths get different keys, because waveforms may be spilled and found by other processes
+ */
+std::string makeVoiceKey(const std::vector<std::string>& voices)
+{
+   std::ostringstream oss;
+   for (std::vector<std::string>::const_iterator itr(voices.begin()); voices.end() != itr; ++itr) {
+      struct stat st;
+      oss << *itr;
+      if (0 == stat(itr->c_str(), &st)) {
+         oss << ' ' << static_cast<UINT64>(st.st_size) << ' ' << static_cast<UINT64>(st.st_mtime);
+      }
+      oss << '\n';
+   }
+   return oss.str();
+}
+};
+
 /*!
  constructor
  */
@@ -75,6 +112,10 @@ void HtsEngine::init()
 {
    HTS_Engine_initialize(&engine);
    fperiod = 0;
+   stopFlag = false;
+   sharedFlag = false;
+   halfTone = 0.0;
+   voiceKey.clear();
 }
 
 /*!
@@ -82,6 +123,31 @@ void HtsEngine::init()
  */
 void HtsEngine::clear()
 {
+   if (sharedFlag) {
+      // voices are owned by other engine: free only conditions of this engine
+      HTS_Engine_refresh(&engine);
+      const size_t nvoices(HTS_Engine_get_nvoices(&engine));
+      HTS_Condition& condition(engine.condition);
+      for (size_t i(0); i < nvoices; ++i) {
+         if (condition.parameter_iw) {
+            free(condition.parameter_iw[i]);
+         }
+         if (condition.gv_iw) {
+            free(condition.gv_iw[i]);
+         }
+      }
+      free(condition.parameter_iw);
+      free(condition.gv_iw);
+      free(condition.msd_threshold);
+      free(condition.gv_weight);
+      free(condition.duration_iw);
+      condition.parameter_iw = NULL;
+      condition.gv_iw = NULL;
+      condition.msd_threshold = NULL;
+      condition.gv_weight = NULL;
+      condition.duration_iw = NULL;
+      memset(&engine.ms, 0, sizeof(engine.ms));
+   }
    HTS_Engine_clear(&engine);
 }
 
@@ -106,6 +172,11 @@ bool HtsEngine::load(const std::vector<std::string>& voices)
    if (voices.size() == 0)
       return false;
 
+   // voices shared with other engine must not be cleared by HTS_Engine_load()
+   if (sharedFlag) {
+      reset();
+   }
+
    // get HTS voice file names
    fn_voices = (char **) malloc(voices.size() * sizeof(char *));
    if (NULL == fn_voices) {
@@ -132,6 +203,7 @@ bool HtsEngine::load(const std::vector<std::string>& voices)
 
    // save default frame period
    fperiod = HTS_Engine_get_fperiod(&engine);
+   voiceKey = makeVoiceKey(voices);
 
    // set audio buffer size (100ms)
    HTS_Engine_set_audio_buff_size(&engine, (size_t) ((double) HTS_Engine_get_sampling_frequency(&engine) * 0.100));
@@ -142,6 +214,76 @@ bool HtsEngine::load(const std::vector<std::string>& voices)
    return true;
 }
 
+/*!
+ share voices loaded by other engine
+
+ Model set of source is used in place (it is not modified by synthesis) and conditions are copied,
+ so only buffers for synthesis are allocated by this engine.
+ Audio device of this engine is opened only when waveform is played.
+*/
+bool HtsEngine::share(HtsEngine& source)
+{
+   if (this == &source) {
+      return false;
+   }
+   if (0 != strcmp(HTS_VERSION, SUPPORTED_HTS_VERSION)) {
+      ERR_MSG("Voices cannot be shared with hts_engine API " << HTS_VERSION << " (" << SUPPORTED_HTS_VERSION << " is required)");
+      return false;
+   }
+   reset();
+
+   const size_t nvoices(HTS_Engine_get_nvoices(&source.engine));
+   const size_t nstream(HTS_Engine_get_nstream(&source.engine));
+   if (0 == nvoices) {
+      return false;
+   }
+
+   const HTS_Condition& src(source.engine.condition);
+   HTS_Condition& dst(engine.condition);
+   dst = src;
+   dst.stop = FALSE;
+   dst.msd_threshold = NULL;
+   dst.gv_weight = NULL;
+   dst.duration_iw = NULL;
+   dst.parameter_iw = NULL;
+   dst.gv_iw = NULL;
+   engine.ms = source.engine.ms;
+   sharedFlag = true;
+   fperiod = source.fperiod;
+   halfTone = source.halfTone;
+   voiceKey = source.voiceKey;
+
+   bool allocated(true);
+   dst.msd_threshold = static_cast<double*>(calloc(nstream, sizeof(double)));
+   dst.gv_weight = static_cast<double*>(calloc(nstream, sizeof(double)));
+   dst.duration_iw = static_cast<double*>(calloc(nvoices, sizeof(double)));
+   dst.parameter_iw = static_cast<double**>(calloc(nvoices, sizeof(double*)));
+   dst.gv_iw = static_cast<double**>(calloc(nvoices, sizeof(double*)));
+   if (!dst.msd_threshold || !dst.gv_weight || !dst.duration_iw || !dst.parameter_iw || !dst.gv_iw) {
+      allocated = false;
+   } else {
+      for (size_t i(0); i < nvoices; ++i) {
+         dst.parameter_iw[i] = static_cast<double*>(calloc(nstream, sizeof(double)));
+         dst.gv_iw[i] = static_cast<double*>(calloc(nstream, sizeof(double)));
+         if (!dst.parameter_iw[i] || !dst.gv_iw[i]) {
+            allocated = false;
+            break;
+         }
+         memcpy(dst.parameter_iw[i], src.parameter_iw[i], nstream * sizeof(double));
+         memcpy(dst.gv_iw[i], src.gv_iw[i], nstream * sizeof(double));
+      }
+   }
+   if (!allocated) {
+      reset();
+      throw std::bad_alloc();
+   }
+   memcpy(dst.msd_threshold, src.msd_threshold, nstream * sizeof(double));
+   memcpy(dst.gv_weight, src.gv_weight, nstream * sizeof(double));
+   memcpy(dst.duration_iw, src.duration_iw, nvoices * sizeof(double));
+
+   return true;
+}
+
 /*!
  synthesize
 */
@@ -154,10 +296,11 @@ bool HtsEngine::synthesize(const LabelStrings& label, SynthConditionImpl& condit
 
    bool playFlag = condition.playFlag;
    bool saveFlag = !condition.saveFilePath.empty();
-   bool storeFlag = (NULL != condition.waveformBuffer);
+   bool saveBufferFlag = (NULL != condition.saveBuffer);
+   bool storeFlag = condition.waveformBuffer.isValid();
 
    // nothing to do
-   if (!playFlag && !saveFlag && !storeFlag) {
+   if (!playFlag && !saveFlag && !saveBufferFlag && !storeFlag) {
       return true;
    }
 
@@ -186,12 +329,19 @@ bool HtsEngine::synthesize(const LabelStrings& label, SynthConditionImpl& condit
          HTS_Engine_save_riff(&engine, fp);
       fclose(fp);
    }
+   if (saveBufferFlag && 0 == error) {
+      WaveFile waveFile;
+      waveFile.open(*condition.saveBuffer, HTS_Engine_get_sampling_frequency(&engine));
+      waveFile.write(engine.gss.gspeech, HTS_Engine_get_nsamples(&engine));
+      waveFile.close();
+   }
    if (storeFlag && 0 == error) {
-      if(condition.waveformBuffer) {
-         size_t numSamples = HTS_Engine_get_nsamples(&engine);
-         condition.waveformBuffer->resize(numSamples);
-         for (size_t i = 0; i < numSamples; ++i)
-            (*condition.waveformBuffer)[i] = HTS_Engine_get_generated_speech(&engine, i);
+      // generated speech is converted at once (not sample by sample)
+      condition.waveformBuffer.clear();
+      const size_t numSamples = HTS_Engine_get_nsamples(&engine);
+      if ((0 < numSamples) && !condition.waveformBuffer.append(engine.gss.gspeech, numSamples)) {
+         WARN_MSG("Waveform buffer is too small : " << numSamples << " samples are generated");
+         error = 1;
       }
    }
 
@@ -210,6 +360,7 @@ bool HtsEngine::synthesize(const LabelStrings& label, SynthConditionImpl& condit
 */
 void HtsEngine::stop()
 {
+   stopFlag = true;
    HTS_Engine_set_stop_flag(&engine, true);
 }
 
@@ -218,9 +369,18 @@ void HtsEngine::stop()
 */
 void HtsEngine::resetStopFlag()
 {
+   stopFlag = false;
    HTS_Engine_set_stop_flag(&engine, false);
 }
 
+/*!
+ stopped or not
+*/
+bool HtsEngine::isStopped() const
+{
+   return stopFlag;
+}
+
 /*!
  set alpha
 */
@@ -244,6 +404,7 @@ bool HtsEngine::setTone(double tone)
    }
 
    HTS_Engine_add_half_tone(&engine, tone);
+   halfTone += tone;
    return true;
 }
 
@@ -301,5 +462,40 @@ size_t HtsEngine::get_sampling_frequency() {
    return HTS_Engine_get_sampling_frequency(&engine);
 }
 
+/*!
+ append key of voices and conditions
+*/
+void HtsEngine::appendConditionKey(std::string& key) const
+{
+   key.append(voiceKey);
+
+   // getters of hts_engine API do not modify engine
+   // (conditions given only by voice files, e.g. stage and gain, are identified by key of voices)
+   HTS_Engine* e(const_cast<HTS_Engine*>(&engine));
+   const size_t nvoices(HTS_Engine_get_nvoices(e));
+   const size_t nstream(HTS_Engine_get_nstream(e));
+   std::vector<double> values;
+   values.push_back(static_cast<double>(HTS_Engine_get_sampling_frequency(e)));
+   values.push_back(static_cast<double>(HTS_Engine_get_fperiod(e)));
+   values.push_back(HTS_Engine_get_volume(e));
+   values.push_back(HTS_Engine_get_alpha(e));
+   values.push_back(HTS_Engine_get_beta(e));
+   values.push_back(halfTone);
+   for (size_t i(0); i < nstream; ++i) {
+      values.push_back(HTS_Engine_get_msd_threshold(e, i));
+      values.push_back(HTS_Engine_get_gv_weight(e, i));
+   }
+   for (size_t i(0); i < nvoices; ++i) {
+      values.push_back(HTS_Engine_get_duration_interpolation_weight(e, i));
+      for (size_t j(0); j < nstream; ++j) {
+         values.push_back(HTS_Engine_get_parameter_interpolation_weight(e, i, j));
+         values.push_back(HTS_Engine_get_gv_interpolation_weight(e, i, j));
+      }
+   }
+   if (!values.empty()) {
+      key.append(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(double));
+   }
+}
+
 
 };  // namespace sinsy
@@ -67,6 +67,9 @@ public:
    //! load voices
    bool load(const std::vector<std::string>&);
 
+   //! share voices loaded by other engine (source has to live longer than this)
+   bool share(HtsEngine& source);
+
    //! synthesize
    bool synthesize(const LabelStrings& label, SynthConditionImpl& condition);
 
@@ -76,6 +79,9 @@ public:
    //! reset stop flag
    void resetStopFlag();
 
+   //! stopped or not
+   bool isStopped() const;
+
    //! set alpha
    bool setAlpha(double);
 
@@ -93,6 +99,9 @@ public:
 
    size_t get_sampling_frequency();
 
+   //! append key of voices and conditions (waveforms synthesized with same key and labels are same)
+   void appendConditionKey(std::string& key) const;
+
 private:
    //! copy constructor (donot use)
    explicit HtsEngine(const HtsEngine&);
@@ -111,6 +120,18 @@ private:
 
    //! default frame period
    size_t fperiod;
+
+   //! stop flag (kept until reset)
+   volatile bool stopFlag;
+
+   //! voices are shared with other engine or not
+   bool sharedFlag;
+
+   //! half tone added to pitch
+   double halfTone;
+
+   //! key of voice files (paths, sizes and modification times when loaded)
+   std::string voiceKey;
 };
 
 };
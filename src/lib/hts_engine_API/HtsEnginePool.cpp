@@ -0,0 +1,304 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <algorithm>
+#include "util_log.h"
+#include "Deleter.h"
+#include "Thread.h"
+#include "LabelStrings.h"
+#include "SynthConditionImpl.h"
+#include "HtsEnginePool.h"
+
+namespace sinsy
+{
+
+/*!
+ @internal
+
+ worker to synthesize segments with one engine
+ */
+class HtsEnginePool::Worker : public IRunnable
+{
+public:
+   //! constructor
+   Worker(HtsEnginePool& p, HtsEngine& e) : pool(p), engine(e) {}
+
+   //! destructor
+   virtual ~Worker() {}
+
+   //! synthesize segments until there is no segment
+   virtual void run() {
+      size_t idx(0);
+      while (pool.getNextSegment(idx)) {
+         std::vector<double>* waveform(NULL);
+         bool failed(false);
+         try {
+            waveform = new std::vector<double>;
+            SynthConditionImpl condition;
+            condition.setWaveformBuffer(*waveform);
+            // waveform of interrupted segment is not complete
+            if (!engine.synthesize(*(*pool.labels)[idx], condition) || engine.isStopped()) {
+               failed = true;
+            }
+         } catch (const std::exception& ex) {
+            ERR_MSG("Exception in HtsEnginePool::Worker::run() : " << ex.what());
+            failed = true;
+         }
+         if (failed) {
+            delete waveform;
+            waveform = NULL;
+         }
+         pool.setResult(idx, waveform, failed);
+      }
+   }
+
+private:
+   //! copy constructor (donot use)
+   Worker(const Worker&);
+
+   //! assignment operator (donot use)
+   Worker& operator=(const Worker&);
+
+   //! pool
+   HtsEnginePool& pool;
+
+   //! engine
+   HtsEngine& engine;
+};
+
+/*!
+ constructor
+ */
+HtsEnginePool::HtsEnginePool(HtsEngine& e) : engine(e), sharedNum(0), sharedRevision(0), labels(NULL), nextSegment(0), outputSegment(0), maxAhead(0), stopFlag(false)
+{
+}
+
+/*!
+ destructor
+ */
+HtsEnginePool::~HtsEnginePool()
+{
+   std::for_each(engines.begin(), engines.end(), Deleter<HtsEngine>());
+}
+
+/*!
+ synthesize segments in parallel and output waveforms in order
+
+ @param labels labels of segments
+ @param threadNum number of threads (engines)
+ @param output output of waveforms (called once per segment, even if waveform is empty)
+ @param revision revision of voices and parameters of main engine
+ @return true if success (or stopped)
+ */
+bool HtsEnginePool::synthesize(const std::vector<LabelStrings*>& l, size_t threadNum, IWaveformOutput& output, size_t revision)
+{
+   const size_t segmentNum(l.size());
+   if (0 == segmentNum) {
+      return true;
+   }
+   if (threadNum < 1) {
+      threadNum = 1;
+   }
+   if (segmentNum < threadNum) {
+      threadNum = segmentNum;
+   }
+
+   prepare(threadNum - 1, revision);
+
+   {
+      MutexLock lock(mutex);
+      labels = &l;
+      nextSegment = 0;
+      outputSegment = 0;
+      maxAhead = threadNum * 2;
+      states.assign(segmentNum, STATE_WAITING);
+      waveforms.assign(segmentNum, static_cast<std::vector<double>*>(NULL));
+      stopFlag = false;
+   }
+
+   std::vector<Worker*> workers;
+   std::vector<Thread*> threads;
+   workers.push_back(new Worker(*this, engine));
+   for (size_t i(0); i < threadNum - 1; ++i) {
+      workers.push_back(new Worker(*this, *engines[i]));
+   }
+   for (size_t i(0); i < workers.size(); ++i) {
+      Thread* thread(new Thread(*workers[i]));
+      if (!thread->start()) {
+         delete thread;
+         continue;
+      }
+      threads.push_back(thread);
+   }
+   if (threads.empty()) {
+      // no thread: synthesize all segments by this thread
+      {
+         MutexLock lock(mutex);
+         maxAhead = segmentNum;
+      }
+      workers[0]->run();
+   }
+
+   bool result(true);
+   try {
+      for (size_t i(0); i < segmentNum; ++i) {
+         std::vector<double>* waveform(NULL);
+         {
+            MutexLock lock(mutex);
+            while ((STATE_WAITING == states[i]) && !stopFlag) {
+               condition.wait(mutex);
+            }
+            if (stopFlag) {
+               // stopped: segments which are not output yet are dropped
+            } else if (STATE_FAILED == states[i]) {
+               result = false;
+               stopFlag = true;
+            } else if (STATE_DONE == states[i]) {
+               waveform = waveforms[i];
+               waveforms[i] = NULL;
+               outputSegment = i + 1;
+            }
+            condition.broadcast();
+         }
+         if (NULL == waveform) {
+            break;
+         }
+         output.output(waveform->empty() ? NULL : &(*waveform)[0], waveform->size());
+         delete waveform;
+      }
+   } catch (...) {
+      stop();
+      std::for_each(threads.begin(), threads.end(), Deleter<Thread>());
+      std::for_each(workers.begin(), workers.end(), Deleter<Worker>());
+      std::for_each(waveforms.begin(), waveforms.end(), Deleter<std::vector<double> >());
+      waveforms.clear();
+      throw;
+   }
+
+   {
+      MutexLock lock(mutex);
+      stopFlag = true;
+      condition.broadcast();
+   }
+   std::for_each(threads.begin(), threads.end(), Deleter<Thread>());
+   std::for_each(workers.begin(), workers.end(), Deleter<Worker>());
+   std::for_each(waveforms.begin(), waveforms.end(), Deleter<std::vector<double> >());
+   waveforms.clear();
+   labels = NULL;
+
+   return result;
+}
+
+/*!
+ stop synthesizing
+ */
+void HtsEnginePool::stop()
+{
+   MutexLock lock(mutex);
+   stopFlag = true;
+   condition.broadcast();
+   engine.stop();
+   for (EngineList::iterator itr(engines.begin()); engines.end() != itr; ++itr) {
+      (*itr)->stop();
+   }
+}
+
+/*!
+ @internal
+
+ prepare engines sharing voices with main engine
+
+ engines share voices and parameters again only after they are changed in main engine
+ */
+void HtsEnginePool::prepare(size_t num, size_t revision)
+{
+   MutexLock lock(mutex);
+   if (revision != sharedRevision) {
+      sharedNum = 0;
+      sharedRevision = revision;
+   }
+   while (engines.size() < num) {
+      engines.push_back(new HtsEngine());
+   }
+   for ( ; sharedNum < num; ++sharedNum) {
+      if (!engines[sharedNum]->share(engine)) {
+         throw std::runtime_error("HtsEnginePool::prepare() cannot share voices");
+      }
+   }
+   for (size_t i(0); i < num; ++i) {
+      engines[i]->resetStopFlag();
+   }
+}
+
+/*!
+ @internal
+
+ get next segment to synthesize
+ */
+bool HtsEnginePool::getNextSegment(size_t& idx)
+{
+   MutexLock lock(mutex);
+   for ( ; ; ) {
+      if (stopFlag || (labels->size() <= nextSegment)) {
+         return false;
+      }
+      if (nextSegment < outputSegment + maxAhead) {
+         idx = nextSegment;
+         ++nextSegment;
+         return true;
+      }
+      condition.wait(mutex);
+   }
+}
+
+/*!
+ @internal
+
+ set result of segment
+ */
+void HtsEnginePool::setResult(size_t idx, std::vector<double>* waveform, bool failed)
+{
+   MutexLock lock(mutex);
+   states[idx] = failed ? STATE_FAILED : STATE_DONE;
+   waveforms[idx] = waveform;
+   condition.broadcast();
+}
+
+};  // namespace sinsy
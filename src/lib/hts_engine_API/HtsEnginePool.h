@@ -0,0 +1,138 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_HTS_ENGINE_POOL_H_
+#define SINSY_HTS_ENGINE_POOL_H_
+
+#include <vector>
+#include "HtsEngine.h"
+#include "IWaveformOutput.h"
+#include "Mutex.h"
+
+namespace sinsy
+{
+class LabelStrings;
+
+class HtsEnginePool
+{
+public:
+   //! constructor
+   explicit HtsEnginePool(HtsEngine& engine);
+
+   //! destructor
+   virtual ~HtsEnginePool();
+
+   //! synthesize segments in parallel and output waveforms in order (one output per segment): engines share voices again only if revision of main engine is changed
+   bool synthesize(const std::vector<LabelStrings*>& labels, size_t threadNum, IWaveformOutput& output, size_t revision);
+
+   //! stop synthesizing
+   void stop();
+
+private:
+   //! copy constructor (donot use)
+   HtsEnginePool(const HtsEnginePool&);
+
+   //! assignment operator (donot use)
+   HtsEnginePool& operator=(const HtsEnginePool&);
+
+   //! worker to synthesize segments
+   class Worker;
+
+   //! state of segment
+   enum State {
+      STATE_WAITING, //!< not synthesized yet
+      STATE_DONE, //!< synthesized
+      STATE_FAILED //!< failed
+   };
+
+   //! prepare engines
+   void prepare(size_t num, size_t revision);
+
+   //! get next segment to synthesize (return false if there is no segment)
+   bool getNextSegment(size_t& idx);
+
+   //! set result of segment
+   void setResult(size_t idx, std::vector<double>* waveform, bool failed);
+
+   //! main engine (owner of voices)
+   HtsEngine& engine;
+
+   typedef std::vector<HtsEngine*> EngineList;
+
+   //! engines sharing voices with main engine
+   EngineList engines;
+
+   //! number of engines sharing voices and parameters of main engine at shared revision
+   size_t sharedNum;
+
+   //! revision of main engine when engines shared its voices and parameters
+   size_t sharedRevision;
+
+   //! mutex
+   Mutex mutex;
+
+   //! condition variable
+   Condition condition;
+
+   //! labels of segments
+   const std::vector<LabelStrings*>* labels;
+
+   //! index of next segment to synthesize
+   size_t nextSegment;
+
+   //! index of next segment to output
+   size_t outputSegment;
+
+   //! max number of segments synthesized before output
+   size_t maxAhead;
+
+   //! states of segments
+   std::vector<State> states;
+
+   //! waveforms of segments
+   std::vector<std::vector<double>*> waveforms;
+
+   //! stop flag
+   bool stopFlag;
+};
+
+};
+
+#endif // SINSY_HTS_ENGINE_POOL_H_
@@ -0,0 +1,572 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "util_log.h"
+#include "SynthCacheImpl.h"
+
+namespace sinsy
+{
+
+namespace
+{
+const size_t DEFAULT_MAX_MEMORY_SIZE = 64 * 1024 * 1024;
+const char SPILLED_FILE_MAGIC[] = "SINSYPC2";
+const size_t SPILLED_FILE_MAGIC_SIZE = sizeof(SPILLED_FILE_MAGIC) - 1;
+const char SPILLED_FILE_EXTENSION[] = ".pcm";
+const char TEMPORARY_FILE_EXTENSION[] = ".tmp";
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+/*!
+ append hexadecimal string of value
+ */
+void appendHex(std::string& str, UINT64 value)
+{
+   for (int shift(60); 0 <= shift; shift -= 4) {
+      str.push_back(HEX_DIGITS[(value >> shift) & 0xf]);
+   }
+}
+
+/*!
+ get size of spilled file (magic, size of key, key, number of samples and samples)
+ */
+size_t getSpilledFileSize(size_t keySize, size_t sampleNum)
+{
+   return SPILLED_FILE_MAGIC_SIZE + sizeof(UINT64) + keySize + sizeof(UINT64) + sampleNum * sizeof(double);
+}
+
+/*!
+ get path of temporary file that is renamed to spilled file after writing
+
+ process id and address of writer make the path unique among processes and threads sharing the directory
+ */
+std::string getTemporaryFilePath(const std::string& path, const void* writer)
+{
+#ifdef _WIN32
+   const UINT64 pid(static_cast<UINT64>(_getpid()));
+#else
+   const UINT64 pid(static_cast<UINT64>(getpid()));
+#endif
+   std::string tmp(path);
+   tmp.push_back('.');
+   appendHex(tmp, pid);
+   tmp.push_back('.');
+   appendHex(tmp, static_cast<UINT64>(reinterpret_cast<size_t>(writer)));
+   tmp += TEMPORARY_FILE_EXTENSION;
+   return tmp;
+}
+
+/*!
+ rename temporary file to spilled file (existing file is replaced)
+ */
+bool renameFile(const std::string& from, const std::string& to)
+{
+   if (0 == rename(from.c_str(), to.c_str())) {
+      return true;
+   }
+   // rename() does not replace existing file on some platforms
+   remove(to.c_str());
+   return 0 == rename(from.c_str(), to.c_str());
+}
+};
+
+/*!
+ constructor
+ */
+SynthCacheImpl::SynthCacheImpl() : memorySize(0), maxMemorySize(DEFAULT_MAX_MEMORY_SIZE), spilledSize(0), maxSpilledSize(0)
+{
+}
+
+/*!
+ destructor
+ */
+SynthCacheImpl::~SynthCacheImpl()
+{
+   clear();
+}
+
+/*!
+ @internal
+
+ destructor of spill task
+ */
+SynthCacheImpl::SpillTask::~SpillTask()
+{
+   for (std::vector<Entry*>::iterator itr(entries.begin()); entries.end() != itr; ++itr) {
+      delete *itr;
+   }
+}
+
+/*!
+ set max size of waveforms kept in memory
+ */
+void SynthCacheImpl::setMaxMemorySize(size_t size)
+{
+   SpillTask task;
+   {
+      MutexLock lock(mutex);
+      maxMemorySize = size;
+      evict(task);
+   }
+   flush(task);
+}
+
+/*!
+ set spill directory
+ */
+void SynthCacheImpl::setSpillDirectory(const std::string& dir, size_t maxSize)
+{
+   SpillTask task;
+   {
+      MutexLock lock(mutex);
+      if (dir != spillDirectory) {
+         spilledFileList.clear();
+         spilledFileMap.clear();
+         spilledSize = 0;
+      }
+      spillDirectory = dir;
+      maxSpilledSize = maxSize;
+      removeSpilledFiles(task);
+   }
+   flush(task);
+}
+
+/*!
+ unset spill directory
+ */
+void SynthCacheImpl::unsetSpillDirectory()
+{
+   MutexLock lock(mutex);
+   spillDirectory.clear();
+   spilledFileList.clear();
+   spilledFileMap.clear();
+   spilledSize = 0;
+   maxSpilledSize = 0;
+}
+
+/*!
+ clear waveforms in memory
+ */
+void SynthCacheImpl::clear()
+{
+   EntryList entries;
+   {
+      MutexLock lock(mutex);
+      entries.swap(entryList);
+      entryMap.clear();
+      memorySize = 0;
+   }
+   for (EntryList::iterator itr(entries.begin()); entries.end() != itr; ++itr) {
+      delete *itr;
+   }
+}
+
+/*!
+ find waveform synthesized from key
+
+ spilled file is read after mutex is unlocked
+
+ @param key labels and parameters of engine
+ @param waveform found waveform
+ @return true if found
+ */
+bool SynthCacheImpl::find(const std::string& key, std::vector<double>& waveform)
+{
+   const Hash hash(makeHash(key));
+   std::string directory;
+   {
+      MutexLock lock(mutex);
+      EntryMap::iterator itr(entryMap.find(hash));
+      if (entryMap.end() != itr) {
+         const Entry& entry(**itr->second);
+         if (entry.key != key) {
+            // hash collision
+            return false;
+         }
+         entryList.splice(entryList.begin(), entryList, itr->second);
+         waveform = entry.waveform;
+         return true;
+      }
+      directory = spillDirectory;
+   }
+   if (directory.empty()) {
+      return false;
+   }
+   if (!readSpilledFile(getSpilledFilePath(directory, hash), key, waveform)) {
+      return false;
+   }
+
+   Entry* entry(new Entry);
+   entry->hash = hash;
+   entry->key = key;
+   entry->waveform = waveform;
+   SpillTask task;
+   {
+      MutexLock lock(mutex);
+      if (directory == spillDirectory) {
+         registerSpilledFile(hash, getSpilledFileSize(key.size(), waveform.size()), task);
+      }
+      if (entryMap.end() == entryMap.find(hash)) {
+         add(entry, task);
+      } else {
+         // stored by other thread while file was read
+         delete entry;
+      }
+   }
+   flush(task);
+   return true;
+}
+
+/*!
+ store waveform synthesized from key
+
+ waveforms evicted from memory are spilled after mutex is unlocked
+ */
+void SynthCacheImpl::store(const std::string& key, const double* waveform, size_t size)
+{
+   const Hash hash(makeHash(key));
+   Entry* entry(new Entry);
+   entry->hash = hash;
+   entry->key = key;
+   entry->waveform.assign(waveform, waveform + size);
+   SpillTask task;
+   {
+      MutexLock lock(mutex);
+      EntryMap::iterator itr(entryMap.find(hash));
+      if (entryMap.end() != itr) {
+         if ((*itr->second)->key == key) {
+            // already stored (e.g. same phrase synthesized twice): only recently used
+            entryList.splice(entryList.begin(), entryList, itr->second);
+            delete entry;
+            entry = NULL;
+         } else {
+            // hash collision: newer waveform is kept
+            erase(itr);
+         }
+      }
+      if (NULL != entry) {
+         add(entry, task);
+      }
+   }
+   flush(task);
+}
+
+/*!
+ @internal
+
+ make hash of key (FNV-1a and sdbm, 64bit each)
+ */
+SynthCacheImpl::Hash SynthCacheImpl::makeHash(const std::string& key)
+{
+   const UINT64 fnvPrime((static_cast<UINT64>(0x100UL) << 32) | 0x1b3UL);
+   Hash hash;
+   hash.first = (static_cast<UINT64>(0xcbf29ce4UL) << 32) | 0x84222325UL;
+   hash.second = static_cast<UINT64>(key.size());
+   const std::string::const_iterator itrEnd(key.end());
+   for (std::string::const_iterator itr(key.begin()); itrEnd != itr; ++itr) {
+      const UINT64 c(static_cast<unsigned char>(*itr));
+      hash.first = (hash.first ^ c) * fnvPrime;
+      hash.second = c + (hash.second << 6) + (hash.second << 16) - hash.second;
+   }
+   return hash;
+}
+
+/*!
+ @internal
+
+ get path of spilled file
+ */
+std::string SynthCacheImpl::getSpilledFilePath(const std::string& dir, const Hash& hash)
+{
+   std::string path(dir);
+   path.push_back('/');
+   appendHex(path, hash.first);
+   appendHex(path, hash.second);
+   path.append(SPILLED_FILE_EXTENSION);
+   return path;
+}
+
+/*!
+ @internal
+
+ get size of entry in memory (key and waveform)
+ */
+size_t SynthCacheImpl::getEntrySize(const Entry& entry)
+{
+   return entry.key.size() + entry.waveform.size() * sizeof(double);
+}
+
+/*!
+ @internal
+
+ write waveform to spilled file
+
+ waveform is written to temporary file first so that readers never see partially written file
+ */
+bool SynthCacheImpl::writeSpilledFile(const std::string& path, const Entry& entry)
+{
+   const std::string tmp(getTemporaryFilePath(path, &entry));
+   FILE* fp(fopen(tmp.c_str(), "wb"));
+   if (NULL == fp) {
+      WARN_MSG("Cannot open spill file : " << tmp);
+      return false;
+   }
+   const UINT64 keySize(entry.key.size());
+   const UINT64 sampleNum(entry.waveform.size());
+   bool result((SPILLED_FILE_MAGIC_SIZE == fwrite(SPILLED_FILE_MAGIC, 1, SPILLED_FILE_MAGIC_SIZE, fp)) &&
+               (1 == fwrite(&keySize, sizeof(keySize), 1, fp)) &&
+               (entry.key.size() == fwrite(entry.key.data(), 1, entry.key.size(), fp)) &&
+               (1 == fwrite(&sampleNum, sizeof(sampleNum), 1, fp)));
+   if (result && !entry.waveform.empty()) {
+      result = (entry.waveform.size() == fwrite(&entry.waveform[0], sizeof(double), entry.waveform.size(), fp));
+   }
+   if ((0 != fclose(fp)) || !result) {
+      WARN_MSG("Cannot write spill file : " << tmp);
+      remove(tmp.c_str());
+      return false;
+   }
+   if (!renameFile(tmp, path)) {
+      WARN_MSG("Cannot rename spill file : " << tmp << " -> " << path);
+      remove(tmp.c_str());
+      return false;
+   }
+   return true;
+}
+
+/*!
+ @internal
+
+ read waveform from spilled file (files spilled by other caches are also read)
+
+ @return false if file is not found, broken, or spilled from other key whose hash is same
+ */
+bool SynthCacheImpl::readSpilledFile(const std::string& path, const std::string& key, std::vector<double>& waveform)
+{
+   FILE* fp(fopen(path.c_str(), "rb"));
+   if (NULL == fp) {
+      return false;
+   }
+   char magic[SPILLED_FILE_MAGIC_SIZE];
+   UINT64 keySize(0);
+   bool result((SPILLED_FILE_MAGIC_SIZE == fread(magic, 1, SPILLED_FILE_MAGIC_SIZE, fp)) &&
+               (0 == memcmp(magic, SPILLED_FILE_MAGIC, SPILLED_FILE_MAGIC_SIZE)) &&
+               (1 == fread(&keySize, sizeof(keySize), 1, fp)));
+   if (result && (keySize != key.size())) {
+      fclose(fp);
+      return false;
+   }
+   if (result) {
+      std::string fileKey(key.size(), '\0');
+      result = fileKey.empty() || (fileKey.size() == fread(&fileKey[0], 1, fileKey.size(), fp));
+      if (result && (fileKey != key)) {
+         fclose(fp);
+         return false;
+      }
+   }
+   UINT64 sampleNum(0);
+   result = result && (1 == fread(&sampleNum, sizeof(sampleNum), 1, fp));
+   if (result) {
+      waveform.resize(static_cast<size_t>(sampleNum));
+      if (!waveform.empty()) {
+         result = (waveform.size() == fread(&waveform[0], sizeof(double), waveform.size(), fp));
+      }
+   }
+   fclose(fp);
+   if (!result) {
+      WARN_MSG("Broken spill file : " << path);
+      waveform.clear();
+      return false;
+   }
+   return true;
+}
+
+/*!
+ @internal
+
+ add waveform to memory (entry is owned by cache or task)
+ */
+void SynthCacheImpl::add(Entry* entry, SpillTask& task)
+{
+   const size_t bytes(getEntrySize(*entry));
+   if (maxMemorySize < bytes) {
+      // too large to keep in memory
+      pushSpill(entry, task);
+      return;
+   }
+   entryList.push_front(entry);
+   entryMap[entry->hash] = entryList.begin();
+   memorySize += bytes;
+   evict(task);
+}
+
+/*!
+ @internal
+
+ remove waveform from memory
+ */
+void SynthCacheImpl::erase(EntryMap::iterator itr)
+{
+   Entry* entry(*itr->second);
+   memorySize -= getEntrySize(*entry);
+   entryList.erase(itr->second);
+   entryMap.erase(itr);
+   delete entry;
+}
+
+/*!
+ @internal
+
+ evict least recently used waveforms
+ */
+void SynthCacheImpl::evict(SpillTask& task)
+{
+   while (maxMemorySize < memorySize) {
+      Entry* entry(entryList.back());
+      memorySize -= getEntrySize(*entry);
+      entryMap.erase(entry->hash);
+      entryList.pop_back();
+      pushSpill(entry, task);
+   }
+}
+
+/*!
+ @internal
+
+ add waveform to spill task
+ */
+void SynthCacheImpl::pushSpill(Entry* entry, SpillTask& task)
+{
+   if (spillDirectory.empty() || (maxSpilledSize < getSpilledFileSize(entry->key.size(), entry->waveform.size()))) {
+      delete entry;
+      return;
+   }
+   SpilledFileMap::iterator itr(spilledFileMap.find(entry->hash));
+   if (spilledFileMap.end() != itr) {
+      // already spilled
+      spilledFileList.splice(spilledFileList.begin(), spilledFileList, itr->second);
+      delete entry;
+      return;
+   }
+   task.directory = spillDirectory;
+   task.entries.push_back(entry);
+}
+
+/*!
+ @internal
+
+ register spilled file
+ */
+void SynthCacheImpl::registerSpilledFile(const Hash& hash, size_t size, SpillTask& task)
+{
+   SpilledFileMap::iterator itr(spilledFileMap.find(hash));
+   if (spilledFileMap.end() != itr) {
+      spilledFileList.splice(spilledFileList.begin(), spilledFileList, itr->second);
+      return;
+   }
+   SpilledFile file;
+   file.hash = hash;
+   file.size = size;
+   spilledFileList.push_front(file);
+   spilledFileMap[hash] = spilledFileList.begin();
+   spilledSize += size;
+   removeSpilledFiles(task);
+}
+
+/*!
+ @internal
+
+ remove least recently used spilled files (files are removed by flush())
+ */
+void SynthCacheImpl::removeSpilledFiles(SpillTask& task)
+{
+   while (maxSpilledSize < spilledSize) {
+      const SpilledFile& file(spilledFileList.back());
+      task.removedFiles.push_back(getSpilledFilePath(spillDirectory, file.hash));
+      spilledSize -= file.size;
+      spilledFileMap.erase(file.hash);
+      spilledFileList.pop_back();
+   }
+}
+
+/*!
+ @internal
+
+ write and remove files collected in spill task
+
+ written files are registered after mutex is locked again (unless spill directory has been changed meanwhile)
+ */
+void SynthCacheImpl::flush(SpillTask& task)
+{
+   SpillTask next;
+   if (!task.entries.empty()) {
+      std::vector<SpilledFile> files;
+      for (std::vector<Entry*>::const_iterator itr(task.entries.begin()); task.entries.end() != itr; ++itr) {
+         const Entry& entry(**itr);
+         if (writeSpilledFile(getSpilledFilePath(task.directory, entry.hash), entry)) {
+            SpilledFile file;
+            file.hash = entry.hash;
+            file.size = getSpilledFileSize(entry.key.size(), entry.waveform.size());
+            files.push_back(file);
+         }
+      }
+      if (!files.empty()) {
+         MutexLock lock(mutex);
+         if (task.directory == spillDirectory) {
+            for (std::vector<SpilledFile>::const_iterator itr(files.begin()); files.end() != itr; ++itr) {
+               registerSpilledFile(itr->hash, itr->size, next);
+            }
+         }
+      }
+   }
+   for (std::vector<std::string>::const_iterator itr(task.removedFiles.begin()); task.removedFiles.end() != itr; ++itr) {
+      remove(itr->c_str());
+   }
+   for (std::vector<std::string>::const_iterator itr(next.removedFiles.begin()); next.removedFiles.end() != itr; ++itr) {
+      remove(itr->c_str());
+   }
+}
+
+};  // namespace sinsy
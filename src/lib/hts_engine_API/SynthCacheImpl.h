@@ -0,0 +1,206 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_SYNTH_CACHE_IMPL_H_
+#define SINSY_SYNTH_CACHE_IMPL_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "util_types.h"
+#include "Mutex.h"
+
+namespace sinsy
+{
+
+class SynthCacheImpl
+{
+public:
+   //! constructor
+   SynthCacheImpl();
+
+   //! destructor
+   virtual ~SynthCacheImpl();
+
+   //! set max size of waveforms kept in memory (bytes)
+   void setMaxMemorySize(size_t size);
+
+   //! set directory to spill waveforms evicted from memory (max size of spilled waveforms is given in bytes)
+   void setSpillDirectory(const std::string& dir, size_t maxSize);
+
+   //! unset spill directory (spilled files are not removed)
+   void unsetSpillDirectory();
+
+   //! clear waveforms in memory (spilled files are not removed)
+   void clear();
+
+   //! find waveform synthesized from key (labels and parameters of engine)
+   bool find(const std::string& key, std::vector<double>& waveform);
+
+   //! store waveform synthesized from key
+   void store(const std::string& key, const double* waveform, size_t size);
+
+private:
+   //! copy constructor (donot use)
+   SynthCacheImpl(const SynthCacheImpl&);
+
+   //! assignment operator (donot use)
+   SynthCacheImpl& operator=(const SynthCacheImpl&);
+
+   //! hash of key
+   struct Hash {
+      UINT64 first; //!< first hash
+      UINT64 second; //!< second hash
+
+      //! less than
+      bool operator<(const Hash& h) const {
+         return (first != h.first) ? (first < h.first) : (second < h.second);
+      }
+   };
+
+   //! waveform in memory
+   struct Entry {
+      Hash hash; //!< hash of key
+      std::string key; //!< key (compared when hash is found, because hashes of different keys may collide)
+      std::vector<double> waveform; //!< waveform
+   };
+
+   //! spilled file
+   struct SpilledFile {
+      Hash hash; //!< hash of key
+      size_t size; //!< size of file
+   };
+
+   typedef std::list<Entry*> EntryList;
+   typedef std::map<Hash, EntryList::iterator> EntryMap;
+   typedef std::list<SpilledFile> SpilledFileList;
+   typedef std::map<Hash, SpilledFileList::iterator> SpilledFileMap;
+
+   //! file operations collected while mutex is locked and done after it is unlocked
+   struct SpillTask {
+      std::string directory; //!< spill directory
+      std::vector<Entry*> entries; //!< waveforms to be spilled (deleted by destructor)
+      std::vector<std::string> removedFiles; //!< spilled files to be removed
+
+      //! constructor
+      SpillTask() {}
+
+      //! destructor
+      ~SpillTask();
+
+   private:
+      //! copy constructor (donot use)
+      SpillTask(const SpillTask&);
+
+      //! assignment operator (donot use)
+      SpillTask& operator=(const SpillTask&);
+   };
+
+   //! make hash of key
+   static Hash makeHash(const std::string& key);
+
+   //! get path of spilled file
+   static std::string getSpilledFilePath(const std::string& dir, const Hash& hash);
+
+   //! get size of entry in memory
+   static size_t getEntrySize(const Entry& entry);
+
+   //! write waveform to spilled file (mutex need not be locked)
+   static bool writeSpilledFile(const std::string& path, const Entry& entry);
+
+   //! read waveform from spilled file (mutex need not be locked)
+   static bool readSpilledFile(const std::string& path, const std::string& key, std::vector<double>& waveform);
+
+   //! add waveform to memory (least recently used waveforms are evicted)
+   void add(Entry* entry, SpillTask& task);
+
+   //! remove waveform from memory
+   void erase(EntryMap::iterator itr);
+
+   //! evict least recently used waveforms while memory size is over max
+   void evict(SpillTask& task);
+
+   //! add waveform to spill task (or delete it if it need not be spilled)
+   void pushSpill(Entry* entry, SpillTask& task);
+
+   //! register spilled file
+   void registerSpilledFile(const Hash& hash, size_t size, SpillTask& task);
+
+   //! remove least recently used files while size of spilled files is over max
+   void removeSpilledFiles(SpillTask& task);
+
+   //! do spill task (mutex must not be locked)
+   void flush(SpillTask& task);
+
+   //! mutex
+   Mutex mutex;
+
+   //! waveforms in memory (most recently used first)
+   EntryList entryList;
+
+   //! index of waveforms in memory
+   EntryMap entryMap;
+
+   //! size of waveforms in memory
+   size_t memorySize;
+
+   //! max size of waveforms in memory
+   size_t maxMemorySize;
+
+   //! spill directory (empty if waveforms are not spilled)
+   std::string spillDirectory;
+
+   //! spilled files (most recently used first)
+   SpilledFileList spilledFileList;
+
+   //! index of spilled files
+   SpilledFileMap spilledFileMap;
+
+   //! size of spilled files
+   size_t spilledSize;
+
+   //! max size of spilled files
+   size_t maxSpilledSize;
+};
+
+};
+
+#endif // SINSY_SYNTH_CACHE_IMPL_H_
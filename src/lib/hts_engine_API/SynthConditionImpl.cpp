@@ -50,7 +50,7 @@ namespace sinsy
 /*!
  constructor
  */
-SynthConditionImpl::SynthConditionImpl() : playFlag(false), waveformBuffer(NULL)
+SynthConditionImpl::SynthConditionImpl() : playFlag(false), saveBuffer(NULL), phraseSplitFlag(false), waveformOutput(NULL)
 {
 }
 
@@ -93,12 +93,68 @@ void SynthConditionImpl::unsetSaveFilePath()
    this->saveFilePath.clear();
 }
 
+/*!
+ set buffer to save RIFF format data
+ */
+void SynthConditionImpl::setSaveBuffer(std::vector<char>& data)
+{
+   this->saveBuffer = &data;
+}
+
+/*!
+ unset buffer to save RIFF format data
+ */
+void SynthConditionImpl::unsetSaveBuffer()
+{
+   this->saveBuffer = NULL;
+}
+
 /*!
  set waveform buffer
  */
 void SynthConditionImpl::setWaveformBuffer(std::vector<double>& waveform)
 {
-   this->waveformBuffer = &waveform;
+   this->waveformBuffer.set(waveform);
+}
+
+/*!
+ set waveform buffer (float)
+ */
+void SynthConditionImpl::setWaveformBuffer(std::vector<float>& waveform)
+{
+   this->waveformBuffer.set(waveform);
+}
+
+/*!
+ set waveform buffer (16bit integer)
+ */
+void SynthConditionImpl::setWaveformBuffer(std::vector<short>& waveform)
+{
+   this->waveformBuffer.set(waveform);
+}
+
+/*!
+ set waveform buffer (owned by user)
+ */
+void SynthConditionImpl::setWaveformBuffer(double* waveform, size_t capacity, size_t& size)
+{
+   this->waveformBuffer.set(waveform, capacity, size);
+}
+
+/*!
+ set waveform buffer (float, owned by user)
+ */
+void SynthConditionImpl::setWaveformBuffer(float* waveform, size_t capacity, size_t& size)
+{
+   this->waveformBuffer.set(waveform, capacity, size);
+}
+
+/*!
+ set waveform buffer (16bit integer, owned by user)
+ */
+void SynthConditionImpl::setWaveformBuffer(short* waveform, size_t capacity, size_t& size)
+{
+   this->waveformBuffer.set(waveform, capacity, size);
 }
 
 /*!
@@ -106,7 +162,39 @@ void SynthConditionImpl::setWaveformBuffer(std::vector<double>& waveform)
  */
 void SynthConditionImpl::unsetWaveformBuffer()
 {
-   this->waveformBuffer = NULL;
+   this->waveformBuffer.unset();
+}
+
+/*!
+ set phrase split flag
+ */
+void SynthConditionImpl::setPhraseSplitFlag()
+{
+   this->phraseSplitFlag = true;
+}
+
+/*!
+ unset phrase split flag
+ */
+void SynthConditionImpl::unsetPhraseSplitFlag()
+{
+   this->phraseSplitFlag = false;
+}
+
+/*!
+ set waveform output
+ */
+void SynthConditionImpl::setWaveformOutput(IWaveformOutput& output)
+{
+   this->waveformOutput = &output;
+}
+
+/*!
+ unset waveform output
+ */
+void SynthConditionImpl::unsetWaveformOutput()
+{
+   this->waveformOutput = NULL;
 }
 
 
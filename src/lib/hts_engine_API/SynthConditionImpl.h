@@ -43,6 +43,9 @@
 #define SINSY_SYNTH_CONDITION_IMPL_H_
 
 #include <string>
+#include <vector>
+#include "IWaveformOutput.h"
+#include "WaveformBuffer.h"
 
 namespace sinsy
 {
@@ -68,12 +71,45 @@ public:
    //! unset file path to save RIFF format file
    void unsetSaveFilePath();
 
+   //! set buffer to save RIFF format data
+   void setSaveBuffer(std::vector<char>& data);
+
+   //! unset buffer to save RIFF format data
+   void unsetSaveBuffer();
+
    //! set waveform buffer
    void setWaveformBuffer(std::vector<double>& waveform);
 
+   //! set waveform buffer (float)
+   void setWaveformBuffer(std::vector<float>& waveform);
+
+   //! set waveform buffer (16bit integer, clipped)
+   void setWaveformBuffer(std::vector<short>& waveform);
+
+   //! set waveform buffer owned by user: at most capacity samples are stored and number of stored samples is set to size
+   void setWaveformBuffer(double* waveform, size_t capacity, size_t& size);
+
+   //! set waveform buffer owned by user (float)
+   void setWaveformBuffer(float* waveform, size_t capacity, size_t& size);
+
+   //! set waveform buffer owned by user (16bit integer, clipped)
+   void setWaveformBuffer(short* waveform, size_t capacity, size_t& size);
+
    //! unset waveform buffer
    void unsetWaveformBuffer();
 
+   //! set phrase split flag
+   void setPhraseSplitFlag();
+
+   //! unset phrase split flag
+   void unsetPhraseSplitFlag();
+
+   //! set waveform output
+   void setWaveformOutput(IWaveformOutput& output);
+
+   //! unset waveform output
+   void unsetWaveformOutput();
+
 
 private:
    //! copy constructor (donot use)
@@ -88,10 +124,20 @@ private:
    // ! file path to save wave data
    std::string saveFilePath;
 
+   //! buffer to save RIFF format data
+   std::vector<char>* saveBuffer;
+
    //! buffer for wave data
-   std::vector<double>* waveformBuffer;
+   WaveformBuffer waveformBuffer;
+
+   //! phrase split flag
+   bool phraseSplitFlag;
+
+   //! output for waveform of each phrase
+   IWaveformOutput* waveformOutput;
 
    friend class HtsEngine;
+   friend class SinsyImpl;
 };
 
 };
@@ -0,0 +1,173 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include "SynthSessionImpl.h"
+
+namespace sinsy
+{
+
+/*!
+ constructor
+ */
+SynthSessionImpl::SynthSessionImpl() : owner(NULL), revision(0), synthesizedNum(0), reusedNum(0), exactFlag(false)
+{
+}
+
+/*!
+ destructor
+ */
+SynthSessionImpl::~SynthSessionImpl()
+{
+   clear();
+}
+
+/*!
+ clear waveforms
+ */
+void SynthSessionImpl::clear()
+{
+   for (EntryMap::iterator itr(entries.begin()); entries.end() != itr; ++itr) {
+      delete itr->second;
+   }
+   entries.clear();
+   owner = NULL;
+   revision = 0;
+}
+
+/*!
+ set exact flag
+ */
+void SynthSessionImpl::setExactFlag(bool f)
+{
+   exactFlag = f;
+}
+
+/*!
+ get exact flag
+ */
+bool SynthSessionImpl::isExact() const
+{
+   return exactFlag;
+}
+
+/*!
+ clear waveforms if owner or revision is changed
+ */
+void SynthSessionImpl::validate(const void* o, size_t r)
+{
+   if ((o != owner) || (r != revision)) {
+      clear();
+      owner = o;
+      revision = r;
+   }
+}
+
+/*!
+ find waveform synthesized from label
+ */
+const std::vector<double>* SynthSessionImpl::find(const std::string& label)
+{
+   EntryMap::iterator itr(entries.find(label));
+   if (entries.end() == itr) {
+      return NULL;
+   }
+   itr->second->used = true;
+   ++reusedNum;
+   return &itr->second->waveform;
+}
+
+/*!
+ store waveform synthesized from label
+ */
+const std::vector<double>* SynthSessionImpl::store(const std::string& label, const double* waveform, size_t size)
+{
+   Entry*& entry(entries[label]);
+   if (NULL == entry) {
+      entry = new Entry;
+   }
+   entry->waveform.assign(waveform, waveform + size);
+   entry->used = true;
+   ++synthesizedNum;
+   return &entry->waveform;
+}
+
+/*!
+ remove waveforms which are not found or stored since last sweep
+ */
+void SynthSessionImpl::sweep()
+{
+   EntryMap::iterator itr(entries.begin());
+   while (entries.end() != itr) {
+      if (itr->second->used) {
+         itr->second->used = false;
+         ++itr;
+      } else {
+         delete itr->second;
+         entries.erase(itr++);
+      }
+   }
+}
+
+/*!
+ get number of phrases synthesized by last synthesis
+ */
+size_t SynthSessionImpl::getSynthesizedPhraseNum() const
+{
+   return synthesizedNum;
+}
+
+/*!
+ get number of phrases reused by last synthesis
+ */
+size_t SynthSessionImpl::getReusedPhraseNum() const
+{
+   return reusedNum;
+}
+
+/*!
+ reset numbers of phrases
+ */
+void SynthSessionImpl::resetPhraseNum()
+{
+   synthesizedNum = 0;
+   reusedNum = 0;
+}
+
+};  // namespace sinsy
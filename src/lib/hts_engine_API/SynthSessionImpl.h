@@ -0,0 +1,126 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_SYNTH_SESSION_IMPL_H_
+#define SINSY_SYNTH_SESSION_IMPL_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace sinsy
+{
+
+class SynthSessionImpl
+{
+public:
+   //! constructor
+   SynthSessionImpl();
+
+   //! destructor
+   virtual ~SynthSessionImpl();
+
+   //! clear waveforms
+   void clear();
+
+   //! set exact flag (song-wide label fields are included in keys of phrases)
+   void setExactFlag(bool f);
+
+   //! get exact flag
+   bool isExact() const;
+
+   //! clear waveforms if they are synthesized by other owner or with other revision of voices and parameters
+   void validate(const void* owner, size_t revision);
+
+   //! find waveform synthesized from label (return NULL if not found)
+   const std::vector<double>* find(const std::string& label);
+
+   //! store waveform synthesized from label
+   const std::vector<double>* store(const std::string& label, const double* waveform, size_t size);
+
+   //! remove waveforms which are not found or stored since last sweep
+   void sweep();
+
+   //! get number of phrases synthesized by last synthesis
+   size_t getSynthesizedPhraseNum() const;
+
+   //! get number of phrases reused by last synthesis
+   size_t getReusedPhraseNum() const;
+
+   //! reset numbers of phrases
+   void resetPhraseNum();
+
+private:
+   //! copy constructor (donot use)
+   SynthSessionImpl(const SynthSessionImpl&);
+
+   //! assignment operator (donot use)
+   SynthSessionImpl& operator=(const SynthSessionImpl&);
+
+   //! waveform of phrase
+   struct Entry {
+      std::vector<double> waveform; //!< waveform
+      bool used; //!< found or stored since last sweep
+   };
+
+   typedef std::map<std::string, Entry*> EntryMap;
+
+   //! waveforms (key: label of phrase)
+   EntryMap entries;
+
+   //! owner of waveforms
+   const void* owner;
+
+   //! revision of voices and parameters
+   size_t revision;
+
+   //! number of synthesized phrases
+   size_t synthesizedNum;
+
+   //! number of reused phrases
+   size_t reusedNum;
+
+   //! exact flag
+   bool exactFlag;
+};
+
+};
+
+#endif // SINSY_SYNTH_SESSION_IMPL_H_
@@ -0,0 +1,98 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_VOICE_IMPL_H_
+#define SINSY_VOICE_IMPL_H_
+
+#include <string>
+#include <vector>
+#include "Mutex.h"
+#include "HtsEngine.h"
+
+namespace sinsy
+{
+
+class VoiceImpl
+{
+public:
+   //! constructor (reference count is 1)
+   VoiceImpl();
+
+   //! load voices
+   bool load(const std::vector<std::string>& voices);
+
+   //! loaded or not
+   bool isLoaded() const;
+
+   //! get engine which owns voices (must not be used for synthesis)
+   HtsEngine& getEngine();
+
+   //! add reference
+   void addRef();
+
+   //! release reference (this object is deleted when reference count is 0)
+   void release();
+
+private:
+   //! copy constructor (donot use)
+   VoiceImpl(const VoiceImpl&);
+
+   //! assignment operator (donot use)
+   VoiceImpl& operator=(const VoiceImpl&);
+
+   //! destructor (use release())
+   virtual ~VoiceImpl();
+
+   //! mutex for reference count
+   Mutex mutex;
+
+   //! reference count
+   size_t refCount;
+
+   //! loaded or not
+   bool loaded;
+
+   //! engine which owns voices
+   HtsEngine engine;
+};
+
+};
+
+#endif // SINSY_VOICE_IMPL_H_
@@ -0,0 +1,263 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <algorithm>
+#include "WaveformBuffer.h"
+
+namespace sinsy
+{
+
+namespace
+{
+/*!
+ convert samples (double)
+ */
+inline void convert(const double* src, size_t size, double* dst)
+{
+   std::copy(src, src + size, dst);
+}
+
+/*!
+ convert samples (float)
+ */
+inline void convert(const double* src, size_t size, float* dst)
+{
+   for (size_t i(0); i < size; ++i) {
+      dst[i] = static_cast<float>(src[i]);
+   }
+}
+
+/*!
+ convert samples (16bit integer, clipped)
+ */
+inline void convert(const double* src, size_t size, short* dst)
+{
+   for (size_t i(0); i < size; ++i) {
+      const double x(src[i]);
+      dst[i] = static_cast<short>((32767.0 < x) ? 32767.0 : ((x < -32768.0) ? -32768.0 : x));
+   }
+}
+
+/*!
+ append samples to vector
+ */
+template<class T>
+void appendToVector(std::vector<T>& dst, const double* src, size_t size)
+{
+   const size_t offset(dst.size());
+   dst.resize(offset + size);
+   convert(src, size, &dst[offset]);
+}
+
+/*!
+ append samples to array
+
+ @return false if capacity is not enough (samples are stored as many as possible)
+ */
+template<class T>
+bool appendToArray(T* dst, size_t capacity, size_t& stored, const double* src, size_t size)
+{
+   bool result(true);
+   if (capacity - stored < size) {
+      size = capacity - stored;
+      result = false;
+   }
+   convert(src, size, dst + stored);
+   stored += size;
+   return result;
+}
+};
+
+/*!
+ constructor
+ */
+WaveformBuffer::WaveformBuffer() : type(TYPE_NONE), buffer(NULL), capacity(0), size(NULL)
+{
+}
+
+/*!
+ destructor
+ */
+WaveformBuffer::~WaveformBuffer()
+{
+}
+
+/*!
+ set vector of double
+ */
+void WaveformBuffer::set(std::vector<double>& waveform)
+{
+   unset();
+   type = TYPE_DOUBLE_VECTOR;
+   buffer = &waveform;
+}
+
+/*!
+ set vector of float
+ */
+void WaveformBuffer::set(std::vector<float>& waveform)
+{
+   unset();
+   type = TYPE_FLOAT_VECTOR;
+   buffer = &waveform;
+}
+
+/*!
+ set vector of 16bit integer
+ */
+void WaveformBuffer::set(std::vector<short>& waveform)
+{
+   unset();
+   type = TYPE_INT16_VECTOR;
+   buffer = &waveform;
+}
+
+/*!
+ set array of double
+ */
+void WaveformBuffer::set(double* waveform, size_t c, size_t& s)
+{
+   unset();
+   type = TYPE_DOUBLE_ARRAY;
+   buffer = waveform;
+   capacity = c;
+   size = &s;
+}
+
+/*!
+ set array of float
+ */
+void WaveformBuffer::set(float* waveform, size_t c, size_t& s)
+{
+   unset();
+   type = TYPE_FLOAT_ARRAY;
+   buffer = waveform;
+   capacity = c;
+   size = &s;
+}
+
+/*!
+ set array of 16bit integer
+ */
+void WaveformBuffer::set(short* waveform, size_t c, size_t& s)
+{
+   unset();
+   type = TYPE_INT16_ARRAY;
+   buffer = waveform;
+   capacity = c;
+   size = &s;
+}
+
+/*!
+ unset
+ */
+void WaveformBuffer::unset()
+{
+   type = TYPE_NONE;
+   buffer = NULL;
+   capacity = 0;
+   size = NULL;
+}
+
+/*!
+ buffer is set or not
+ */
+bool WaveformBuffer::isValid() const
+{
+   return (TYPE_NONE != type);
+}
+
+/*!
+ clear stored samples
+ */
+void WaveformBuffer::clear()
+{
+   switch (type) {
+   case TYPE_DOUBLE_VECTOR :
+      static_cast<std::vector<double>*>(buffer)->clear();
+      break;
+   case TYPE_FLOAT_VECTOR :
+      static_cast<std::vector<float>*>(buffer)->clear();
+      break;
+   case TYPE_INT16_VECTOR :
+      static_cast<std::vector<short>*>(buffer)->clear();
+      break;
+   case TYPE_DOUBLE_ARRAY :
+   case TYPE_FLOAT_ARRAY :
+   case TYPE_INT16_ARRAY :
+      *size = 0;
+      break;
+   default :
+      break;
+   }
+}
+
+/*!
+ append samples
+
+ @param waveform samples
+ @param s number of samples
+ @return false if capacity of array is not enough
+ */
+bool WaveformBuffer::append(const double* waveform, size_t s)
+{
+   switch (type) {
+   case TYPE_DOUBLE_VECTOR :
+      appendToVector(*static_cast<std::vector<double>*>(buffer), waveform, s);
+      break;
+   case TYPE_FLOAT_VECTOR :
+      appendToVector(*static_cast<std::vector<float>*>(buffer), waveform, s);
+      break;
+   case TYPE_INT16_VECTOR :
+      appendToVector(*static_cast<std::vector<short>*>(buffer), waveform, s);
+      break;
+   case TYPE_DOUBLE_ARRAY :
+      return appendToArray(static_cast<double*>(buffer), capacity, *size, waveform, s);
+   case TYPE_FLOAT_ARRAY :
+      return appendToArray(static_cast<float*>(buffer), capacity, *size, waveform, s);
+   case TYPE_INT16_ARRAY :
+      return appendToArray(static_cast<short*>(buffer), capacity, *size, waveform, s);
+   default :
+      break;
+   }
+   return true;
+}
+
+};  // namespace sinsy
@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_WAVEFORM_BUFFER_H_
+#define SINSY_WAVEFORM_BUFFER_H_
+
+#include <vector>
+
+namespace sinsy
+{
+
+class WaveformBuffer
+{
+public:
+   //! constructor
+   WaveformBuffer();
+
+   //! destructor
+   virtual ~WaveformBuffer();
+
+   //! set vector of double
+   void set(std::vector<double>& waveform);
+
+   //! set vector of float
+   void set(std::vector<float>& waveform);
+
+   //! set vector of 16bit integer (clipped)
+   void set(std::vector<short>& waveform);
+
+   //! set array of double (at most capacity samples are stored, number of stored samples is set to size)
+   void set(double* waveform, size_t capacity, size_t& size);
+
+   //! set array of float
+   void set(float* waveform, size_t capacity, size_t& size);
+
+   //! set array of 16bit integer (clipped)
+   void set(short* waveform, size_t capacity, size_t& size);
+
+   //! unset
+   void unset();
+
+   //! buffer is set or not
+   bool isValid() const;
+
+   //! clear stored samples
+   void clear();
+
+   //! append samples (return false if capacity of array is not enough)
+   bool append(const double* waveform, size_t size);
+
+private:
+   //! type of buffer
+   enum Type {
+      TYPE_NONE,
+      TYPE_DOUBLE_VECTOR,
+      TYPE_FLOAT_VECTOR,
+      TYPE_INT16_VECTOR,
+      TYPE_DOUBLE_ARRAY,
+      TYPE_FLOAT_ARRAY,
+      TYPE_INT16_ARRAY
+   };
+
+   //! copy constructor (donot use)
+   WaveformBuffer(const WaveformBuffer&);
+
+   //! assignment operator (donot use)
+   WaveformBuffer& operator=(const WaveformBuffer&);
+
+   //! type
+   Type type;
+
+   //! vector or array given by user
+   void* buffer;
+
+   //! capacity of array
+   size_t capacity;
+
+   //! number of stored samples in array (given by user)
+   size_t* size;
+};
+
+};
+
+#endif // SINSY_WAVEFORM_BUFFER_H_
@@ -44,10 +44,12 @@
 #include <deque>
 #include <vector>
 #include <iterator>
+#include <algorithm>
 #include "util_log.h"
 #include "util_string.h"
 #include "util_converter.h"
 #include "StringTokenizer.h"
+#include "StreamException.h"
 #include "JConf.h"
 #include "Deleter.h"
 
@@ -72,40 +74,17 @@ class PhonemeJudge
 {
 public:
    //! constructor
-   PhonemeJudge(const std::string& v, const std::string& b) {
-      {
-         StringTokenizer st(v, PHONEME_SEPARATOR);
-         size_t sz(st.size());
-         for (size_t i(0); i < sz; ++i) {
-            std::string phoneme(st.at(i));
-            cutBlanks(phoneme);
-            if (!phoneme.empty()) {
-               this->vowels.insert(phoneme);
-            }
-         }
-      }
-      {
-         StringTokenizer st(b, PHONEME_SEPARATOR);
-         size_t sz(st.size());
-         for (size_t i(0); i < sz; ++i) {
-            std::string phoneme(st.at(i));
-            cutBlanks(phoneme);
-            if (!phoneme.empty()) {
-               this->breaks.insert(phoneme);
-            }
-         }
-      }
-   }
+   PhonemeJudge(const std::vector<PhonemeSymbol>& v, const PhonemeSymbol& b) : vowels(v), breakPhoneme(b) {}
 
    //! destructor
    virtual ~PhonemeJudge() {}
 
    //! return whether vowel or not
-   const std::string& getType(const std::string& phoneme) const {
-      if (vowels.end() != vowels.find(phoneme)) {
+   const PhonemeSymbol& getType(const PhonemeSymbol& phoneme) const {
+      if (vowels.end() != std::find(vowels.begin(), vowels.end(), phoneme)) {
          return PhonemeInfo::TYPE_VOWEL;
       }
-      if (breaks.end() != breaks.find(phoneme)) {
+      if (!breakPhoneme.empty() && (breakPhoneme == phoneme)) {
          return PhonemeInfo::TYPE_BREAK;
       }
       return PhonemeInfo::TYPE_CONSONANT;
@@ -118,18 +97,18 @@ private:
    //! assignment operator (donot use)
    PhonemeJudge& operator=(const PhonemeJudge&);
 
-   //! vowels
-   std::set<std::string> vowels;
+   //! vowels (a few symbols, so they are searched linearly)
+   const std::vector<PhonemeSymbol>& vowels;
 
-   //! breaks such as /cl/
-   std::set<std::string> breaks;
+   //! break such as /cl/
+   const PhonemeSymbol breakPhoneme;
 };
 
 class InfoAdder
 {
 public:
    //! constructor
-   InfoAdder(sinsy::IConvertable& c, const std::string& cl, const PhonemeJudge& pj) :
+   InfoAdder(sinsy::IConvertable& c, const PhonemeSymbol& cl, const PhonemeJudge& pj) :
       convertable(c), clPhoneme(cl), phonemeJudge(pj), waiting(false), vowelReductionIdx(INVALID_IDX), scoreFlag(0), macronFlag(false) {
    }
 
@@ -245,7 +224,7 @@ private:
       // add
       {
          std::string info = (macronFlag) ? "1" : "0";
-         std::string lastPhoneme;
+         PhonemeSymbol lastPhoneme;
          std::vector<PhonemeTable::PhonemeList*>::iterator itr(ptrList.begin());
          const std::vector<PhonemeTable::PhonemeList*>::iterator itrEnd(ptrList.end());
          for (; itrEnd != itr; ++itr) {
@@ -264,16 +243,16 @@ private:
 
             std::vector<PhonemeInfo> phonemeInfos;
             phonemeInfos.reserve(phonemes.size());
-            const std::vector<std::string>::const_iterator iEnd(phonemes.end());
-            for (std::vector<std::string>::const_iterator i(phonemes.begin()); iEnd != i; ++i) {
-               const std::string& type(phonemeJudge.getType(*i));
+            const PhonemeTable::PhonemeList::const_iterator iEnd(phonemes.end());
+            for (PhonemeTable::PhonemeList::const_iterator i(phonemes.begin()); iEnd != i; ++i) {
+               const PhonemeSymbol& type(phonemeJudge.getType(*i));
                phonemeInfos.push_back(PhonemeInfo(type, *i, scoreFlag));
             }
             convertable.addInfo(phonemeInfos, LANGUAGE_INFO, info);
             if (PhonemeInfo::TYPE_VOWEL == phonemeJudge.getType(phonemes.back())) {
                lastPhoneme = phonemes.back();
             } else {
-               lastPhoneme.clear();
+               lastPhoneme = PhonemeSymbol();
             }
          }
       }
@@ -287,7 +266,7 @@ private:
    sinsy::IConvertable& convertable;
 
    //! phoneme of cl
-   const std::string clPhoneme;
+   const PhonemeSymbol clPhoneme;
 
    //! phoneme type judge
    const PhonemeJudge& phonemeJudge;
@@ -375,7 +354,7 @@ bool setMultibyteCharRange(MultibyteCharRange& mRange, const std::string& str)
 /*!
  expand prevInfoAdder to infoAdder
  */
-bool expand(InfoAdder& prevInfoAdder, InfoAdder& infoAdder, const MacronTable& macronTable, const std::string& clSymbol)
+bool expand(InfoAdder& prevInfoAdder, InfoAdder& infoAdder, const MacronTable& macronTable, const PhonemeSymbol& clSymbol)
 {
    if (NULL != infoAdder.getLastPhonemes()) { // fail safe
       ERR_MSG("Dst InfoAdder is not empty (Source code is wrong)");
@@ -465,6 +444,82 @@ bool JConf::read(const std::string& table, const std::string& conf, const std::s
       return false;
    }
 
+   return setUp();
+}
+
+/*!
+ read phoneme table and config from sections of dictionary image
+
+ @param image  dictionary image
+ @param table  name of section of phoneme table
+ @param conf   name of section of config
+ @param macron name of section of macron table
+ @return       true if success
+ */
+bool JConf::read(const DicImage& image, const std::string& table, const std::string& conf, const std::string& macron)
+{
+   const std::string names[] = {table, conf, macron};
+   const char* data[3];
+   size_t size[3];
+   for (size_t i(0); i < 3; ++i) {
+      if (!image.findSection(names[i], data[i], size[i])) {
+         ERR_MSG("Cannot find section in dictionary image : " << names[i]);
+         return false;
+      }
+   }
+
+   try {
+      DicImage::Reader tableReader(data[0], size[0]);
+      phonemeTable.read(tableReader);
+      DicImage::Reader confReader(data[1], size[1]);
+      config.read(confReader);
+      DicImage::Reader macronReader(data[2], size[2]);
+      macronTable.read(macronReader);
+   } catch (const StreamException& ex) {
+      ERR_MSG("Broken dictionary image : " << ex.what());
+      phonemeTable.clear();
+      config.clear();
+      macronTable.clear();
+      return false;
+   }
+
+   return setUp();
+}
+
+/*!
+ write phoneme table and config to dictionary image
+ */
+void JConf::write(DicImage::Writer& table, DicImage::Writer& conf, DicImage::Writer& macron) const
+{
+   phonemeTable.write(table);
+   config.write(conf);
+   macronTable.write(macron);
+}
+
+/*!
+ @internal
+
+ set up after reading
+ */
+bool JConf::setUp()
+{
+   // register phonemes of cl and vowels to symbol table
+   clPhoneme = PhonemeSymbol(config.get(PHONEME_CL));
+   vowels.clear();
+   std::string strVowels(config.get(VOWELS));
+   if (strVowels.empty()) {
+      strVowels = DEFAULT_VOWELS;
+   }
+   StringTokenizer st(strVowels, PHONEME_SEPARATOR);
+   const size_t sz(st.size());
+   for (size_t i(0); i < sz; ++i) {
+      std::string phoneme(st.at(i));
+      cutBlanks(phoneme);
+      if (!phoneme.empty()) {
+         vowels.push_back(PhonemeSymbol(phoneme));
+      }
+   }
+
    // set multibyte char ranges
    std::string strCharRange(config.get(MULTIBYTE_CHAR_RANGE));
    if (!setMultibyteCharRange(multibyteCharRange, strCharRange)) {
@@ -486,13 +541,8 @@ bool JConf::convert(const std::string& enc, ConvertableList::iterator begin, Con
    }
 
    const std::string macronSymbol(config.get(MACRON));
-   const std::string clSymbol(config.get(PHONEME_CL));
+   const PhonemeSymbol& clSymbol(clPhoneme);
    const std::string vowelReductionSymbol(config.get(VOWEL_REDUCTION));
-   std::string vowels(config.get(VOWELS));
-
-   if (vowels.empty()) {
-      vowels = DEFAULT_VOWELS;
-   }
 
    PhonemeJudge phonemeJudge(vowels, clSymbol);
 
@@ -44,11 +44,13 @@
 
 #include <string>
 #include <set>
+#include <vector>
 #include "IConf.h"
 #include "Configurations.h"
 #include "PhonemeTable.h"
 #include "MacronTable.h"
 #include "MultibyteCharRange.h"
+#include "DicImage.h"
 
 namespace sinsy
 {
@@ -65,6 +67,12 @@ public:
    //! read phoneme table and config from files
    bool read(const std::string& table, const std::string& conf, const std::string& macron);
 
+   //! read phoneme table and config from sections of dictionary image (image must outlive this conf)
+   bool read(const DicImage& image, const std::string& table, const std::string& conf, const std::string& macron);
+
+   //! write phoneme table and config to dictionary image
+   void write(DicImage::Writer& table, DicImage::Writer& conf, DicImage::Writer& macron) const;
+
    //! convert lyrics to phonemes
    virtual bool convert(const std::string& enc, ConvertableList::iterator begin, ConvertableList::iterator end) const;
 
@@ -84,6 +92,9 @@ private:
    //! assignment operator (donot use)
    JConf& operator=(const JConf&);
 
+   //! set up after reading
+   bool setUp();
+
    //! phoneme table
    PhonemeTable phonemeTable;
 
@@ -96,6 +107,12 @@ private:
    //! ranges of multibyte chars
    MultibyteCharRange multibyteCharRange;
 
+   //! phoneme of double consonant (cl)
+   PhonemeSymbol clPhoneme;
+
+   //! vowels
+   std::vector<PhonemeSymbol> vowels;
+
    typedef std::set<std::string> Encodings;
 
    //! encoding
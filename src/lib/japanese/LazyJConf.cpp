@@ -0,0 +1,153 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <fstream>
+#include "util_log.h"
+#include "LazyJConf.h"
+
+namespace sinsy
+{
+
+namespace
+{
+/*!
+ file exists or not
+ */
+bool existsFile(const std::string& path)
+{
+   std::ifstream ifs(path.c_str());
+   return ifs.is_open();
+}
+};
+
+/*!
+ constructor
+
+ @param enc    encodings
+ @param table  path of phoneme table
+ @param conf   path of config
+ @param macron path of macron table
+ @param image  dictionary image (if not NULL, other paths are names of sections in it)
+ */
+LazyJConf::LazyJConf(const std::string& enc, const std::string& table, const std::string& conf, const std::string& macron, const DicImage* image)
+   : jConf(enc), tablePath(table), confPath(conf), macronPath(macron), dicImage(image), loaded(false), failed(false)
+{
+}
+
+/*!
+ destructor
+ */
+LazyJConf::~LazyJConf()
+{
+}
+
+/*!
+ check that files (or sections of dictionary image) exist
+
+ Errors in files are found when they are read.
+ */
+bool LazyJConf::check() const
+{
+   if (NULL != dicImage) {
+      const char* data(NULL);
+      size_t size(0);
+      if (!dicImage->findSection(tablePath, data, size) || !dicImage->findSection(confPath, data, size) || !dicImage->findSection(macronPath, data, size)) {
+         ERR_MSG("Cannot find Japanese table or config or macron in dictionary image : " << tablePath << ", " << confPath << ", " << macronPath);
+         return false;
+      }
+      return true;
+   }
+   if (!existsFile(tablePath) || !existsFile(confPath) || !existsFile(macronPath)) {
+      ERR_MSG("Cannot find Japanese table or config or macron file : " << tablePath << ", " << confPath << ", " << macronPath);
+      return false;
+   }
+   return true;
+}
+
+/*!
+ read files now if they have not been read yet
+
+ Reading files is serialized, so this can be called from several threads.
+ After the first call, this only reads flags without locking.
+ */
+bool LazyJConf::load() const
+{
+   if (!tried.isSet()) {
+      MutexLock lock(mutex);
+      if (!loaded && !failed) {
+         const bool result((NULL != dicImage) ? jConf.read(*dicImage, tablePath, confPath, macronPath) : jConf.read(tablePath, confPath, macronPath));
+         if (result) {
+            loaded = true;
+         } else {
+            ERR_MSG("Cannot read Japanese table or config or macron file : " << tablePath << ", " << confPath);
+            failed = true;
+         }
+         tried.set();
+      }
+   }
+   return loaded;
+}
+
+/*!
+ convert lyrics to phonemes
+
+ Files are read when lyrics in the encoding of this conf are converted for the first time.
+ */
+bool LazyJConf::convert(const std::string& enc, ConvertableList::iterator begin, ConvertableList::iterator end) const
+{
+   // check encoding (files are not needed)
+   if (!jConf.checkEncoding(enc)) {
+      return true; // no relation
+   }
+   if (!load()) {
+      return true; // lyrics are left to other confs
+   }
+   return jConf.convert(enc, begin, end);
+}
+
+/*!
+ get sil str
+ */
+std::string LazyJConf::getSilStr() const
+{
+   return jConf.getSilStr();
+}
+
+};  // namespace sinsy
@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_LAZY_J_CONF_H_
+#define SINSY_LAZY_J_CONF_H_
+
+#include <string>
+#include "IConf.h"
+#include "JConf.h"
+#include "Mutex.h"
+#include "DicImage.h"
+
+namespace sinsy
+{
+
+/*!
+ Japanese conf whose files are read on first use for its encoding
+
+ All methods can be called from several threads at the same time.
+ Only the first use locks, and conf is not changed after it has been read.
+
+ If dictionary image is given, names of sections in the image are used instead of paths of files.
+ */
+class LazyJConf : public IConf
+{
+public:
+   //! constructor
+   LazyJConf(const std::string& enc, const std::string& table, const std::string& conf, const std::string& macron, const DicImage* image = NULL);
+
+   //! destructor
+   virtual ~LazyJConf();
+
+   //! check that files or sections exist (they are not read)
+   bool check() const;
+
+   //! read files now if they have not been read yet
+   bool load() const;
+
+   //! convert lyrics to phonemes
+   virtual bool convert(const std::string& enc, ConvertableList::iterator begin, ConvertableList::iterator end) const;
+
+   //! get sil str
+   virtual std::string getSilStr() const;
+
+private:
+   //! copy constructor (donot use)
+   LazyJConf(const LazyJConf&);
+
+   //! assignment operator (donot use)
+   LazyJConf& operator=(const LazyJConf&);
+
+   //! Japanese conf
+   mutable JConf jConf;
+
+   //! path of phoneme table
+   const std::string tablePath;
+
+   //! path of config
+   const std::string confPath;
+
+   //! path of macron table
+   const std::string macronPath;
+
+   //! dictionary image (not owned)
+   const DicImage* dicImage;
+
+   //! mutex for loading
+   mutable Mutex mutex;
+
+   //! files have been read or not
+   mutable bool loaded;
+
+   //! reading files has been tried or not (loaded and failed are not changed after this is set)
+   mutable OnceFlag tried;
+
+   //! reading files failed or not (files are not read again)
+   mutable bool failed;
+};
+
+};
+
+#endif // SINSY_LAZY_J_CONF_H_
@@ -42,6 +42,10 @@
 #ifndef SINSY_I_PHONEME_LABEL_H_
 #define SINSY_I_PHONEME_LABEL_H_
 
+#include <string>
+#include "util_converter.h"
+#include "PhonemeSymbol.h"
+
 namespace sinsy
 {
 
@@ -52,13 +56,13 @@ public:
    virtual ~IPhonemeLabel() {}
 
    //! set type
-   virtual void setType(const std::string& value) = 0;
+   virtual void setType(const PhonemeSymbol& value) = 0;
 
    //! set name
-   virtual void setName(const std::string& name) = 0;
+   virtual void setName(const PhonemeSymbol& name) = 0;
 
    //! set flag
-   virtual void setFlag(const std::string& flag) = 0;
+   virtual void setFlag(ScoreFlag flag) = 0;
 
    //! set position in syllable
    virtual void setPositionInSyllable(size_t idx, size_t max) = 0;
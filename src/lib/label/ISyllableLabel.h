@@ -62,10 +62,10 @@ public:
    virtual void setPositionInNote(size_t idx, size_t max) = 0;
 
    //! set language
-   virtual void setLanguage(const std::string& language) = 0;
+   virtual void setLanguage(const PhonemeSymbol& language) = 0;
 
    //! set language-dependent infomation
-   virtual void setLangDependentInfo(const std::string& info) = 0;
+   virtual void setLangDependentInfo(const PhonemeSymbol& info) = 0;
 };
 
 };
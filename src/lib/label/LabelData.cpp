@@ -39,6 +39,7 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
+#include <stdexcept>
 #include "util_log.h"
 #include "LabelData.h"
 
@@ -46,37 +47,98 @@ namespace sinsy
 {
 const INT64 LabelData::INVALID_TIME = -1;
 
+const size_t LabelData::NUM_P;
+const size_t LabelData::NUM_A;
+const size_t LabelData::NUM_B;
+const size_t LabelData::NUM_C;
+const size_t LabelData::NUM_D;
+const size_t LabelData::NUM_E;
+const size_t LabelData::NUM_F;
+const size_t LabelData::NUM_G;
+const size_t LabelData::NUM_H;
+const size_t LabelData::NUM_I;
+const size_t LabelData::NUM_J;
+const size_t LabelData::NUM_FIELDS;
+
 namespace
 {
-const size_t NUM_P = 16;
-const size_t NUM_A = 5;
-const size_t NUM_B = 5;
-const size_t NUM_C = 5;
-const size_t NUM_D = 9;
-const size_t NUM_E = 60;
-const size_t NUM_F = 9;
-const size_t NUM_G = 2;
-const size_t NUM_H = 2;
-const size_t NUM_I = 2;
-const size_t NUM_J = 3;
-const char* SEPARATOR_P[NUM_P] = {"", "@", "^", "-", "+", "=", "_", "%", "^", "_", "~", "-", "!", "[", "$", "]"};
-const char* SEPARATOR_A[NUM_A] = {"/A:", "-", "-", "@", "~"};
-const char* SEPARATOR_B[NUM_B] = {"/B:", "_", "_", "@", "|"};
-const char* SEPARATOR_C[NUM_C] = {"/C:", "+", "+", "@", "&"};
-const char* SEPARATOR_D[NUM_D] = {"/D:", "!", "#", "$", "%", "|", "&", ";", "-"};
-const char* SEPARATOR_E[NUM_E] = {
-   "/E:", "]", "^", "=", "~", "!", "@", "#", "+", "]",
-   "$", "|", "[", "&", "]", "=", "^", "~", "#", "_",
-   ";", "$", "&", "%", "[", "|", "]", "-", "^", "+",
-   "~", "=", "@", "$", "!", "%", "#", "|", "|", "-",
-   "&", "&", "+", "[", ";", "]", ";", "~", "~", "^",
-   "^", "@", "[", "#", "=", "!", "~", "+", "!", "^"
+const size_t OFFSET_P = 0;
+const size_t OFFSET_A = OFFSET_P + LabelData::NUM_P;
+const size_t OFFSET_B = OFFSET_A + LabelData::NUM_A;
+const size_t OFFSET_C = OFFSET_B + LabelData::NUM_B;
+const size_t OFFSET_D = OFFSET_C + LabelData::NUM_C;
+const size_t OFFSET_E = OFFSET_D + LabelData::NUM_D;
+const size_t OFFSET_F = OFFSET_E + LabelData::NUM_E;
+const size_t OFFSET_G = OFFSET_F + LabelData::NUM_F;
+const size_t OFFSET_H = OFFSET_G + LabelData::NUM_G;
+const size_t OFFSET_I = OFFSET_H + LabelData::NUM_H;
+const size_t OFFSET_J = OFFSET_I + LabelData::NUM_I;
+const char* UNSET_STR = "xx";
+const char* HEX_DIGITS = "0123456789abcdef";
+
+//! separator of label
+struct Separator {
+   const char* str; //!< string
+   size_t size; //!< length of string
 };
-const char* SEPARATOR_F[NUM_F] = {"/F:", "#", "#", "-", "$", "$", "+", "%", ";"};
-const char* SEPARATOR_G[NUM_G] = {"/G:", "_"};
-const char* SEPARATOR_H[NUM_H] = {"/H:", "_"};
-const char* SEPARATOR_I[NUM_I] = {"/I:", "_"};
-const char* SEPARATOR_J[NUM_J] = {"/J:", "~", "@"};
+
+//! separators of all fields (p, a, b, c, d, e, f, g, h, i, j)
+const Separator SEPARATORS[LabelData::NUM_FIELDS] = {
+   // p
+   {"", 0}, {"@", 1}, {"^", 1}, {"-", 1}, {"+", 1}, {"=", 1}, {"_", 1}, {"%", 1}, {"^", 1}, {"_", 1}, {"~", 1}, {"-", 1}, {"!", 1}, {"[", 1}, {"$", 1}, {"]", 1},
+   // a
+   {"/A:", 3}, {"-", 1}, {"-", 1}, {"@", 1}, {"~", 1},
+   // b
+   {"/B:", 3}, {"_", 1}, {"_", 1}, {"@", 1}, {"|", 1},
+   // c
+   {"/C:", 3}, {"+", 1}, {"+", 1}, {"@", 1}, {"&", 1},
+   // d
+   {"/D:", 3}, {"!", 1}, {"#", 1}, {"$", 1}, {"%", 1}, {"|", 1}, {"&", 1}, {";", 1}, {"-", 1},
+   // e
+   {"/E:", 3}, {"]", 1}, {"^", 1}, {"=", 1}, {"~", 1}, {"!", 1}, {"@", 1}, {"#", 1}, {"+", 1}, {"]", 1},
+   {"$", 1}, {"|", 1}, {"[", 1}, {"&", 1}, {"]", 1}, {"=", 1}, {"^", 1}, {"~", 1}, {"#", 1}, {"_", 1},
+   {";", 1}, {"$", 1}, {"&", 1}, {"%", 1}, {"[", 1}, {"|", 1}, {"]", 1}, {"-", 1}, {"^", 1}, {"+", 1},
+   {"~", 1}, {"=", 1}, {"@", 1}, {"$", 1}, {"!", 1}, {"%", 1}, {"#", 1}, {"|", 1}, {"|", 1}, {"-", 1},
+   {"&", 1}, {"&", 1}, {"+", 1}, {"[", 1}, {";", 1}, {"]", 1}, {";", 1}, {"~", 1}, {"~", 1}, {"^", 1},
+   {"^", 1}, {"@", 1}, {"[", 1}, {"#", 1}, {"=", 1}, {"!", 1}, {"~", 1}, {"+", 1}, {"!", 1}, {"^", 1},
+   // f
+   {"/F:", 3}, {"#", 1}, {"#", 1}, {"-", 1}, {"$", 1}, {"$", 1}, {"+", 1}, {"%", 1}, {";", 1},
+   // g
+   {"/G:", 3}, {"_", 1},
+   // h
+   {"/H:", 3}, {"_", 1},
+   // i
+   {"/I:", 3}, {"_", 1},
+   // j
+   {"/J:", 3}, {"~", 1}, {"@", 1}
+};
+
+/*!
+ append unsigned number to buffer
+ */
+void appendNumber(std::string& buffer, UINT64 value)
+{
+   char digits[24];
+   char* ptr(digits + sizeof(digits));
+   do {
+      *--ptr = static_cast<char>('0' + (value % 10));
+      value /= 10;
+   } while (0 != value);
+   buffer.append(ptr, digits + sizeof(digits) - ptr);
+}
+
+/*!
+ append signed number to buffer
+ */
+void appendSignedNumber(std::string& buffer, INT64 value)
+{
+   if (value < 0) {
+      buffer += '-';
+      appendNumber(buffer, static_cast<UINT64>(0) - static_cast<UINT64>(value));
+   } else {
+      appendNumber(buffer, static_cast<UINT64>(value));
+   }
+}
 };
 
 /*!
@@ -84,46 +146,13 @@ const char* SEPARATOR_J[NUM_J] = {"/J:", "~", "@"};
  */
 LabelData::LabelData() : monophoneFlag(false), outputTimeFlag(true), beginTime(INVALID_TIME), endTime(INVALID_TIME)
 {
-   List *p(NULL), *a(NULL), *b(NULL), *c(NULL), *d(NULL), *e(NULL), *f(NULL), *g(NULL), *h(NULL), *i(NULL), *j(NULL);
-
-   try {
-      p = new List(NUM_P, "xx");
-      a = new List(NUM_A, "xx");
-      b = new List(NUM_B, "xx");
-      c = new List(NUM_C, "xx");
-      d = new List(NUM_D, "xx");
-      e = new List(NUM_E, "xx");
-      f = new List(NUM_F, "xx");
-      g = new List(NUM_G, "xx");
-      h = new List(NUM_H, "xx");
-      i = new List(NUM_I, "xx");
-      j = new List(NUM_J, "xx");
-   } catch (const std::bad_alloc&) {
-      delete p;
-      delete a;
-      delete b;
-      delete c;
-      delete d;
-      delete e;
-      delete f;
-      delete g;
-      delete h;
-      delete i;
-      delete j;
-      ERR_MSG("Cannot allocate memory");
+   for (size_t idx(0); idx < NUM_FIELDS; ++idx) {
+      fields[idx].type = FIELD_UNSET;
+      fields[idx].str = NULL;
+      fields[idx].number = 0;
+      fields[idx].subNumber = 0;
+      fields[idx].signedNumber = 0;
    }
-
-   data.insert(std::make_pair('p', p));
-   data.insert(std::make_pair('a', a));
-   data.insert(std::make_pair('b', b));
-   data.insert(std::make_pair('c', c));
-   data.insert(std::make_pair('d', d));
-   data.insert(std::make_pair('e', e));
-   data.insert(std::make_pair('f', f));
-   data.insert(std::make_pair('g', g));
-   data.insert(std::make_pair('h', h));
-   data.insert(std::make_pair('i', i));
-   data.insert(std::make_pair('j', j));
 }
 
 /*!
@@ -131,11 +160,6 @@ LabelData::LabelData() : monophoneFlag(false), outputTimeFlag(true), beginTime(I
  */
 LabelData::~LabelData()
 {
-   Data::iterator itr(data.begin());
-   Data::iterator itrEnd(data.end());
-   for (; itr != itrEnd; ++itr) {
-      delete itr->second;
-   }
 }
 
 /*!
@@ -171,162 +195,256 @@ void LabelData::setEndTime(double d)
 }
 
 /*!
- get data
+ set number
  */
-const std::string& LabelData::get(char category, size_t number) const
+void LabelData::set(char category, size_t number, size_t value)
 {
-   Data::const_iterator itr(data.find(category));
-   if (data.end() == itr) {
-      throw std::runtime_error("LabelData::get() unknown category");
-   }
-   const List* list(itr->second);
-   if ((0 == number) || (list->size() < number)) {
-      throw std::runtime_error("LabelData::get() number is out of range");
-   }
-   return list->at(number - 1);
+   Field& field(getField(category, number));
+   field.type = FIELD_NUMBER;
+   field.number = value;
 }
 
 /*!
- set data (std::string)
+ set boolean value
  */
-template<>
-void LabelData::set<std::string>(char category, size_t number, const std::string& value)
+void LabelData::set(char category, size_t number, bool value)
 {
-   Data::iterator itr(data.find(category));
-   if (data.end() == itr) {
-      throw std::runtime_error("LabelData::set() unknown category");
-   }
-   List* list(itr->second);
-   if ((0 == number) || (list->size() < number)) {
-      throw std::runtime_error("LabelData::set() number is out of range");
-   }
-   list->at(number - 1) = value;
+   Field& field(getField(category, number));
+   field.type = FIELD_BOOL;
+   field.number = value ? 1 : 0;
 }
 
 /*!
- set data (bool)
+ set phoneme symbol
+
+ String of symbol is registered in symbol table forever, so it can be referred without copy.
  */
-template<>
-void LabelData::set<bool>(char category, size_t number, const bool& value)
+void LabelData::set(char category, size_t number, const PhonemeSymbol& value)
 {
-   set(category, number, std::string(value ? "1" : "0"));
+   Field& field(getField(category, number));
+   field.type = FIELD_STRING;
+   field.str = &value.getString();
 }
 
 /*!
- to stream
+ set pitch
  */
-std::ostream& operator<<(std::ostream& os, const LabelData& obj)
+void LabelData::set(char category, size_t number, const Pitch& value)
 {
-   if (obj.outputTimeFlag) {
-      os << obj.beginTime << " " << obj.endTime << " ";
-   }
+   Field& field(getField(category, number));
+   field.type = FIELD_PITCH;
+   field.str = &value.getStepStr();
+   field.signedNumber = value.getOctave();
+}
 
-   LabelData::Data::const_iterator itrP(obj.data.find('p'));
-   if (obj.data.end() == itrP)
-      throw std::runtime_error("LabelData::operator<<() p is not found");
-   LabelData::List& p = *(itrP->second);
-   LabelData::Data::const_iterator itrA(obj.data.find('a'));
-   if (obj.data.end() == itrA)
-      throw std::runtime_error("LabelData::operator<<() a is not found");
-   LabelData::List& a = *(itrA->second);
-   LabelData::Data::const_iterator itrB(obj.data.find('b'));
-   if (obj.data.end() == itrB)
-      throw std::runtime_error("LabelData::operator<<() b is not found");
-   LabelData::List& b = *(itrB->second);
-   LabelData::Data::const_iterator itrC(obj.data.find('c'));
-   if (obj.data.end() == itrC)
-      throw std::runtime_error("LabelData::operator<<() c is not found");
-   LabelData::List& c = *(itrC->second);
-   LabelData::Data::const_iterator itrD(obj.data.find('d'));
-   if (obj.data.end() == itrD)
-      throw std::runtime_error("LabelData::operator<<() d is not found");
-   LabelData::List& d = *(itrD->second);
-   LabelData::Data::const_iterator itrE(obj.data.find('e'));
-   if (obj.data.end() == itrE)
-      throw std::runtime_error("LabelData::operator<<() e is not found");
-   LabelData::List& e = *(itrE->second);
-   LabelData::Data::const_iterator itrF(obj.data.find('f'));
-   if (obj.data.end() == itrF)
-      throw std::runtime_error("LabelData::operator<<() f is not found");
-   LabelData::List& f = *(itrF->second);
-   LabelData::Data::const_iterator itrG(obj.data.find('g'));
-   if (obj.data.end() == itrG)
-      throw std::runtime_error("LabelData::operator<<() g is not found");
-   LabelData::List& g = *(itrG->second);
-   LabelData::Data::const_iterator itrH(obj.data.find('h'));
-   if (obj.data.end() == itrH)
-      throw std::runtime_error("LabelData::operator<<() h is not found");
-   LabelData::List& h = *(itrH->second);
-   LabelData::Data::const_iterator itrI(obj.data.find('i'));
-   if (obj.data.end() == itrI)
-      throw std::runtime_error("LabelData::operator<<() i is not found");
-   LabelData::List& i = *(itrI->second);
-   LabelData::Data::const_iterator itrJ(obj.data.find('j'));
-   if (obj.data.end() == itrJ)
-      throw std::runtime_error("LabelData::operator<<() j is not found");
-   LabelData::List& j = *(itrJ->second);
-
-   if (obj.monophoneFlag) {
-      os << p[3];
-      return os;
-   }
+/*!
+ set beat
+ */
+void LabelData::set(char category, size_t number, const Beat& value)
+{
+   Field& field(getField(category, number));
+   field.type = FIELD_BEAT;
+   field.number = value.getBeats();
+   field.subNumber = value.getBeatType();
+}
 
-   // p
-   for (size_t idx(0); idx < NUM_P; ++idx) {
-      os << SEPARATOR_P[idx] << p[idx];
-   }
+/*!
+ set dynamics
+ */
+void LabelData::set(char category, size_t number, const Dynamics& value)
+{
+   Field& field(getField(category, number));
+   field.type = FIELD_STRING;
+   field.str = &value.getStr();
+}
 
-   // a
-   for (size_t idx(0); idx < NUM_A; ++idx) {
-      os << SEPARATOR_A[idx] << a[idx];
-   }
+/*!
+ set difference
+ */
+void LabelData::setDifference(char category, size_t number, int value)
+{
+   Field& field(getField(category, number));
+   field.type = FIELD_DIFFERENCE;
+   field.signedNumber = value;
+}
 
-   // b
-   for (size_t idx(0); idx < NUM_B; ++idx) {
-      os << SEPARATOR_B[idx] << b[idx];
-   }
+/*!
+ set score flag
+ */
+void LabelData::setScoreFlag(char category, size_t number, ScoreFlag value)
+{
+   Field& field(getField(category, number));
+   field.type = FIELD_SCORE_FLAG;
+   field.number = value;
+}
 
-   // c
-   for (size_t idx(0); idx < NUM_C; ++idx) {
-      os << SEPARATOR_C[idx] << c[idx];
-   }
+/*!
+ unset field
+ */
+void LabelData::unset(char category, size_t number)
+{
+   getField(category, number).type = FIELD_UNSET;
+}
 
-   // d
-   for (size_t idx(0); idx < NUM_D; ++idx) {
-      os << SEPARATOR_D[idx] << d[idx];
-   }
+/*!
+ get data
+ */
+std::string LabelData::get(char category, size_t number) const
+{
+   std::string buffer;
+   writeField(buffer, getField(category, number));
+   return buffer;
+}
 
-   // e
-   for (size_t idx(0); idx < NUM_E; ++idx) {
-      os << SEPARATOR_E[idx] << e[idx];
-   }
+/*!
+ @internal
 
-   // f
-   for (size_t idx(0); idx < NUM_F; ++idx) {
-      os << SEPARATOR_F[idx] << f[idx];
+ get field
+ */
+LabelData::Field& LabelData::getField(char category, size_t number)
+{
+   return const_cast<Field&>(static_cast<const LabelData*>(this)->getField(category, number));
+}
+
+/*!
+ @internal
+
+ get field
+ */
+const LabelData::Field& LabelData::getField(char category, size_t number) const
+{
+   size_t offset(0);
+   size_t size(0);
+   switch (category) {
+   case 'p' :
+      offset = OFFSET_P;
+      size = NUM_P;
+      break;
+   case 'a' :
+      offset = OFFSET_A;
+      size = NUM_A;
+      break;
+   case 'b' :
+      offset = OFFSET_B;
+      size = NUM_B;
+      break;
+   case 'c' :
+      offset = OFFSET_C;
+      size = NUM_C;
+      break;
+   case 'd' :
+      offset = OFFSET_D;
+      size = NUM_D;
+      break;
+   case 'e' :
+      offset = OFFSET_E;
+      size = NUM_E;
+      break;
+   case 'f' :
+      offset = OFFSET_F;
+      size = NUM_F;
+      break;
+   case 'g' :
+      offset = OFFSET_G;
+      size = NUM_G;
+      break;
+   case 'h' :
+      offset = OFFSET_H;
+      size = NUM_H;
+      break;
+   case 'i' :
+      offset = OFFSET_I;
+      size = NUM_I;
+      break;
+   case 'j' :
+      offset = OFFSET_J;
+      size = NUM_J;
+      break;
+   default :
+      throw std::runtime_error("LabelData::getField() unknown category");
+   }
+   if ((0 == number) || (size < number)) {
+      throw std::runtime_error("LabelData::getField() number is out of range");
    }
+   return fields[offset + number - 1];
+}
 
-   // g
-   for (size_t idx(0); idx < NUM_G; ++idx) {
-      os << SEPARATOR_G[idx] << g[idx];
+/*!
+ @internal
+
+ append field to buffer
+ */
+void LabelData::writeField(std::string& buffer, const Field& field)
+{
+   switch (field.type) {
+   case FIELD_NUMBER :
+      appendNumber(buffer, field.number);
+      break;
+   case FIELD_BOOL :
+      buffer += ((0 != field.number) ? '1' : '0');
+      break;
+   case FIELD_STRING :
+      buffer += *field.str;
+      break;
+   case FIELD_PITCH :
+      buffer += *field.str;
+      appendSignedNumber(buffer, field.signedNumber);
+      break;
+   case FIELD_BEAT :
+      appendNumber(buffer, field.number);
+      buffer += '/';
+      appendNumber(buffer, field.subNumber);
+      break;
+   case FIELD_DIFFERENCE :
+      if (field.signedNumber < 0) {
+         buffer += 'm';
+         appendNumber(buffer, static_cast<UINT64>(-static_cast<INT64>(field.signedNumber)));
+      } else {
+         buffer += 'p';
+         appendNumber(buffer, static_cast<UINT64>(field.signedNumber));
+      }
+      break;
+   case FIELD_SCORE_FLAG :
+      buffer += HEX_DIGITS[(field.number >> 4) & 0x0f];
+      buffer += HEX_DIGITS[field.number & 0x0f];
+      break;
+   default :
+      buffer += UNSET_STR;
+      break;
    }
+}
 
-   // h
-   for (size_t idx(0); idx < NUM_H; ++idx) {
-      os << SEPARATOR_H[idx] << h[idx];
+/*!
+ write label to buffer (appended)
+ */
+void LabelData::write(std::string& buffer) const
+{
+   if (outputTimeFlag) {
+      appendSignedNumber(buffer, beginTime);
+      buffer += ' ';
+      appendSignedNumber(buffer, endTime);
+      buffer += ' ';
    }
 
-   // i
-   for (size_t idx(0); idx < NUM_I; ++idx) {
-      os << SEPARATOR_I[idx] << i[idx];
+   if (monophoneFlag) {
+      writeField(buffer, fields[OFFSET_P + 3]);
+      return;
    }
 
-   // j
-   for (size_t idx(0); idx < NUM_J; ++idx) {
-      os << SEPARATOR_J[idx] << j[idx];
+   for (size_t idx(0); idx < NUM_FIELDS; ++idx) {
+      buffer.append(SEPARATORS[idx].str, SEPARATORS[idx].size);
+      writeField(buffer, fields[idx]);
    }
+}
 
-   return os;
+/*!
+ to stream
+ */
+std::ostream& operator<<(std::ostream& os, const LabelData& obj)
+{
+   std::string buffer;
+   obj.write(buffer);
+   return os << buffer;
 }
 
 };  // namespace sinsy
@@ -43,11 +43,13 @@
 #define SINSY_LABEL_DATA_H_
 
 #include <string>
-#include <vector>
-#include <map>
-#include <sstream>
-#include <stdexcept>
+#include <ostream>
 #include "util_types.h"
+#include "util_converter.h"
+#include "Pitch.h"
+#include "Beat.h"
+#include "Dynamics.h"
+#include "PhonemeSymbol.h"
 
 namespace sinsy
 {
@@ -57,6 +59,21 @@ class LabelData
 public:
    static const INT64 INVALID_TIME;
 
+   static const size_t NUM_P = 16; //!< number of p fields
+   static const size_t NUM_A = 5; //!< number of a fields
+   static const size_t NUM_B = 5; //!< number of b fields
+   static const size_t NUM_C = 5; //!< number of c fields
+   static const size_t NUM_D = 9; //!< number of d fields
+   static const size_t NUM_E = 60; //!< number of e fields
+   static const size_t NUM_F = 9; //!< number of f fields
+   static const size_t NUM_G = 2; //!< number of g fields
+   static const size_t NUM_H = 2; //!< number of h fields
+   static const size_t NUM_I = 2; //!< number of i fields
+   static const size_t NUM_J = 3; //!< number of j fields
+
+   //! number of all fields
+   static const size_t NUM_FIELDS = NUM_P + NUM_A + NUM_B + NUM_C + NUM_D + NUM_E + NUM_F + NUM_G + NUM_H + NUM_I + NUM_J;
+
    //! constructor
    LabelData();
 
@@ -75,14 +92,88 @@ public:
    //! set end time
    void setEndTime(double d);
 
-   //! set label data
-   template <class T>
-   void set(char category, size_t number, const T&);
+   //! set number
+   void set(char category, size_t number, size_t value);
+
+   //! set boolean value (1 or 0)
+   void set(char category, size_t number, bool value);
+
+   //! set phoneme symbol (string of symbol is not copied)
+   void set(char category, size_t number, const PhonemeSymbol& value);
+
+   //! set pitch
+   void set(char category, size_t number, const Pitch& value);
+
+   //! set beat
+   void set(char category, size_t number, const Beat& value);
+
+   //! set dynamics
+   void set(char category, size_t number, const Dynamics& value);
+
+   //! set difference (p or m + absolute value)
+   void setDifference(char category, size_t number, int value);
+
+   //! set score flag (2-digit hexadecimal)
+   void setScoreFlag(char category, size_t number, ScoreFlag value);
+
+   //! unset field (xx)
+   void unset(char category, size_t number);
 
    //! get label data
-   const std::string& get(char category, size_t number) const;
+   std::string get(char category, size_t number) const;
+
+   //! write label to buffer (appended)
+   void write(std::string& buffer) const;
 
 private:
+   //! copy constructor (donot use)
+   LabelData(const LabelData&);
+
+   //! assignment operator (donot use)
+   LabelData& operator=(const LabelData&);
+
+   //! set string (donot use: strings are not copied, so they have to be set as PhonemeSymbol)
+   void set(char category, size_t number, const char* value);
+
+   //! type of field
+   enum FieldType {
+      FIELD_UNSET, //!< xx
+      FIELD_NUMBER, //!< number
+      FIELD_BOOL, //!< 1 or 0
+      FIELD_STRING, //!< string
+      FIELD_PITCH, //!< step and octave
+      FIELD_BEAT, //!< beats/beat-type
+      FIELD_DIFFERENCE, //!< p or m + absolute value
+      FIELD_SCORE_FLAG //!< 2-digit hexadecimal
+   };
+
+   //! field of label
+   struct Field {
+      //! type
+      FieldType type;
+
+      //! string (string, step of pitch, dynamics)
+      const std::string* str;
+
+      //! unsigned number (number, bool, beats, score flag)
+      size_t number;
+
+      //! unsigned number (beat-type)
+      size_t subNumber;
+
+      //! signed number (octave, difference)
+      int signedNumber;
+   };
+
+   //! get field
+   Field& getField(char category, size_t number);
+
+   //! get field
+   const Field& getField(char category, size_t number) const;
+
+   //! write field to buffer (appended)
+   static void writeField(std::string& buffer, const Field& field);
+
    //! monophone flag
    bool monophoneFlag;
 
@@ -95,33 +186,10 @@ private:
    //! end time
    INT64 endTime;
 
-   typedef std::vector<std::string> List;
-
-   typedef std::map<char, List*> Data;
-
-   //! label data
-   Data data;
-
-   friend std::ostream& operator<<(std::ostream&, const LabelData&);
+   //! fields (p, a, b, c, d, e, f, g, h, i, j)
+   Field fields[NUM_FIELDS];
 };
 
-//! set data
-template <class T>
-void LabelData::set(char category, size_t number, const T& value)
-{
-   std::ostringstream oss;
-   oss << value;
-   set(category, number, oss.str());
-}
-
-//! set data (std::string)
-template<>
-void LabelData::set<std::string>(char category, size_t number, const std::string& value);
-
-//! set data (bool)
-template<>
-void LabelData::set<bool>(char category, size_t number, const bool& value);
-
 //! to stream
 std::ostream& operator<<(std::ostream&, const LabelData&);
 };
@@ -40,7 +40,6 @@
 /* ----------------------------------------------------------------- */
 
 #include <algorithm>
-#include <sstream>
 #include <limits>
 #include "LabelMaker.h"
 #include "util_string.h"
@@ -50,6 +49,7 @@
 #include "Deleter.h"
 #include "NoteGroup.h"
 #include "ILabelOutput.h"
+#include "Thread.h"
 #include "LabelData.h"
 #include "LabelPosition.h"
 #include "LabelMeasure.h"
@@ -63,6 +63,22 @@ namespace
 {
 const std::string DEFAULT_ENCODING = "utf-8";
 
+//! field of label
+struct LabelField {
+   char category; //!< category
+   size_t number; //!< number
+};
+
+//! fields which depend on whole song: averages and number of phrases, and positions counted from end of crescendo or diminuendo
+const LabelField SONG_FIELDS[] = {
+   {'e', 42}, {'e', 44}, {'e', 46}, {'e', 47}, {'e', 48},
+   {'e', 50}, {'e', 52}, {'e', 54}, {'e', 55}, {'e', 56},
+   {'j', 1}, {'j', 2}, {'j', 3}
+};
+
+//! number of fields which depend on whole song
+const size_t SONG_FIELD_NUM = sizeof(SONG_FIELDS) / sizeof(SONG_FIELDS[0]);
+
 class Copier
 {
 public:
@@ -112,20 +128,18 @@ public:
    virtual ~PhonemeLabel() {}
 
    //! set type
-   virtual void setType(const std::string& value) {}
+   virtual void setType(const PhonemeSymbol& value) {}
 
    //! set name
-   virtual void setName(const std::string& value) {
+   virtual void setName(const PhonemeSymbol& value) {
       if (!value.empty()) {
          labelData.set('p', 4 + diff, value);
       }
    }
 
    //! set flag
-   virtual void setFlag(const std::string& value) {
-      if (!value.empty()) {
-         labelData.set('p', 9 + diff, value);
-      }
+   virtual void setFlag(ScoreFlag value) {
+      labelData.setScoreFlag('p', 9 + diff, value);
    }
 
    //! set position in syllable
@@ -175,7 +189,7 @@ public:
    virtual ~CurrentPhonemeLabel() {}
 
    //! set type
-   virtual void setType(const std::string& value) {
+   virtual void setType(const PhonemeSymbol& value) {
       if (!value.empty()) {
          labelData.set('p', 1, value);
       }
@@ -244,12 +258,12 @@ public:
    }
 
    //! set language
-   virtual void setLanguage(const std::string& value) {
+   virtual void setLanguage(const PhonemeSymbol& value) {
       labelData.set(category, 4, value);
    }
 
    //! set language dependent information
-   virtual void setLangDependentInfo(const std::string& value) {
+   virtual void setLangDependentInfo(const PhonemeSymbol& value) {
       labelData.set(category, 5, value);
    }
 
@@ -855,15 +869,7 @@ void NoteLabel::setPositionInDiminuendo(const LabelPosition& idx, const LabelPos
  */
 void NoteLabel::setPitchDifferenceFromPrev(int value)
 {
-   std::ostringstream oss;
-   if (value < 0) {
-      oss << "m";
-      value *= -1;
-   } else {
-      oss << "p";
-   }
-   oss << value;
-   labelData.set(category, 57, oss.str());
+   labelData.setDifference(category, 57, value);
 }
 
 /*!
@@ -871,15 +877,7 @@ void NoteLabel::setPitchDifferenceFromPrev(int value)
  */
 void NoteLabel::setPitchDifferenceToNext(int value)
 {
-   std::ostringstream oss;
-   if (value < 0) {
-      oss << "m";
-      value *= -1;
-   } else {
-      oss << "p";
-   }
-   oss << value;
-   labelData.set(category, 58, oss.str());
+   labelData.setDifference(category, 58, value);
 }
 
 
@@ -898,10 +896,11 @@ public:
 /*!
  constructor
  */
-LabelMaker::LabelMaker(Converter& c, bool sepRests) :
+LabelMaker::LabelMaker(const Converter& c, bool sepRests) :
    converter(c), encoding(DEFAULT_ENCODING), separateWholeNoteRests(sepRests),
    isFixed(false), tempo(DEFAULT_TEMPO), syllableNum(0),
-   inTie(false), inCrescendo(false), inDiminuendo(false), residualMeasureDuration(0)
+   inTie(false), inCrescendo(false), inDiminuendo(false), residualMeasureDuration(0),
+   syllableNumPerMeasure(0), noteNumPerMeasure(0)
 {
 }
 
@@ -1372,13 +1371,107 @@ void LabelMaker::fix()
       }
    }
 
+   makePhonemeIndex();
+   makeSegments();
+
    isFixed = true;
 }
 
+/*!
+ @internal
+
+ worker to make labels of a range of phonemes
+*/
+class LabelMaker::LabelWorker : public IRunnable
+{
+public:
+   //! constructor
+   LabelWorker(const LabelMaker& m, size_t b, size_t e, bool mono, int overwrite, int time) :
+      maker(m), begin(b), end(e), monophoneFlag(mono), overwriteEnableFlag(overwrite), timeFlag(time), failed(false) {}
+
+   //! destructor
+   virtual ~LabelWorker() {}
+
+   //! make labels
+   virtual void run() {
+      try {
+         ends.reserve(end - begin);
+         for (size_t idx(begin); idx < end; ++idx) {
+            LabelData labelData;
+            maker.makeLabel(labelData, idx, monophoneFlag, overwriteEnableFlag, timeFlag);
+            labelData.write(buffer);
+            ends.push_back(buffer.size());
+         }
+      } catch (const std::exception& ex) {
+         error = ex.what();
+         failed = true;
+      }
+   }
+
+   //! output labels
+   void output(ILabelOutput& output) const {
+      std::string label;
+      size_t pos(0);
+      const std::vector<size_t>::const_iterator itrEnd(ends.end());
+      for (std::vector<size_t>::const_iterator itr(ends.begin()); itrEnd != itr; ++itr) {
+         label.assign(buffer, pos, *itr - pos);
+         output.output(label);
+         pos = *itr;
+      }
+   }
+
+   //! failed or not
+   bool isFailed() const {
+      return failed;
+   }
+
+   //! get error message
+   const std::string& getError() const {
+      return error;
+   }
+
+private:
+   //! copy constructor (donot use)
+   LabelWorker(const LabelWorker&);
+
+   //! assignment operator (donot use)
+   LabelWorker& operator=(const LabelWorker&);
+
+   //! label maker
+   const LabelMaker& maker;
+
+   //! first index of phonemes
+   const size_t begin;
+
+   //! end index of phonemes
+   const size_t end;
+
+   //! monophone flag
+   const bool monophoneFlag;
+
+   //! overwrite enable flag
+   const int overwriteEnableFlag;
+
+   //! time flag
+   const int timeFlag;
+
+   //! failed or not
+   bool failed;
+
+   //! error message
+   std::string error;
+
+   //! labels
+   std::string buffer;
+
+   //! end positions of labels in buffer
+   std::vector<size_t> ends;
+};
+
 /*!
  output label
 */
-void LabelMaker::outputLabel(ILabelOutput& output, bool monophoneFlag, int overwriteEnableFlag, int timeFlag) const
+void LabelMaker::outputLabel(ILabelOutput& output, bool monophoneFlag, int overwriteEnableFlag, int timeFlag, size_t threadNum) const
 {
    if ((overwriteEnableFlag < 0) || (2 < overwriteEnableFlag)) {
       throw std::out_of_range("LabelMaker::outputLabel() overwriteEnableFlag is out of range [0...2]");
@@ -1387,56 +1480,132 @@ void LabelMaker::outputLabel(ILabelOutput& output, bool monophoneFlag, int overw
       throw std::out_of_range("LabelMaker::outputLabel() timeFlag is out of range [0...2]");
    }
 
-   double time(0.0);
+   const size_t phonemeNum(phonemeIndexList.size());
+   if (phonemeNum < threadNum) {
+      threadNum = phonemeNum;
+   }
 
-   // Note
-   const NoteList::const_iterator nItrBegin(noteList.begin());
-   const NoteList::const_iterator nItrEnd(noteList.end());
-   for (NoteList::const_iterator nItr(nItrBegin) ; nItrEnd != nItr; ++nItr) {
+   if (threadNum <= 1) {
+      std::string buffer;
+      for (size_t idx(0); idx < phonemeNum; ++idx) {
+         LabelData labelData;
+         makeLabel(labelData, idx, monophoneFlag, overwriteEnableFlag, timeFlag);
+         buffer.clear();
+         labelData.write(buffer);
+         output.output(buffer);
+      }
+      return;
+   }
 
-      double beginTime(0.0);
+   // each worker makes labels of a contiguous range of phonemes
+   std::vector<LabelWorker*> workers;
+   std::vector<Thread*> threads;
+   workers.reserve(threadNum);
+   threads.reserve(threadNum);
+   for (size_t i(0); i < threadNum; ++i) {
+      const size_t begin(phonemeNum * i / threadNum);
+      const size_t end(phonemeNum * (i + 1) / threadNum);
+      workers.push_back(new LabelWorker(*this, begin, end, monophoneFlag, overwriteEnableFlag, timeFlag));
+   }
 
-      // Syllable
-      const NoteLabeler::List::const_iterator sItrBegin((*nItr)->childBegin());
-      const NoteLabeler::List::const_iterator sItrEnd((*nItr)->childEnd());
-      for (NoteLabeler::List::const_iterator sItr(sItrBegin) ; sItrEnd != sItr; ++sItr) {
+   // the first range is made by the calling thread
+   for (size_t i(1); i < threadNum; ++i) {
+      Thread* thread(new Thread(*workers[i]));
+      if (!thread->start()) {
+         delete thread;
+         workers[i]->run();
+         continue;
+      }
+      threads.push_back(thread);
+   }
+   workers[0]->run();
+   std::for_each(threads.begin(), threads.end(), Deleter<Thread>());
 
-         // Phoneme
-         const SyllableLabeler::List::const_iterator pItrBegin((*sItr)->childBegin());
-         const SyllableLabeler::List::const_iterator pItrEnd((*sItr)->childEnd());
-         for (SyllableLabeler::List::const_iterator pItr(pItrBegin); pItrEnd != pItr; ++pItr) {
-            LabelData labelData;
-            labelData.setMonophoneFlag(monophoneFlag);
-
-            if (0 != timeFlag) {
-               labelData.setOutputTimeFlag(true);
-               // begin time
-               if ((sItrBegin == sItr) && (pItrBegin == pItr)) {
-                  labelData.setBeginTime(time);
-                  beginTime = time;
-                  time += (*nItr)->getLength().getTime();
-               } else if (1 == timeFlag) {
-                  labelData.setBeginTime(beginTime);
-               }
+   std::string error;
+   for (size_t i(0); i < threadNum; ++i) {
+      if (workers[i]->isFailed() && error.empty()) {
+         error = workers[i]->getError();
+      }
+   }
+   if (!error.empty()) {
+      std::for_each(workers.begin(), workers.end(), Deleter<LabelWorker>());
+      throw std::runtime_error(error);
+   }
 
-               // end time
-               if ((sItrEnd == (sItr + 1)) && (pItrEnd == (pItr + 1))) {
-                  labelData.setEndTime(time);
-               } else if (1 == timeFlag) {
-                  labelData.setEndTime(time);
-               }
-            } else {
-               labelData.setOutputTimeFlag(false);
-            }
+   try {
+      for (size_t i(0); i < threadNum; ++i) {
+         workers[i]->output(output);
+      }
+   } catch (...) {
+      std::for_each(workers.begin(), workers.end(), Deleter<LabelWorker>());
+      throw;
+   }
+   std::for_each(workers.begin(), workers.end(), Deleter<LabelWorker>());
+}
+
+/*!
+ get number of segments
+*/
+size_t LabelMaker::getSegmentNum() const
+{
+   return segmentList.size();
+}
+
+/*!
+ output label of segment
+*/
+void LabelMaker::outputSegmentLabel(ILabelOutput& output, size_t segment, bool monophoneFlag, int overwriteEnableFlag, int timeFlag) const
+{
+   if ((overwriteEnableFlag < 0) || (2 < overwriteEnableFlag)) {
+      throw std::out_of_range("LabelMaker::outputSegmentLabel() overwriteEnableFlag is out of range [0...2]");
+   }
+   if ((timeFlag < 0) || (2 < timeFlag)) {
+      throw std::out_of_range("LabelMaker::outputSegmentLabel() timeFlag is out of range [0...2]");
+   }
+   if (segmentList.size() <= segment) {
+      throw std::out_of_range("LabelMaker::outputSegmentLabel() segment is out of range");
+   }
 
-            setLabelData(labelData, nItr, sItr, pItr, overwriteEnableFlag, timeFlag);
+   const Segment& seg(segmentList[segment]);
+   std::string buffer;
+   for (size_t idx(seg.begin); idx < seg.end; ++idx) {
+      LabelData labelData;
+      makeLabel(labelData, idx, monophoneFlag, overwriteEnableFlag, timeFlag, &seg);
+      buffer.clear();
+      labelData.write(buffer);
+      output.output(buffer);
+   }
+}
 
-            std::ostringstream oss;
-            oss << labelData;
-            output.output(oss.str());
+/*!
+ make key of segment
 
+ Labels of segment and labels next to segment are joined.
+ Fields which depend on whole song are unset unless songFieldFlag is true, so the key is not changed by edits far from the segment
+ (e.g. notes appended to end of score).
+*/
+void LabelMaker::makeSegmentKey(std::string& key, size_t segment, bool songFieldFlag) const
+{
+   if (segmentList.size() <= segment) {
+      throw std::out_of_range("LabelMaker::makeSegmentKey() segment is out of range");
+   }
+
+   const Segment& seg(segmentList[segment]);
+   const size_t begin((0 < seg.begin) ? seg.begin - 1 : seg.begin);
+   const size_t end(std::min(seg.end + 1, phonemeIndexList.size()));
+   key.clear();
+   for (size_t idx(begin); idx < end; ++idx) {
+      // same labels as synthesized ones in segment, and labels without time outside segment
+      const bool inSegment((seg.begin <= idx) && (idx < seg.end));
+      LabelData labelData;
+      makeLabel(labelData, idx, false, 1, inSegment ? 2 : 0, inSegment ? &seg : NULL);
+      if (!songFieldFlag) {
+         for (size_t i(0); i < SONG_FIELD_NUM; ++i) {
+            labelData.unset(SONG_FIELDS[i].category, SONG_FIELDS[i].number);
          }
       }
+      labelData.write(key);
+      key.push_back('\n');
    }
 }
 
@@ -1457,111 +1626,130 @@ LabelMeasure* LabelMaker::getLastMeasure()
 /*!
  @internal
 
- move to previous note
+ make index of phonemes and their neighbours
 */
-bool LabelMaker::moveToPrevNote(ConstNoteItr& nItr, bool skipRests) const
+void LabelMaker::makePhonemeIndex()
 {
-   for ( ; ; ) {
-      if (noteList.begin() == nItr) {
-         return false;
-      }
-      --nItr;
-      if (!skipRests || !(*nItr)->isRest()) {
-         break;
-      }
+   phonemeIndexList.clear();
+
+   if (!measureList.empty()) {
+      syllableNumPerMeasure = syllableNum / measureList.size();
+      noteNumPerMeasure = noteList.size() / measureList.size();
    }
-   return true;
-}
 
-/*!
- @internal
+   const size_t noteNum(noteList.size());
 
- move to next note
-*/
-bool LabelMaker::moveToNextNote(ConstNoteItr& nItr, bool skipRests) const
-{
-   for ( ; ; ) {
-      if (noteList.end() == nItr + 1) {
-         return false;
+   // previous and next notes which are not rests
+   std::vector<NoteLabeler*> prevNotes(noteNum, static_cast<NoteLabeler*>(NULL));
+   std::vector<NoteLabeler*> nextNotes(noteNum, static_cast<NoteLabeler*>(NULL));
+   {
+      NoteLabeler* prev(NULL);
+      for (size_t i(0); i < noteNum; ++i) {
+         prevNotes[i] = prev;
+         if (!noteList[i]->isRest()) {
+            prev = noteList[i];
+         }
       }
-      ++nItr;
-      if (!skipRests || !(*nItr)->isRest()) {
-         break;
+      NoteLabeler* next(NULL);
+      for (size_t i(noteNum); 0 < i; --i) {
+         nextNotes[i - 1] = next;
+         if (!noteList[i - 1]->isRest()) {
+            next = noteList[i - 1];
+         }
       }
    }
-   return true;
-}
 
-/*!
- @internal
+   double time(0.0);
+   for (size_t i(0); i < noteNum; ++i) {
+      NoteLabeler* note(noteList[i]);
+      double beginTime(0.0);
+      const NoteLabeler::List::const_iterator sItrBegin(note->childBegin());
+      const NoteLabeler::List::const_iterator sItrEnd(note->childEnd());
+      for (NoteLabeler::List::const_iterator sItr(sItrBegin); sItrEnd != sItr; ++sItr) {
+         PhonemeIndex index;
+         index.note = note;
+         index.prevNote = prevNotes[i];
+         index.nextNote = nextNotes[i];
+         index.syllable = *sItr;
+         if (sItrBegin != sItr) {
+            index.prevSyllable = *(sItr - 1);
+         } else if (NULL != prevNotes[i]) {
+            index.prevSyllable = *(prevNotes[i]->childEnd() - 1);
+         } else {
+            index.prevSyllable = NULL;
+         }
+         if (sItrEnd != sItr + 1) {
+            index.nextSyllable = *(sItr + 1);
+         } else if (NULL != nextNotes[i]) {
+            index.nextSyllable = *(nextNotes[i]->childBegin());
+         } else {
+            index.nextSyllable = NULL;
+         }
 
- move to previous syllable
-*/
-bool LabelMaker::moveToPrevSyllable(ConstNoteItr& nItr, ConstSyllableItr& sItr, bool skipRests) const
-{
-   if ((*nItr)->childBegin() == sItr) {
-      if (false == moveToPrevNote(nItr, skipRests)) {
-         return false;
+         const SyllableLabeler::List::const_iterator pItrBegin((*sItr)->childBegin());
+         const SyllableLabeler::List::const_iterator pItrEnd((*sItr)->childEnd());
+         for (SyllableLabeler::List::const_iterator pItr(pItrBegin); pItrEnd != pItr; ++pItr) {
+            index.phoneme = *pItr;
+            index.isNoteBegin = ((sItrBegin == sItr) && (pItrBegin == pItr));
+            index.isNoteEnd = ((sItrEnd == sItr + 1) && (pItrEnd == pItr + 1));
+            if (index.isNoteBegin) {
+               beginTime = time;
+               time += note->getLength().getTime();
+            }
+            index.beginTime = beginTime;
+            index.endTime = time;
+            phonemeIndexList.push_back(index);
+         }
       }
-      sItr = (*nItr)->childEnd() - 1;
-   } else {
-      --sItr;
    }
-   return true;
 }
 
 /*!
  @internal
 
- move to next syllable
+ make segments: score is split at the middle of the first rest after each phrase,
+ so that each segment begins and ends with silence
 */
-bool LabelMaker::moveToNextSyllable(ConstNoteItr& nItr, ConstSyllableItr& sItr, bool skipRests) const
+void LabelMaker::makeSegments()
 {
-   if ((*nItr)->childEnd() - 1 == sItr) {
-      if (false == moveToNextNote(nItr, skipRests)) {
-         return false;
-      }
-      sItr = (*nItr)->childBegin();
-   } else {
-      ++sItr;
-   }
-   return true;
-}
+   segmentList.clear();
 
-/*!
- @internal
+   const size_t phonemeNum(phonemeIndexList.size());
+   if (0 == phonemeNum) {
+      return;
+   }
 
- move to previous phoneme
-*/
-bool LabelMaker::moveToPrevPhoneme(ConstNoteItr& nItr, ConstSyllableItr& sItr, ConstPhonemeItr& pItr, bool skipRests) const
-{
-   if ((*sItr)->childBegin() == pItr) {
-      if (false == moveToPrevSyllable(nItr, sItr, skipRests)) {
-         return false;
+   // last phoneme which is not in rest
+   size_t lastIdx(0);
+   for (size_t idx(0); idx < phonemeNum; ++idx) {
+      if (!phonemeIndexList[idx].note->isRest()) {
+         lastIdx = idx;
       }
-      pItr = (*sItr)->childEnd() - 1;
-   } else {
-      --pItr;
    }
-   return true;
-}
 
-/*!
- @internal
-
- move to next phoneme
-*/
-bool LabelMaker::moveToNextPhoneme(ConstNoteItr& nItr, ConstSyllableItr& sItr, ConstPhonemeItr& pItr, bool skipRests) const
-{
-   if ((*sItr)->childEnd() - 1 == pItr) {
-      if (false == moveToNextSyllable(nItr, sItr, skipRests)) {
-         return false;
+   Segment segment;
+   segment.begin = 0;
+   segment.beginTime = phonemeIndexList[0].beginTime;
+   bool hasNote(false);
+   for (size_t idx(0); idx < lastIdx; ++idx) {
+      const PhonemeIndex& index(phonemeIndexList[idx]);
+      if (!index.note->isRest()) {
+         hasNote = true;
+         continue;
+      }
+      if (hasNote && index.isNoteBegin && index.isNoteEnd) {
+         const double middle((index.beginTime + index.endTime) / 2.0);
+         segment.end = idx + 1;
+         segment.endTime = middle;
+         segmentList.push_back(segment);
+         segment.begin = idx;
+         segment.beginTime = middle;
+         hasNote = false;
       }
-      pItr = (*sItr)->childBegin();
-   } else {
-      ++pItr;
    }
-   return true;
+   segment.end = phonemeNum;
+   segment.endTime = phonemeIndexList[phonemeNum - 1].endTime;
+   segmentList.push_back(segment);
 }
 
 /*!
@@ -1569,82 +1757,31 @@ bool LabelMaker::moveToNextPhoneme(ConstNoteItr& nItr, ConstSyllableItr& sItr, C
 
  set label data
 */
-void LabelMaker::setLabelData(LabelData& label, const ConstNoteItr& noteItr, const ConstSyllableItr& syllableItr, const ConstPhonemeItr& phonemeItr, int overwriteEnableFlag, int timeFlag) const
+void LabelMaker::setLabelData(LabelData& label, size_t idx, int overwriteEnableFlag) const
 {
-   {
-      size_t j1(syllableNum / measureList.size());
-      label.set('j', 1, std::min<size_t>(j1, 99));
-   }
-   {
-      size_t j2(noteList.size() / measureList.size());
-      label.set('j', 2, std::min<size_t>(j2, 99));
-   }
+   label.set('j', 1, std::min<size_t>(syllableNumPerMeasure, 99));
+   label.set('j', 2, std::min<size_t>(noteNumPerMeasure, 99));
    label.set('j', 3, phraseList.size());
 
+   const PhonemeIndex& index(phonemeIndexList[idx]);
+   const size_t phonemeNum(phonemeIndexList.size());
+
    // Note
-   NoteLabeler* note(*noteItr);
-   NoteLabeler* pNote(NULL);
-   NoteLabeler* nNote(NULL);
-   {
-      ConstNoteItr nItr(noteItr);
-      if (moveToPrevNote(nItr, true)) {
-         pNote = *nItr;
-      }
-   }
-   {
-      ConstNoteItr nItr(noteItr);
-      if (moveToNextNote(nItr, true)) {
-         nNote = *nItr;
-      }
-   }
+   NoteLabeler* note(index.note);
+   NoteLabeler* pNote(index.prevNote);
+   NoteLabeler* nNote(index.nextNote);
 
    // Syllable
-   SyllableLabeler* syllable(*syllableItr);
-   SyllableLabeler* pSyllable(NULL);
-   SyllableLabeler* nSyllable(NULL);
-   {
-      ConstNoteItr nItr(noteItr);
-      ConstSyllableItr sItr(syllableItr);
-      if (moveToPrevSyllable(nItr, sItr, true)) {
-         pSyllable = *sItr;
-      }
-   }
-   {
-      ConstNoteItr nItr(noteItr);
-      ConstSyllableItr sItr(syllableItr);
-      if (moveToNextSyllable(nItr, sItr, true)) {
-         nSyllable = *sItr;
-      }
-   }
+   SyllableLabeler* syllable(index.syllable);
+   SyllableLabeler* pSyllable(index.prevSyllable);
+   SyllableLabeler* nSyllable(index.nextSyllable);
 
    // Phoneme
-   PhonemeLabeler* phoneme(*phonemeItr);
-   PhonemeLabeler* pPhoneme(NULL);
-   PhonemeLabeler* nPhoneme(NULL);
-   PhonemeLabeler* ppPhoneme(NULL);
-   PhonemeLabeler* nnPhoneme(NULL);
-   {
-      ConstNoteItr nItr(noteItr);
-      ConstSyllableItr sItr(syllableItr);
-      ConstPhonemeItr pItr(phonemeItr);
-      if (moveToPrevPhoneme(nItr, sItr, pItr, false)) {
-         pPhoneme = *pItr;
-         if (moveToPrevPhoneme(nItr, sItr, pItr, false)) {
-            ppPhoneme = *pItr;
-         }
-      }
-   }
-   {
-      ConstNoteItr nItr(noteItr);
-      ConstSyllableItr sItr(syllableItr);
-      ConstPhonemeItr pItr(phonemeItr);
-      if (moveToNextPhoneme(nItr, sItr, pItr, false)) {
-         nPhoneme = *pItr;
-         if (moveToNextPhoneme(nItr, sItr, pItr, false)) {
-            nnPhoneme = *pItr;
-         }
-      }
-   }
+   PhonemeLabeler* phoneme(index.phoneme);
+   PhonemeLabeler* pPhoneme((1 <= idx) ? phonemeIndexList[idx - 1].phoneme : NULL);
+   PhonemeLabeler* nPhoneme((idx + 1 < phonemeNum) ? phonemeIndexList[idx + 1].phoneme : NULL);
+   PhonemeLabeler* ppPhoneme((2 <= idx) ? phonemeIndexList[idx - 2].phoneme : NULL);
+   PhonemeLabeler* nnPhoneme((idx + 2 < phonemeNum) ? phonemeIndexList[idx + 2].phoneme : NULL);
 
    // Note
    {
@@ -1697,6 +1834,54 @@ void LabelMaker::setLabelData(LabelData& label, const ConstNoteItr& noteItr, con
    }
 }
 
+/*!
+ @internal
+
+ make label of phoneme
+*/
+void LabelMaker::makeLabel(LabelData& label, size_t idx, bool monophoneFlag, int overwriteEnableFlag, int timeFlag, const Segment* segment) const
+{
+   const PhonemeIndex& index(phonemeIndexList[idx]);
+
+   label.setMonophoneFlag(monophoneFlag);
+
+   if (0 != timeFlag) {
+      label.setOutputTimeFlag(true);
+      bool isBegin(index.isNoteBegin);
+      bool isEnd(index.isNoteEnd);
+      double beginTime(index.beginTime);
+      double endTime(index.endTime);
+
+      // time in segment (first and last rests may be split)
+      if (NULL != segment) {
+         if (segment->begin == idx) {
+            isBegin = true;
+            beginTime = segment->beginTime;
+         }
+         if (segment->end == idx + 1) {
+            isEnd = true;
+            endTime = segment->endTime;
+         }
+         beginTime -= segment->beginTime;
+         endTime -= segment->beginTime;
+      }
+
+      // begin time
+      if (isBegin || (1 == timeFlag)) {
+         label.setBeginTime(beginTime);
+      }
+
+      // end time
+      if (isEnd || (1 == timeFlag)) {
+         label.setEndTime(endTime);
+      }
+   } else {
+      label.setOutputTimeFlag(false);
+   }
+
+   setLabelData(label, idx, overwriteEnableFlag);
+}
+
 /*!
  @internal
 
@@ -67,7 +67,7 @@ class LabelMaker : public IScoreWritable
 {
 public:
    //! constructor
-   explicit LabelMaker(Converter& converter, bool sepRests = true);
+   explicit LabelMaker(const Converter& converter, bool sepRests = true);
 
    //! destructor
    virtual ~LabelMaker();
@@ -105,8 +105,17 @@ public:
    //! fix
    void fix();
 
-   //! output label
-   void outputLabel(ILabelOutput& output, bool monophoneFlag = false, int overwriteEnableFlag = 0, int timeFlag = 0) const;
+   //! output label (labels are made by threadNum threads in parallel)
+   void outputLabel(ILabelOutput& output, bool monophoneFlag = false, int overwriteEnableFlag = 0, int timeFlag = 0, size_t threadNum = 1) const;
+
+   //! get number of segments (score is split at rests between phrases)
+   size_t getSegmentNum() const;
+
+   //! output label of segment (time is relative to beginning of segment)
+   void outputSegmentLabel(ILabelOutput& output, size_t segment, bool monophoneFlag = false, int overwriteEnableFlag = 0, int timeFlag = 0) const;
+
+   //! make key of segment: it is changed only by edits of the segment and its neighbours (and by any edit changing song-wide fields if songFieldFlag is true)
+   void makeSegmentKey(std::string& key, size_t segment, bool songFieldFlag = false) const;
 
 private:
    //! copy constructor (donot use)
@@ -119,7 +128,7 @@ private:
    LabelMeasure* getLastMeasure();
 
    //! converter
-   Converter& converter;
+   const Converter& converter;
 
    //! encoding of lyrics
    std::string encoding;
@@ -189,32 +198,59 @@ private:
    //! list of notes
    NoteList noteList;
 
-   typedef NoteList::const_iterator ConstNoteItr;
+   //! phoneme and its neighbours (made by fix())
+   struct PhonemeIndex {
+      NoteLabeler* note; //!< note
+      NoteLabeler* prevNote; //!< previous note (rests are skipped)
+      NoteLabeler* nextNote; //!< next note (rests are skipped)
+      SyllableLabeler* syllable; //!< syllable
+      SyllableLabeler* prevSyllable; //!< previous syllable (rests are skipped)
+      SyllableLabeler* nextSyllable; //!< next syllable (rests are skipped)
+      PhonemeLabeler* phoneme; //!< phoneme
+      bool isNoteBegin; //!< first phoneme in note or not
+      bool isNoteEnd; //!< last phoneme in note or not
+      double beginTime; //!< begin time of note
+      double endTime; //!< end time of note
+   };
 
-   //! move to previous note
-   bool moveToPrevNote(ConstNoteItr& nItr, bool skipRests) const;
+   typedef std::vector<PhonemeIndex> PhonemeIndexList;
 
-   //! move to next note
-   bool moveToNextNote(ConstNoteItr& nItr, bool skipRests) const;
+   //! list of all phonemes (neighbours of phoneme are next to it)
+   PhonemeIndexList phonemeIndexList;
 
-   typedef NoteLabeler::List::const_iterator ConstSyllableItr;
+   //! segment of phonemes
+   struct Segment {
+      size_t begin; //!< index of first phoneme
+      size_t end; //!< index of phoneme after last one
+      double beginTime; //!< begin time
+      double endTime; //!< end time
+   };
 
-   //! move to previous syllable
-   bool moveToPrevSyllable(ConstNoteItr& nItr, ConstSyllableItr& sItr, bool skipRests) const;
+   typedef std::vector<Segment> SegmentList;
 
-   //! move to next syllable
-   bool moveToNextSyllable(ConstNoteItr& nItr, ConstSyllableItr& sItr, bool skipRests) const;
+   //! list of segments
+   SegmentList segmentList;
 
-   typedef SyllableLabeler::List::const_iterator ConstPhonemeItr;
+   //! number of syllables per measure
+   size_t syllableNumPerMeasure;
 
-   //! move to previous phoneme
-   bool moveToPrevPhoneme(ConstNoteItr& nItr, ConstSyllableItr& sItr, ConstPhonemeItr& pItr, bool skipRests) const;
+   //! number of notes per measure
+   size_t noteNumPerMeasure;
 
-   //! move to next phoneme
-   bool moveToNextPhoneme(ConstNoteItr& nItr, ConstSyllableItr& sItr, ConstPhonemeItr& pItr, bool skipRests) const;
+   //! make phoneme index
+   void makePhonemeIndex();
+
+   //! make segments
+   void makeSegments();
 
    //! set label data
-   void setLabelData(LabelData& label, const ConstNoteItr& noteItr, const ConstSyllableItr& syllableItr, const ConstPhonemeItr& phonemeItr, int overwriteEnableFlag, int timeFlag) const;
+   void setLabelData(LabelData& label, size_t idx, int overwriteEnableFlag) const;
+
+   //! make label of phoneme
+   void makeLabel(LabelData& label, size_t idx, bool monophoneFlag, int overwriteEnableFlag, int timeFlag, const Segment* segment = NULL) const;
+
+   //! worker to make labels in parallel
+   class LabelWorker;
 
    //! apply stocks
    void applyStocks();
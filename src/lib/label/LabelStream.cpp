@@ -66,7 +66,7 @@ LabelStream::~LabelStream()
  */
 void LabelStream::output(const std::string& str)
 {
-   stream << str << std::endl;
+   stream << str << "\n";
 }
 
 };  // namespace sinsy
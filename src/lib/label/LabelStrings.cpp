@@ -39,19 +39,25 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
-#include <string.h>
 #include <algorithm>
+#include <string.h>
 #include "LabelStrings.h"
-#include "util_log.h"
 #include "Deleter.h"
+#include "util_log.h"
 
 namespace sinsy
 {
 
+namespace
+{
+const size_t MIN_BLOCK_SIZE = 4 * 1024;
+const size_t MAX_BLOCK_SIZE = 64 * 1024;
+};
+
 /*!
  constructor
  */
-LabelStrings::LabelStrings()
+LabelStrings::LabelStrings() : rest(NULL), restSize(0)
 {
 }
 
@@ -60,7 +66,7 @@ LabelStrings::LabelStrings()
  */
 LabelStrings::~LabelStrings()
 {
-   std::for_each(stringList.begin(), stringList.end(), ArrayDeleter<char>());
+   std::for_each(blocks.begin(), blocks.end(), ArrayDeleter<char>());
 }
 
 /*!
@@ -68,7 +74,7 @@ LabelStrings::~LabelStrings()
  */
 size_t LabelStrings::size() const
 {
-   return stringList.size();
+   return pointers.size();
 }
 
 /*!
@@ -76,7 +82,10 @@ size_t LabelStrings::size() const
  */
 const char* const * LabelStrings::getData() const
 {
-   return &stringList[0];
+   if (pointers.empty()) {
+      return NULL;
+   }
+   return &pointers[0];
 }
 
 /*!
@@ -84,11 +93,23 @@ const char* const * LabelStrings::getData() const
  */
 void LabelStrings::output(const std::string& str)
 {
-   size_t sz(str.size());
-
-   char* lab(new char[sz + 1]);
-   strcpy(lab, str.c_str());
-   stringList.push_back(lab);
+   const size_t size(str.size() + 1);
+   if (restSize < size) {
+      // labels already output are kept in previous blocks (size of blocks is doubled up to MAX_BLOCK_SIZE)
+      size_t blockSize(MIN_BLOCK_SIZE);
+      for (size_t i(0); (i < blocks.size()) && (blockSize < MAX_BLOCK_SIZE); ++i) {
+         blockSize *= 2;
+      }
+      blockSize = std::max(size, blockSize);
+      blocks.reserve(blocks.size() + 1);
+      rest = new char[blockSize];
+      blocks.push_back(rest);
+      restSize = blockSize;
+   }
+   memcpy(rest, str.c_str(), size);
+   pointers.push_back(rest);
+   rest += size;
+   restSize -= size;
 }
 
 };  // namespace sinsy
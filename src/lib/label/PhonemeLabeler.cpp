@@ -46,7 +46,7 @@
 namespace sinsy
 {
 
-const std::string PhonemeLabeler::BREATH_PHONEME = "br"; //!< breath
+const PhonemeSymbol PhonemeLabeler::BREATH_PHONEME = PhonemeSymbol("br"); //!< breath
 
 /*!
  constructor
@@ -80,7 +80,7 @@ void PhonemeLabeler::setLabel(IPhonemeLabel& label, int overwriteEnableFlag) con
       throw std::invalid_argument("PhonemeLabeler::setLabel() Overwrite enable flag is invalid");
    }
 
-   label.setFlag(getScoreFlagStr(flag));
+   label.setFlag(flag);
 
    if (numInSyllable < idxInSyllable) {
       throw std::runtime_error("PhonemeLabeler::setLabel() numInSyllable < idxInSyllable");
@@ -118,7 +118,7 @@ void PhonemeLabeler::setNumInSyllable(size_t n)
 /*!
  get phoneme type
  */
-const std::string& PhonemeLabeler::getPhonemeType() const
+const PhonemeSymbol& PhonemeLabeler::getPhonemeType() const
 {
    return phonemeInfo.getType();
 }
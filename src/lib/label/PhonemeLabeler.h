@@ -53,7 +53,7 @@ namespace sinsy
 class PhonemeLabeler
 {
 public:
-   static const std::string BREATH_PHONEME;
+   static const PhonemeSymbol BREATH_PHONEME;
 
    //! constructor
    explicit PhonemeLabeler(const PhonemeInfo&);
@@ -74,7 +74,7 @@ public:
    void setNumInSyllable(size_t n);
 
    //! get phoneme type
-   const std::string& getPhonemeType() const;
+   const PhonemeSymbol& getPhonemeType() const;
 
    //! set count from previous vowel
    void setCountFromPrevVowel(size_t count);
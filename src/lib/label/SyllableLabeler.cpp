@@ -127,7 +127,7 @@ void SyllableLabeler::setNumInNote(size_t n)
  */
 void SyllableLabeler::setInfo(const std::string& str)
 {
-   langDependentInfo = str;
+   langDependentInfo = PhonemeSymbol(str);
 }
 
 /*!
@@ -152,11 +152,11 @@ void SyllableLabeler::setPhonemePositions()
       size_t count(0);
       const List::iterator itrEnd(children.end());
       for (List::iterator itr(children.begin()); itrEnd != itr; ++itr) {
-         const std::string& type((*itr)->getPhonemeType());
-         if (0 == type.compare(PhonemeInfo::TYPE_VOWEL)) {
+         const PhonemeSymbol& type((*itr)->getPhonemeType());
+         if (PhonemeInfo::TYPE_VOWEL == type) {
             count = 1;
          } else {
-            if (0 == type.compare(PhonemeInfo::TYPE_CONSONANT)) {
+            if (PhonemeInfo::TYPE_CONSONANT == type) {
                (*itr)->setCountFromPrevVowel(count);
             }
             if (0 < count) {
@@ -171,11 +171,11 @@ void SyllableLabeler::setPhonemePositions()
       size_t count(0);
       const List::reverse_iterator itrEnd(children.rend());
       for (List::reverse_iterator itr(children.rbegin()); itrEnd != itr; ++itr) {
-         const std::string& type((*itr)->getPhonemeType());
-         if (0 == type.compare(PhonemeInfo::TYPE_VOWEL)) {
+         const PhonemeSymbol& type((*itr)->getPhonemeType());
+         if (PhonemeInfo::TYPE_VOWEL == type) {
             count = 1;
          } else {
-            if (0 == type.compare(PhonemeInfo::TYPE_CONSONANT)) {
+            if (PhonemeInfo::TYPE_CONSONANT == type) {
                (*itr)->setCountToNextVowel(count);
             }
             if (0 < count) {
@@ -96,7 +96,7 @@ private:
    List children;
 
    //! language
-   std::string language;
+   PhonemeSymbol language;
 
    //! index in note
    size_t idxInNote;
@@ -105,7 +105,7 @@ private:
    size_t numInNote;
 
    //! language dependent information
-   std::string langDependentInfo;
+   PhonemeSymbol langDependentInfo;
 };
 
 };
@@ -39,6 +39,7 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
+#include <algorithm>
 #include "Note.h"
 
 namespace sinsy
@@ -69,6 +70,49 @@ Note::~Note()
 {
 }
 
+/*!
+ assignment operator
+ */
+Note& Note::operator=(const Note& obj)
+{
+   if (this != &obj) {
+      restNote = obj.restNote;
+      duration = obj.duration;
+      breathMark = obj.breathMark;
+      accent = obj.accent;
+      staccato = obj.staccato;
+      tieStart = obj.tieStart;
+      tieStop = obj.tieStop;
+      slur = obj.slur;
+      slurStart = obj.slurStart;
+      slurStop = obj.slurStop;
+      pitch = obj.pitch;
+      syllabic = obj.syllabic;
+      lyric = obj.lyric;
+   }
+   return *this;
+}
+
+/*!
+ swap contents with another note
+ */
+void Note::swap(Note& obj)
+{
+   std::swap(restNote, obj.restNote);
+   std::swap(duration, obj.duration);
+   std::swap(breathMark, obj.breathMark);
+   std::swap(accent, obj.accent);
+   std::swap(staccato, obj.staccato);
+   std::swap(tieStart, obj.tieStart);
+   std::swap(tieStop, obj.tieStop);
+   slur.swap(obj.slur);
+   std::swap(slurStart, obj.slurStart);
+   std::swap(slurStop, obj.slurStop);
+   std::swap(pitch, obj.pitch);
+   std::swap(syllabic, obj.syllabic);
+   lyric.swap(obj.lyric);
+}
+
 /*!
  set duration
  */
@@ -56,12 +56,18 @@ public:
    //! constructor
    Note();
 
-   //! copy constructor (donot use)
+   //! copy constructor
    Note(const Note& obj);
 
    //! destructor
    virtual ~Note();
 
+   //! assignment operator
+   Note& operator=(const Note& obj);
+
+   //! swap contents with another note (used to move notes without copying lyric or slur)
+   void swap(Note& obj);
+
    //! set duration
    void setDuration(size_t d);
 
@@ -141,9 +147,6 @@ public:
    bool isSlurStop() const;
 
 private:
-   //! assignment operator (donot use)
-   Note& operator=(const Note&);
-
    //! is rest note or not
    bool restNote;
 
@@ -0,0 +1,245 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstring>
+#include "ScoreBinaryReader.h"
+#include "ScoreBinaryWriter.h"
+#include "StreamException.h"
+#include "util_log.h"
+#include "Beat.h"
+#include "Dynamics.h"
+#include "Key.h"
+#include "Mode.h"
+#include "Note.h"
+#include "Syllabic.h"
+
+namespace sinsy
+{
+
+namespace
+{
+const size_t HEADER_SIZE = ScoreBinaryWriter::MAGIC_SIZE + sizeof(UINT32) * 2;
+};
+
+/*!
+ constructor
+ */
+ScoreBinaryReader::ScoreBinaryReader() : current(NULL), end(NULL)
+{
+}
+
+/*!
+ destructor
+ */
+ScoreBinaryReader::~ScoreBinaryReader()
+{
+}
+
+/*!
+ data is binary score or not (only magic number is checked)
+ */
+bool ScoreBinaryReader::isBinary(const char* data, size_t size)
+{
+   return (NULL != data) && (ScoreBinaryWriter::MAGIC_SIZE <= size) &&
+          (0 == memcmp(data, ScoreBinaryWriter::MAGIC, ScoreBinaryWriter::MAGIC_SIZE));
+}
+
+/*!
+ @internal
+
+ read unsigned integer (little endian)
+ */
+UINT64 ScoreBinaryReader::readUInt(size_t size)
+{
+   if (static_cast<size_t>(end - current) < size) {
+      throw StreamException("unexpected end of binary score");
+   }
+   UINT64 value(0);
+   for (size_t i(size); 0 < i; --i) {
+      value = (value << 8) | static_cast<unsigned char>(current[i - 1]);
+   }
+   current += size;
+   return value;
+}
+
+/*!
+ @internal
+
+ read signed integer (little endian)
+ */
+int ScoreBinaryReader::readInt32()
+{
+   return static_cast<int>(static_cast<INT32>(static_cast<UINT32>(readUInt(sizeof(UINT32)))));
+}
+
+/*!
+ @internal
+
+ read string (length prefixed)
+ */
+void ScoreBinaryReader::readString(std::string& str)
+{
+   const size_t size(static_cast<size_t>(readUInt(sizeof(UINT32))));
+   if (static_cast<size_t>(end - current) < size) {
+      throw StreamException("unexpected end of binary score");
+   }
+   str.assign(current, size);
+   current += size;
+}
+
+/*!
+ read binary score from memory and write it to score
+
+ Data is not copied, so it can be mapped memory of binary score file.
+
+ @param data     binary score
+ @param size     size of data
+ @param writable score
+ @return if success, true
+ */
+bool ScoreBinaryReader::readBinary(const char* data, size_t size, IScoreWritable& writable)
+{
+   if (!isBinary(data, size) || (size < HEADER_SIZE)) {
+      ERR_MSG("Data is not binary score");
+      return false;
+   }
+   current = data + ScoreBinaryWriter::MAGIC_SIZE;
+   end = data + size;
+
+   try {
+      const UINT32 version(static_cast<UINT32>(readUInt(sizeof(UINT32))));
+      if (ScoreBinaryWriter::FORMAT_VERSION != version) {
+         ERR_MSG("Unsupported version of binary score : " << version);
+         return false;
+      }
+      const UINT32 eventNum(static_cast<UINT32>(readUInt(sizeof(UINT32))));
+
+      std::string str;
+      Note note;
+      for (UINT32 i(0); i < eventNum; ++i) {
+         const UINT64 type(readUInt(sizeof(UINT8)));
+         switch (type) {
+         case ScoreBinaryWriter::EVENT_ENCODING :
+            readString(str);
+            writable.setEncoding(str);
+            break;
+         case ScoreBinaryWriter::EVENT_TEMPO : {
+            const UINT64 bits(readUInt(sizeof(UINT64)));
+            double tempo(0.0);
+            memcpy(&tempo, &bits, sizeof(tempo));
+            writable.changeTempo(tempo);
+            break;
+         }
+         case ScoreBinaryWriter::EVENT_BEAT : {
+            const size_t beats(static_cast<size_t>(readUInt(sizeof(UINT32))));
+            const size_t beatType(static_cast<size_t>(readUInt(sizeof(UINT32))));
+            writable.changeBeat(Beat(beats, beatType));
+            break;
+         }
+         case ScoreBinaryWriter::EVENT_DYNAMICS :
+            readString(str);
+            writable.changeDynamics(Dynamics(str));
+            break;
+         case ScoreBinaryWriter::EVENT_KEY : {
+            readString(str);
+            const Mode mode(str);
+            writable.changeKey(Key(mode, readInt32()));
+            break;
+         }
+         case ScoreBinaryWriter::EVENT_CRESCENDO_START :
+            writable.startCrescendo();
+            break;
+         case ScoreBinaryWriter::EVENT_DIMINUENDO_START :
+            writable.startDiminuendo();
+            break;
+         case ScoreBinaryWriter::EVENT_CRESCENDO_STOP :
+            writable.stopCrescendo();
+            break;
+         case ScoreBinaryWriter::EVENT_DIMINUENDO_STOP :
+            writable.stopDiminuendo();
+            break;
+         case ScoreBinaryWriter::EVENT_NOTE : {
+            const UINT64 flags(readUInt(sizeof(UINT16)));
+            note.setDuration(static_cast<size_t>(readUInt(sizeof(UINT32))));
+            const int step(readInt32());
+            const int octave(readInt32());
+            note.setPitch(Pitch(step, octave));
+            readString(str);
+            note.setLyric(str);
+            note.setRest(0 != (flags & ScoreBinaryWriter::NOTE_REST));
+            note.setBreathMark(0 != (flags & ScoreBinaryWriter::NOTE_BREATH_MARK));
+            note.setAccent(0 != (flags & ScoreBinaryWriter::NOTE_ACCENT));
+            note.setStaccato(0 != (flags & ScoreBinaryWriter::NOTE_STACCATO));
+            note.setTieStart(0 != (flags & ScoreBinaryWriter::NOTE_TIE_START));
+            note.setTieStop(0 != (flags & ScoreBinaryWriter::NOTE_TIE_STOP));
+            note.setSlurStart(0 != (flags & ScoreBinaryWriter::NOTE_SLUR_START));
+            note.setSlurStop(0 != (flags & ScoreBinaryWriter::NOTE_SLUR_STOP));
+            switch ((flags & ScoreBinaryWriter::NOTE_SYLLABIC_MASK) >> ScoreBinaryWriter::NOTE_SYLLABIC_SHIFT) {
+            case 1 :
+               note.setSyllabic(Syllabic::BEGIN);
+               break;
+            case 2 :
+               note.setSyllabic(Syllabic::END);
+               break;
+            case 3 :
+               note.setSyllabic(Syllabic::MIDDLE);
+               break;
+            default :
+               note.setSyllabic(Syllabic::SINGLE);
+               break;
+            }
+            writable.addNote(note);
+            break;
+         }
+         default :
+            throw StreamException("unknown event in binary score");
+         }
+      }
+      if (current != end) {
+         throw StreamException("extra data after events in binary score");
+      }
+   } catch (const StreamException& ex) {
+      ERR_MSG("Binary score reading error : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+};  // namespace sinsy
@@ -0,0 +1,270 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstring>
+#include <stdexcept>
+#include "ScoreBinaryWriter.h"
+#include "IWritableStream.h"
+#include "util_log.h"
+#include "Beat.h"
+#include "Dynamics.h"
+#include "Key.h"
+#include "Note.h"
+
+namespace sinsy
+{
+
+namespace
+{
+/*!
+ append unsigned integer (little endian)
+ */
+void appendUInt(std::string& str, UINT64 value, size_t size)
+{
+   for (size_t i(0); i < size; ++i) {
+      str.push_back(static_cast<char>(value & 0xFF));
+      value >>= 8;
+   }
+}
+
+/*!
+ append signed integer (little endian)
+ */
+void appendInt32(std::string& str, int value)
+{
+   appendUInt(str, static_cast<UINT32>(value), sizeof(UINT32));
+}
+
+/*!
+ append string (length prefixed)
+ */
+void appendString(std::string& str, const std::string& value)
+{
+   if (0xFFFFFFFFUL < value.size()) {
+      throw std::runtime_error("ScoreBinaryWriter : string is too long");
+   }
+   appendUInt(str, value.size(), sizeof(UINT32));
+   str.append(value);
+}
+
+/*!
+ get code of syllabic
+ */
+UINT16 getSyllabicCode(const Syllabic& syllabic)
+{
+   if (Syllabic::BEGIN == syllabic) {
+      return 1;
+   } else if (Syllabic::END == syllabic) {
+      return 2;
+   } else if (Syllabic::MIDDLE == syllabic) {
+      return 3;
+   }
+   return 0;
+}
+
+};
+
+const char ScoreBinaryWriter::MAGIC[] = "SINSYSCR";
+const size_t ScoreBinaryWriter::MAGIC_SIZE = sizeof(ScoreBinaryWriter::MAGIC) - 1;
+const UINT32 ScoreBinaryWriter::FORMAT_VERSION = 1;
+
+/*!
+ constructor
+ */
+ScoreBinaryWriter::ScoreBinaryWriter() : eventNum(0)
+{
+}
+
+/*!
+ destructor
+ */
+ScoreBinaryWriter::~ScoreBinaryWriter()
+{
+}
+
+/*!
+ clear
+ */
+void ScoreBinaryWriter::clear()
+{
+   events.clear();
+   eventNum = 0;
+}
+
+/*!
+ @internal
+
+ start event
+ */
+void ScoreBinaryWriter::startEvent(EventType type)
+{
+   events.push_back(static_cast<char>(type));
+   ++eventNum;
+}
+
+/*!
+ set encoding
+ */
+void ScoreBinaryWriter::setEncoding(const std::string& encoding)
+{
+   startEvent(EVENT_ENCODING);
+   appendString(events, encoding);
+}
+
+/*!
+ change tempo
+ */
+void ScoreBinaryWriter::changeTempo(double tempo)
+{
+   UINT64 bits(0);
+   memcpy(&bits, &tempo, sizeof(bits));
+   startEvent(EVENT_TEMPO);
+   appendUInt(events, bits, sizeof(UINT64));
+}
+
+/*!
+ change beat
+ */
+void ScoreBinaryWriter::changeBeat(const Beat& beat)
+{
+   startEvent(EVENT_BEAT);
+   appendUInt(events, beat.getBeats(), sizeof(UINT32));
+   appendUInt(events, beat.getBeatType(), sizeof(UINT32));
+}
+
+/*!
+ change dynamics
+ */
+void ScoreBinaryWriter::changeDynamics(const Dynamics& dynamics)
+{
+   startEvent(EVENT_DYNAMICS);
+   appendString(events, dynamics.getStr());
+}
+
+/*!
+ change key
+ */
+void ScoreBinaryWriter::changeKey(const Key& key)
+{
+   startEvent(EVENT_KEY);
+   appendString(events, key.getMode().get());
+   appendInt32(events, key.getOrigFifths());
+}
+
+/*!
+ start crescendo
+ */
+void ScoreBinaryWriter::startCrescendo()
+{
+   startEvent(EVENT_CRESCENDO_START);
+}
+
+/*!
+ start diminuendo
+ */
+void ScoreBinaryWriter::startDiminuendo()
+{
+   startEvent(EVENT_DIMINUENDO_START);
+}
+
+/*!
+ stop crescendo
+ */
+void ScoreBinaryWriter::stopCrescendo()
+{
+   startEvent(EVENT_CRESCENDO_STOP);
+}
+
+/*!
+ stop diminuendo
+ */
+void ScoreBinaryWriter::stopDiminuendo()
+{
+   startEvent(EVENT_DIMINUENDO_STOP);
+}
+
+/*!
+ add note
+
+ Numbers of slurs are not stored because ScoreDoctor has already
+ replaced them with slur start and stop flags.
+ */
+void ScoreBinaryWriter::addNote(const Note& note)
+{
+   UINT16 flags(getSyllabicCode(note.getSyllabic()) << NOTE_SYLLABIC_SHIFT);
+   if (note.isRest()) flags |= NOTE_REST;
+   if (note.hasBreathMark()) flags |= NOTE_BREATH_MARK;
+   if (note.hasAccent()) flags |= NOTE_ACCENT;
+   if (note.hasStaccato()) flags |= NOTE_STACCATO;
+   if (note.isTieStart()) flags |= NOTE_TIE_START;
+   if (note.isTieStop()) flags |= NOTE_TIE_STOP;
+   if (note.isSlurStart()) flags |= NOTE_SLUR_START;
+   if (note.isSlurStop()) flags |= NOTE_SLUR_STOP;
+
+   startEvent(EVENT_NOTE);
+   appendUInt(events, flags, sizeof(UINT16));
+   appendUInt(events, note.getDuration(), sizeof(UINT32));
+   appendInt32(events, note.getPitch().getStep());
+   appendInt32(events, note.getPitch().getOctave());
+   appendString(events, note.getLyric());
+}
+
+/*!
+ write binary score to stream
+ */
+bool ScoreBinaryWriter::writeBinary(IWritableStream& stream) const
+{
+   std::string header(MAGIC, MAGIC_SIZE);
+   appendUInt(header, FORMAT_VERSION, sizeof(UINT32));
+   appendUInt(header, eventNum, sizeof(UINT32));
+   try {
+      if ((header.size() != stream.write(header.data(), header.size())) ||
+            (!events.empty() && (events.size() != stream.write(events.data(), events.size())))) {
+         ERR_MSG("Cannot write binary score");
+         return false;
+      }
+   } catch (const StreamException& ex) {
+      ERR_MSG("Binary score writing error : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
+};  // namespace sinsy
@@ -0,0 +1,165 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_SCORE_BINARY_WRITER_H_
+#define SINSY_SCORE_BINARY_WRITER_H_
+
+#include <string>
+#include "util_types.h"
+#include "IScoreWritable.h"
+
+namespace sinsy
+{
+
+class IWritableStream;
+
+/*!
+ Writer of binary score
+
+ Events of score are stored in the order they are written.
+ All values are little endian and every string is prefixed by its length,
+ so that binary score can be read directly from mapped memory.
+
+ header : magic "SINSYSCR" (8 bytes), version (UINT32), number of events (UINT32)
+ events : type (UINT8) followed by its values
+ */
+class ScoreBinaryWriter : public IScoreWritable
+{
+public:
+   //! magic number
+   static const char MAGIC[];
+
+   //! size of magic number
+   static const size_t MAGIC_SIZE;
+
+   //! version of binary score
+   static const UINT32 FORMAT_VERSION;
+
+   //! type of event
+   enum EventType {
+      EVENT_ENCODING = 0,       //!< encoding (string)
+      EVENT_TEMPO = 1,          //!< tempo (double)
+      EVENT_BEAT = 2,           //!< beats, beat type (UINT32 x 2)
+      EVENT_DYNAMICS = 3,       //!< dynamics (string)
+      EVENT_KEY = 4,            //!< mode (string), fifths (INT32)
+      EVENT_CRESCENDO_START = 5,
+      EVENT_DIMINUENDO_START = 6,
+      EVENT_CRESCENDO_STOP = 7,
+      EVENT_DIMINUENDO_STOP = 8,
+      EVENT_NOTE = 9,           //!< flags (UINT16), duration (UINT32), step, octave (INT32 x 2), lyric (string)
+      EVENT_TYPE_NUM = 10
+   };
+
+   //! flags of note
+   enum NoteFlag {
+      NOTE_REST = 0x0001,
+      NOTE_BREATH_MARK = 0x0002,
+      NOTE_ACCENT = 0x0004,
+      NOTE_STACCATO = 0x0008,
+      NOTE_TIE_START = 0x0010,
+      NOTE_TIE_STOP = 0x0020,
+      NOTE_SLUR_START = 0x0040,
+      NOTE_SLUR_STOP = 0x0080,
+      NOTE_SYLLABIC_SHIFT = 8,  //!< syllabic is stored in bit 8 and 9 (single, begin, end, middle)
+      NOTE_SYLLABIC_MASK = 0x0300
+   };
+
+   //! constructor
+   ScoreBinaryWriter();
+
+   //! destructor
+   virtual ~ScoreBinaryWriter();
+
+   //! clear
+   void clear();
+
+   //! set encoding
+   virtual void setEncoding(const std::string& encoding);
+
+   //! change tempo
+   virtual void changeTempo(double tempo);
+
+   //! change beat
+   virtual void changeBeat(const Beat& beat);
+
+   //! change dynamics
+   virtual void changeDynamics(const Dynamics& dynamics);
+
+   //! change key
+   virtual void changeKey(const Key& key);
+
+   //! start crescendo
+   virtual void startCrescendo();
+
+   //! start diminuendo
+   virtual void startDiminuendo();
+
+   //! stop crescendo
+   virtual void stopCrescendo();
+
+   //! stop diminuendo
+   virtual void stopDiminuendo();
+
+   //! add note
+   virtual void addNote(const Note& note);
+
+   //! write binary score to stream
+   bool writeBinary(IWritableStream& stream) const;
+
+private:
+   //! copy constructor (donot use)
+   ScoreBinaryWriter(const ScoreBinaryWriter&);
+
+   //! assignment operator (donot use)
+   ScoreBinaryWriter& operator=(const ScoreBinaryWriter&);
+
+   //! start event
+   void startEvent(EventType type);
+
+   //! events
+   std::string events;
+
+   //! number of events
+   UINT32 eventNum;
+};
+
+};
+
+#endif // SINSY_SCORE_BINARY_WRITER_H_
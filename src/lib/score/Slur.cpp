@@ -162,6 +162,15 @@ void Slur::clear()
    stopNumberList.clear();
 }
 
+/*!
+ swap contents with another slur
+ */
+void Slur::swap(Slur& obj)
+{
+   startNumberList.swap(obj.startNumberList);
+   stopNumberList.swap(obj.stopNumberList);
+}
+
 /*!
  to stream
  */
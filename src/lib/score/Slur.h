@@ -80,6 +80,9 @@ public:
    //! clear
    void clear();
 
+   //! swap contents with another slur
+   void swap(Slur& obj);
+
 private:
    //! remove from start number list
    bool removeFromStartNumberList(int number);
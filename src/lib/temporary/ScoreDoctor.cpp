@@ -76,7 +76,7 @@ void convertApostrophe(Note& note)
 /*!
  constructor
  */
-ScoreDoctor::ScoreDoctor() : lastTiedNote(NULL), inTie(false)
+ScoreDoctor::ScoreDoctor() : lastTiedNote(0), inTie(false)
 {
 }
 
@@ -87,6 +87,17 @@ ScoreDoctor::~ScoreDoctor()
 {
 }
 
+/*!
+ clear
+ */
+void ScoreDoctor::clear()
+{
+   TempScore::clear();
+   lastTiedNote = 0;
+   inTie = false;
+   slur.clear();
+}
+
 /*!
  add note
  */
@@ -118,29 +129,27 @@ void ScoreDoctor::addNote(const Note& n)
 
    // tie
    if (inTie) {
-      if (note.isRest() || (lastTiedNote->getNote().getPitch() != note.getPitch())) {
-         if (lastTiedNote->getNote().isTieStart()) {
-            lastTiedNote->getNote().setTieStart(false);
+      Note& tiedNote(getNote(lastTiedNote));
+      if (note.isRest() || (tiedNote.getPitch() != note.getPitch())) {
+         if (tiedNote.isTieStart()) {
+            tiedNote.setTieStart(false);
          } else {
-            lastTiedNote->getNote().setTieStop(true);
+            tiedNote.setTieStop(true);
          }
          inTie = false;
-         lastTiedNote = NULL;
       }
    }
    if (note.isTieStop()) {
       inTie = false;
-      lastTiedNote = NULL;
    }
-   NoteAdder* na = new NoteAdder(note);
    if (note.isTieStart()) {
       inTie = true;
    }
+
+   const size_t idx(moveNote(note));
    if (inTie) {
-      lastTiedNote = na;
+      lastTiedNote = idx;
    }
-
-   tempList.push_back(na);
 }
 
 };  // namespace sinsy
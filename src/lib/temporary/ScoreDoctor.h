@@ -58,12 +58,21 @@ public:
    //! destructor
    virtual ~ScoreDoctor();
 
+   //! clear
+   virtual void clear();
+
    //! add note
    virtual void addNote(const Note&);
 
 private:
-   //! last tied note
-   NoteAdder* lastTiedNote;
+   //! copy constructor (donot use)
+   ScoreDoctor(const ScoreDoctor&);
+
+   //! assignment operator (donot use)
+   ScoreDoctor& operator=(const ScoreDoctor&);
+
+   //! index of last tied note (valid only in tie)
+   size_t lastTiedNote;
 
    //! in tie or not
    bool inTie;
@@ -40,14 +40,17 @@
 /* ----------------------------------------------------------------- */
 
 #include <algorithm>
-
 #include "TempScore.h"
-#include "util_score.h"
-#include "Deleter.h"
+#include "util_log.h"
 
 namespace sinsy
 {
 
+namespace
+{
+const size_t MIN_NOTE_CAPACITY = 64;
+};
+
 /*!
  constructor
  */
@@ -59,7 +62,6 @@ TempScore::TempScore()
  */
 TempScore::~TempScore()
 {
-   clear();
 }
 
 /*!
@@ -67,8 +69,13 @@ TempScore::~TempScore()
  */
 void TempScore::clear()
 {
-   std::for_each(tempList.begin(), tempList.end(), Deleter<ITempData>());
-   tempList.clear();
+   events.clear();
+   notes.clear();
+   lyricArena.clear();
+   encodings.clear();
+   beats.clear();
+   dynamics.clear();
+   keys.clear();
 }
 
 /*!
@@ -76,7 +83,53 @@ void TempScore::clear()
  */
 void TempScore::write(IScoreWritable& sm) const
 {
-   std::for_each(tempList.begin(), tempList.end(), DataSetter(sm));
+   // notes are restored into one buffer so that their allocations are reused
+   Note note;
+   std::string lyric;
+
+   const std::vector<Event>::const_iterator itrEnd(events.end());
+   for (std::vector<Event>::const_iterator itr(events.begin()); itrEnd != itr; ++itr) {
+      switch (itr->type) {
+      case EVENT_ENCODING:
+         sm.setEncoding(encodings[itr->index]);
+         break;
+      case EVENT_TEMPO:
+         sm.changeTempo(itr->tempo);
+         break;
+      case EVENT_BEAT:
+         sm.changeBeat(beats[itr->index]);
+         break;
+      case EVENT_DYNAMICS:
+         sm.changeDynamics(dynamics[itr->index]);
+         break;
+      case EVENT_KEY:
+         sm.changeKey(keys[itr->index]);
+         break;
+      case EVENT_CRESCENDO_START:
+         sm.startCrescendo();
+         break;
+      case EVENT_CRESCENDO_STOP:
+         sm.stopCrescendo();
+         break;
+      case EVENT_DIMINUENDO_START:
+         sm.startDiminuendo();
+         break;
+      case EVENT_DIMINUENDO_STOP:
+         sm.stopDiminuendo();
+         break;
+      case EVENT_NOTE: {
+         const StoredNote& stored(notes[itr->index]);
+         note = stored.note;
+         lyric.assign(lyricArena, stored.lyricBegin, stored.lyricSize);
+         note.setLyric(lyric);
+         writeNote(sm, note);
+         break;
+      }
+      default:
+         ERR_MSG("Unknown event type : " << itr->type);
+         break;
+      }
+   }
 }
 
 /*!
@@ -84,7 +137,8 @@ void TempScore::write(IScoreWritable& sm) const
  */
 void TempScore::setEncoding(const std::string& e)
 {
-   tempList.push_back(new EncodingSetter(e));
+   pushEvent(EVENT_ENCODING, encodings.size());
+   encodings.push_back(e);
 }
 
 /*!
@@ -92,7 +146,10 @@ void TempScore::setEncoding(const std::string& e)
  */
 void TempScore::changeTempo(double d)
 {
-   tempList.push_back(new TempoChanger(d));
+   Event event;
+   event.type = EVENT_TEMPO;
+   event.tempo = d;
+   events.push_back(event);
 }
 
 /*!
@@ -100,7 +157,8 @@ void TempScore::changeTempo(double d)
  */
 void TempScore::changeBeat(const Beat& b)
 {
-   tempList.push_back(new BeatChanger(b));
+   pushEvent(EVENT_BEAT, beats.size());
+   beats.push_back(b);
 }
 
 /*!
@@ -108,7 +166,8 @@ void TempScore::changeBeat(const Beat& b)
  */
 void TempScore::changeDynamics(const Dynamics& d)
 {
-   tempList.push_back(new DynamicsChanger(d));
+   pushEvent(EVENT_DYNAMICS, dynamics.size());
+   dynamics.push_back(d);
 }
 
 /*!
@@ -116,7 +175,8 @@ void TempScore::changeDynamics(const Dynamics& d)
  */
 void TempScore::changeKey(const Key& k)
 {
-   tempList.push_back(new KeyChanger(k));
+   pushEvent(EVENT_KEY, keys.size());
+   keys.push_back(k);
 }
 
 /*!
@@ -124,7 +184,7 @@ void TempScore::changeKey(const Key& k)
  */
 void TempScore::startCrescendo()
 {
-   tempList.push_back(new CrescendoStarter());
+   pushEvent(EVENT_CRESCENDO_START, 0);
 }
 
 /*!
@@ -132,7 +192,7 @@ void TempScore::startCrescendo()
  */
 void TempScore::startDiminuendo()
 {
-   tempList.push_back(new DiminuendoStarter());
+   pushEvent(EVENT_DIMINUENDO_START, 0);
 }
 
 /*!
@@ -140,7 +200,7 @@ void TempScore::startDiminuendo()
  */
 void TempScore::stopCrescendo()
 {
-   tempList.push_back(new CrescendoStopper());
+   pushEvent(EVENT_CRESCENDO_STOP, 0);
 }
 
 /*!
@@ -148,7 +208,7 @@ void TempScore::stopCrescendo()
  */
 void TempScore::stopDiminuendo()
 {
-   tempList.push_back(new DiminuendoStopper());
+   pushEvent(EVENT_DIMINUENDO_STOP, 0);
 }
 
 /*!
@@ -156,260 +216,89 @@ void TempScore::stopDiminuendo()
  */
 void TempScore::addNote(const Note& n)
 {
-   tempList.push_back(new NoteAdder(n));
-}
-
-/*!
- constructor
- */
-TempScore::EncodingSetter::EncodingSetter(const std::string& e) : encoding(e)
-{
-}
-
-/*!
- destructor
- */
-TempScore::EncodingSetter::~EncodingSetter()
-{
-}
-
-/*!
- write
- */
-void TempScore::EncodingSetter::write(IScoreWritable& sm) const
-{
-   sm.setEncoding(encoding);
-}
-
-/*!
- constructor
- */
-TempScore::NoteAdder::NoteAdder(const Note& n) : note(n)
-{
-}
-
-/*!
- destructor
- */
-TempScore::NoteAdder::~NoteAdder()
-{
-}
-
-/*!
- write
- */
-void TempScore::NoteAdder::write(IScoreWritable& sm) const
-{
-   sm.addNote(note);
-}
-
-//! get note
-const Note& TempScore::NoteAdder::getNote() const
-{
-   return note;
-}
-
-//! get note
-Note& TempScore::NoteAdder::getNote()
-{
-   return note;
-}
-
-/*!
- constructor
- */
-TempScore::TempoChanger::TempoChanger(double t) : tempo(t)
-{
-}
-
-/*!
- destructor
- */
-TempScore::TempoChanger::~TempoChanger()
-{
+   Note note(n);
+   moveNote(note);
 }
 
 /*!
- write
- */
-void TempScore::TempoChanger::write(IScoreWritable& sm) const
-{
-   sm.changeTempo(tempo);
-}
-
-/*!
- constructor
- */
-TempScore::BeatChanger::BeatChanger(const Beat& b) : beat(b)
-{
-}
+ move note into this score
 
-/*!
- destructor
- */
-TempScore::BeatChanger::~BeatChanger()
-{
-}
+ The lyric is appended to the lyric arena and the other members are swapped
+ into the note list, so no allocation occurs except for growth of the lists
+ (stored notes are also swapped into the grown list).
 
-/*!
- write
+ @param note note (left empty)
+ @return index of the note
  */
-void TempScore::BeatChanger::write(IScoreWritable& sm) const
+size_t TempScore::moveNote(Note& note)
 {
-   sm.changeBeat(beat);
+   const size_t idx(notes.size());
+   if (notes.capacity() == idx) {
+      // notes are swapped into larger list instead of being copied
+      std::vector<StoredNote> grown;
+      grown.reserve(std::max<size_t>(idx * 2, MIN_NOTE_CAPACITY));
+      grown.resize(idx + 1);
+      for (size_t i(0); i < idx; ++i) {
+         grown[i].note.swap(notes[i].note);
+         grown[i].lyricBegin = notes[i].lyricBegin;
+         grown[i].lyricSize = notes[i].lyricSize;
+      }
+      notes.swap(grown);
+   } else {
+      notes.resize(idx + 1);
+   }
+   StoredNote& stored(notes.back());
+   stored.lyricBegin = lyricArena.size();
+   stored.lyricSize = note.getLyric().size();
+   lyricArena.append(note.getLyric());
+   note.setLyric(NULL_STR);
+   stored.note.swap(note);
+   pushEvent(EVENT_NOTE, idx);
+   return idx;
 }
 
 /*!
- constructor
+ get number of notes
  */
-TempScore::DynamicsChanger::DynamicsChanger(const Dynamics& d) : dynamics(d)
+size_t TempScore::getNoteNum() const
 {
+   return notes.size();
 }
 
 /*!
- destructor
+ get note
  */
-TempScore::DynamicsChanger::~DynamicsChanger()
+const Note& TempScore::getNote(size_t idx) const
 {
+   return notes[idx].note;
 }
 
 /*!
- write
+ get note
  */
-void TempScore::DynamicsChanger::write(IScoreWritable& sm) const
+Note& TempScore::getNote(size_t idx)
 {
-   sm.changeDynamics(dynamics);
+   return notes[idx].note;
 }
 
 /*!
- constructor
+ write note
  */
-TempScore::KeyChanger::KeyChanger(const Key& k) : key(k)
-{}
-
-/*!
- destructor
- */
-TempScore::KeyChanger::~KeyChanger()
-{
-}
-
-/*!
- write
- */
-void TempScore::KeyChanger::write(IScoreWritable& sm) const
-{
-   sm.changeKey(key);
-}
-
-/*!
- constructor
- */
-TempScore::CrescendoStarter::CrescendoStarter()
-{
-}
-
-/*!
- destructor
- */
-TempScore::CrescendoStarter::~CrescendoStarter()
-{
-}
-
-/*!
- write
- */
-void TempScore::CrescendoStarter::write(IScoreWritable& sm) const
-{
-   sm.startCrescendo();
-}
-
-/*!
- constructor
- */
-TempScore::CrescendoStopper::CrescendoStopper()
-{
-}
-
-/*!
- destructor
- */
-TempScore::CrescendoStopper::~CrescendoStopper()
-{
-}
-
-/*!
- write
- */
-void TempScore::CrescendoStopper::write(IScoreWritable& sm) const
-{
-   sm.stopCrescendo();
-}
-
-/*!
- constructor
- */
-TempScore::DiminuendoStarter::DiminuendoStarter()
-{
-}
-
-/*!
- destructor
- */
-TempScore::DiminuendoStarter::~DiminuendoStarter()
-{
-}
-
-/*!
- write
- */
-void TempScore::DiminuendoStarter::write(IScoreWritable& sm) const
-{
-   sm.startDiminuendo();
-}
-
-/*!
- constructor
- */
-TempScore::DiminuendoStopper::DiminuendoStopper()
-{
-}
-
-/*!
- destructor
- */
-TempScore::DiminuendoStopper::~DiminuendoStopper()
-{
-}
-
-/*!
- write
- */
-void TempScore::DiminuendoStopper::write(IScoreWritable& sm) const
-{
-   sm.stopDiminuendo();
-}
-
-/*!
- constructor
- */
-TempScore::DataSetter::DataSetter(IScoreWritable& sm) : maker(sm)
-{
-}
-
-/*!
- destructor
- */
-TempScore::DataSetter::~DataSetter()
+void TempScore::writeNote(IScoreWritable& sm, const Note& note) const
 {
+   sm.addNote(note);
 }
 
 /*!
- ...
+ @internal
+ push event
  */
-void TempScore::DataSetter::operator()(const ITempData* data)
+void TempScore::pushEvent(EventType type, size_t index)
 {
-   maker << *data;
+   Event event;
+   event.type = type;
+   event.index = index;
+   events.push_back(event);
 }
 
 };  // namespace sinsy
@@ -42,6 +42,7 @@
 #ifndef SINSY_TEMP_SCORE_H_
 #define SINSY_TEMP_SCORE_H_
 
+#include <string>
 #include <vector>
 #include "util_string.h"
 #include "IScoreWritable.h"
@@ -57,23 +58,13 @@ namespace sinsy
 class TempScore : public IScoreWritable, public IScoreWriter
 {
 public:
-   class ITempData : public IScoreWriter
-   {
-   public:
-      //! destructor
-      virtual ~ITempData() {}
-
-      //! write
-      virtual void write(IScoreWritable&) const = 0;
-   };
-
    //! constructor
    TempScore();
 
    //! destructor
    virtual ~TempScore();
 
-   //! clear
+   //! clear (capacities of internal buffers are kept for reuse)
    virtual void clear();
 
    //! write
@@ -109,261 +100,93 @@ public:
    //! add note
    virtual void addNote(const Note&);
 
-protected:
-   typedef std::vector<ITempData*> TempList;
-
-   //! list of temporaries
-   TempList tempList;
-
-   class EncodingSetter : public ITempData
-   {
-   public:
-      //! constructor
-      explicit EncodingSetter(const std::string& e);
-
-      //! destructor
-      virtual ~EncodingSetter();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
-
-   private:
-      //! copy constructor (donot use)
-      EncodingSetter(const EncodingSetter&);
-
-      //! assignment operator (donot use)
-      EncodingSetter& operator=(const EncodingSetter&);
-
-      //! encoding
-      const std::string encoding;
-   };
-
-   class NoteAdder : public ITempData
-   {
-   public:
-      //! constructor
-      explicit NoteAdder(const Note& n);
-
-      //! destructor
-      virtual ~NoteAdder();
-
-      //! wtrite
-      virtual void write(IScoreWritable& sm) const;
-
-      //! get note
-      const Note& getNote() const;
-
-      //! get note
-      Note& getNote();
-
-   private:
-      //! copy constructor (donot use)
-      NoteAdder(const NoteAdder&);
-
-      //! assignment operator (donot use)
-      NoteAdder& operator=(const NoteAdder&);
-
-      //! note
-      Note note;
-   };
-
-   class TempoChanger : public ITempData
-   {
-   public:
-      //! constructor
-      explicit TempoChanger(double t);
-
-      //! destructor
-      virtual ~TempoChanger();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
-
-   private:
-      //! copy constructor (donot use)
-      TempoChanger(const TempoChanger&);
-
-      //! assignment operator (donot use)
-      TempoChanger& operator=(const TempoChanger&);
-
-      //! tempo
-      double tempo;
-   };
-
-   class BeatChanger : public ITempData
-   {
-   public:
-      //! constructor
-      explicit BeatChanger(const Beat& b);
-
-      //! destructor
-      virtual ~BeatChanger();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
-
-   private:
-      //! copy constructor (donot use)
-      BeatChanger(const BeatChanger&);
-
-      //! assignment operator (donot use)
-      BeatChanger& operator=(const BeatChanger&);
-
-      //! beat
-      Beat beat;
-   };
+   //! move note into this score (given note is left empty) and return its index
+   size_t moveNote(Note& note);
 
-   class DynamicsChanger : public ITempData
-   {
-   public:
-      //! constructor
-      explicit DynamicsChanger(const Dynamics& d);
-
-      //! destructor
-      virtual ~DynamicsChanger();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
-
-   private:
-      //! copy constructor (donot use)
-      DynamicsChanger(const DynamicsChanger&);
-
-      //! assignment operator (donot use)
-      DynamicsChanger& operator=(const DynamicsChanger&);
-
-      //! dynamics
-      Dynamics dynamics;
-   };
-
-   class KeyChanger : public ITempData
-   {
-   public:
-      //! constructor
-      explicit KeyChanger(const Key& k);
-
-      //! destructor
-      virtual ~KeyChanger();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
-
-   private:
-      //! copy constructor (donot use)
-      KeyChanger(const KeyChanger&);
-
-      //! assignment operator (donot use)
-      KeyChanger& operator=(const KeyChanger&);
-
-      //! key
-      Key key;
-   };
-
-   class CrescendoStarter : public ITempData
-   {
-   public:
-      //! constructor
-      CrescendoStarter();
-
-      //! destructor
-      virtual ~CrescendoStarter();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
+protected:
 
-   private:
-      //! copy constructor (donot use)
-      CrescendoStarter(const CrescendoStarter&);
+   //! get number of notes
+   size_t getNoteNum() const;
 
-      //! assignment operator (donot use)
-      CrescendoStarter& operator=(const CrescendoStarter&);
-   };
+   //! get note (lyric of returned note is always empty)
+   const Note& getNote(size_t idx) const;
 
-   class CrescendoStopper : public ITempData
-   {
-   public:
-      //! constructor
-      CrescendoStopper();
+   //! get note (lyric of returned note is always empty)
+   Note& getNote(size_t idx);
 
-      //! destructor
-      virtual ~CrescendoStopper();
+   //! write note
+   virtual void writeNote(IScoreWritable& sm, const Note& note) const;
 
-      //! write
-      virtual void write(IScoreWritable& sm) const;
+private:
+   //! copy constructor (donot use)
+   TempScore(const TempScore&);
 
-   private:
-      //! copy constructor (donot use)
-      CrescendoStopper(const CrescendoStopper&);
+   //! assignment operator (donot use)
+   TempScore& operator=(const TempScore&);
 
-      //! assignment operator (donot use)
-      CrescendoStopper& operator=(const CrescendoStopper&);
+   //! type of event
+   enum EventType {
+      EVENT_ENCODING,
+      EVENT_TEMPO,
+      EVENT_BEAT,
+      EVENT_DYNAMICS,
+      EVENT_KEY,
+      EVENT_CRESCENDO_START,
+      EVENT_CRESCENDO_STOP,
+      EVENT_DIMINUENDO_START,
+      EVENT_DIMINUENDO_STOP,
+      EVENT_NOTE
    };
 
-   class DiminuendoStarter : public ITempData
-   {
-   public:
-      //! constructor
-      DiminuendoStarter();
-
-      //! destructor
-      virtual ~DiminuendoStarter();
+   //! event
+   struct Event {
+      //! type
+      EventType type;
 
-      //! write
-      virtual void write(IScoreWritable& sm) const;
+      union {
+         //! tempo (EVENT_TEMPO)
+         double tempo;
 
-   private:
-      //! copy constructor (donot use)
-      DiminuendoStarter(const DiminuendoStarter&);
-
-      //! assignment operator (donot use)
-      DiminuendoStarter& operator=(const DiminuendoStarter&);
+         //! index in the list of its type (EVENT_ENCODING, EVENT_BEAT, EVENT_DYNAMICS, EVENT_KEY, EVENT_NOTE)
+         size_t index;
+      };
    };
 
-   class DiminuendoStopper : public ITempData
-   {
-   public:
-      //! constructor
-      DiminuendoStopper();
-
-      //! destructor
-      virtual ~DiminuendoStopper();
-
-      //! write
-      virtual void write(IScoreWritable& sm) const;
+   //! note whose lyric is held in lyric arena
+   struct StoredNote {
+      //! note (lyric is empty)
+      Note note;
 
-   private:
-      //! copy constructor (donot use)
-      DiminuendoStopper(const DiminuendoStopper&);
+      //! begin of lyric in lyric arena
+      size_t lyricBegin;
 
-      //! assignment operator (donot use)
-      DiminuendoStopper& operator=(const DiminuendoStopper&);
+      //! size of lyric
+      size_t lyricSize;
    };
 
+   //! push event
+   void pushEvent(EventType type, size_t index);
 
-private:
-   //! copy constructor (donot use)
-   TempScore(const TempScore&);
+   //! list of events
+   std::vector<Event> events;
 
-   //! assignment operator (donot use)
-   TempScore& operator=(const TempScore&);
+   //! list of notes
+   std::vector<StoredNote> notes;
 
+   //! lyrics of all notes
+   std::string lyricArena;
 
-   class DataSetter
-   {
-   public:
-      //! constructor
-      explicit DataSetter(IScoreWritable& sm);
+   //! list of encodings
+   std::vector<std::string> encodings;
 
-      //! destructor
-      virtual ~DataSetter();
+   //! list of beats
+   std::vector<Beat> beats;
 
-      //! ...
-      void operator()(const ITempData* data);
+   //! list of dynamics
+   std::vector<Dynamics> dynamics;
 
-   private:
-      //! maker
-      IScoreWritable& maker;
-   };
+   //! list of keys
+   std::vector<Key> keys;
 };
 
 };
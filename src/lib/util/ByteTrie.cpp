@@ -0,0 +1,286 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <algorithm>
+#include "StreamException.h"
+#include "ByteTrie.h"
+
+namespace sinsy
+{
+
+const size_t ByteTrie::NO_NODE = static_cast<size_t>(-1);
+const size_t ByteTrie::NO_VALUE = static_cast<size_t>(-1);
+
+namespace
+{
+const size_t NODE_SIZE = 3;
+const size_t NODE_EDGE_BEGIN = 0;
+const size_t NODE_EDGE_END = 1;
+const size_t NODE_VALUE = 2;
+const UINT32 STORED_NO_VALUE = 0xFFFFFFFF;
+};
+
+/*!
+ constructor
+ */
+ByteTrie::ByteTrie() : nodes(NULL), nodeNum(0), edgeBytes(NULL), edgeTargets(NULL), edgeNum(0)
+{
+}
+
+/*!
+ destructor
+ */
+ByteTrie::~ByteTrie()
+{
+}
+
+/*!
+ clear
+ */
+void ByteTrie::clear()
+{
+   ownedNodes.clear();
+   ownedEdgeBytes.clear();
+   ownedEdgeTargets.clear();
+   attachOwned();
+}
+
+/*!
+ @internal
+
+ use owned arrays
+ */
+void ByteTrie::attachOwned()
+{
+   nodeNum = ownedNodes.size() / NODE_SIZE;
+   nodes = ownedNodes.empty() ? NULL : &ownedNodes[0];
+   edgeNum = ownedEdgeTargets.size();
+   edgeBytes = ownedEdgeBytes.empty() ? NULL : &ownedEdgeBytes[0];
+   edgeTargets = ownedEdgeTargets.empty() ? NULL : &ownedEdgeTargets[0];
+}
+
+/*!
+ build from pairs of key and value
+
+ @param keys pairs of key and value (sorted by this function)
+ */
+void ByteTrie::build(KeyList& keys)
+{
+   clear();
+   std::sort(keys.begin(), keys.end());
+   addNode(keys, 0, keys.size(), 0);
+   attachOwned();
+}
+
+/*!
+ write arrays to dictionary image
+ */
+void ByteTrie::write(DicImage::Writer& writer) const
+{
+   writer.writeUInt32(static_cast<UINT32>(nodeNum));
+   writer.writeUInt32Array(nodes, nodeNum * NODE_SIZE);
+   writer.writeUInt32(static_cast<UINT32>(edgeNum));
+   writer.writeUInt32Array(edgeTargets, edgeNum);
+   writer.writeBytes(edgeBytes, edgeNum);
+}
+
+/*!
+ use arrays in dictionary image
+
+ Arrays are not copied, so image must outlive this trie.
+ Indices in arrays are checked so that broken image does not cause invalid access.
+ */
+void ByteTrie::read(DicImage::Reader& reader, size_t valueNum)
+{
+   clear();
+   const size_t nNum(reader.readUInt32());
+   const UINT32* n(reader.readUInt32Array(nNum * NODE_SIZE));
+   const size_t eNum(reader.readUInt32());
+   const UINT32* t(reader.readUInt32Array(eNum));
+   const unsigned char* b(reader.readBytes(eNum));
+   for (size_t i(0); i < nNum; ++i) {
+      const UINT32* node(n + i * NODE_SIZE);
+      if ((node[NODE_EDGE_END] < node[NODE_EDGE_BEGIN]) || (eNum < node[NODE_EDGE_END])) {
+         throw StreamException("ByteTrie::read() invalid edges of node");
+      }
+      if ((STORED_NO_VALUE != node[NODE_VALUE]) && (valueNum <= node[NODE_VALUE])) {
+         throw StreamException("ByteTrie::read() invalid value of node");
+      }
+   }
+   for (size_t i(0); i < eNum; ++i) {
+      if (nNum <= t[i]) {
+         throw StreamException("ByteTrie::read() invalid child node of edge");
+      }
+   }
+   nodes = n;
+   nodeNum = nNum;
+   edgeTargets = t;
+   edgeBytes = b;
+   edgeNum = eNum;
+}
+
+/*!
+ @internal
+
+ add node for keys in [begin, end) which share first depth bytes
+
+ Edges of a node are reserved before its children are added,
+ so that they are contiguous in edge arrays.
+
+ @return index of node
+ */
+UINT32 ByteTrie::addNode(const KeyList& keys, size_t begin, size_t end, size_t depth)
+{
+   const size_t idx(ownedNodes.size() / NODE_SIZE);
+   ownedNodes.resize(ownedNodes.size() + NODE_SIZE, STORED_NO_VALUE);
+
+   // key which ends at this node is the first of sorted keys
+   if ((begin < end) && (keys[begin].first.size() == depth)) {
+      ownedNodes[idx * NODE_SIZE + NODE_VALUE] = static_cast<UINT32>(keys[begin].second);
+      ++begin;
+   }
+
+   // count children
+   size_t childNum(0);
+   for (size_t i(begin); i < end; ++childNum) {
+      const unsigned char c(static_cast<unsigned char>(keys[i].first[depth]));
+      for (++i; (i < end) && (static_cast<unsigned char>(keys[i].first[depth]) == c); ++i) {
+      }
+   }
+
+   const size_t edgeBegin(ownedEdgeBytes.size());
+   ownedNodes[idx * NODE_SIZE + NODE_EDGE_BEGIN] = static_cast<UINT32>(edgeBegin);
+   ownedNodes[idx * NODE_SIZE + NODE_EDGE_END] = static_cast<UINT32>(edgeBegin + childNum);
+   ownedEdgeBytes.resize(edgeBegin + childNum);
+   ownedEdgeTargets.resize(edgeBegin + childNum, 0);
+
+   // add children
+   size_t edge(edgeBegin);
+   for (size_t i(begin); i < end; ++edge) {
+      const unsigned char c(static_cast<unsigned char>(keys[i].first[depth]));
+      size_t j(i + 1);
+      for (; (j < end) && (static_cast<unsigned char>(keys[j].first[depth]) == c); ++j) {
+      }
+      ownedEdgeBytes[edge] = c;
+      const UINT32 child(addNode(keys, i, j, depth + 1));
+      ownedEdgeTargets[edge] = child;
+      i = j;
+   }
+   return static_cast<UINT32>(idx);
+}
+
+/*!
+ get root node
+ */
+size_t ByteTrie::getRoot() const
+{
+   return (0 == nodeNum) ? NO_NODE : 0;
+}
+
+/*!
+ get child node for byte
+ */
+size_t ByteTrie::next(size_t node, unsigned char c) const
+{
+   if (NO_NODE == node) {
+      return NO_NODE;
+   }
+   const unsigned char* begin(edgeBytes + nodes[node * NODE_SIZE + NODE_EDGE_BEGIN]);
+   const unsigned char* end(edgeBytes + nodes[node * NODE_SIZE + NODE_EDGE_END]);
+   const unsigned char* itr(std::lower_bound(begin, end, c));
+   if ((end == itr) || (*itr != c)) {
+      return NO_NODE;
+   }
+   return edgeTargets[itr - edgeBytes];
+}
+
+/*!
+ get value of node
+ */
+size_t ByteTrie::getValue(size_t node) const
+{
+   if (NO_NODE == node) {
+      return NO_VALUE;
+   }
+   const UINT32 value(nodes[node * NODE_SIZE + NODE_VALUE]);
+   return (STORED_NO_VALUE == value) ? NO_VALUE : value;
+}
+
+/*!
+ find longest key that is prefix of str in a single pass
+
+ @param str   string
+ @param size  size of string
+ @param value value of found key
+ @return      length of found key (0 if not found)
+ */
+size_t ByteTrie::findLongest(const char* str, size_t size, size_t& value) const
+{
+   size_t length(0);
+   size_t node(getRoot());
+   for (size_t i(0); (i < size) && (NO_NODE != node); ++i) {
+      node = next(node, static_cast<unsigned char>(str[i]));
+      const size_t v(getValue(node));
+      if (NO_VALUE != v) {
+         length = i + 1;
+         value = v;
+      }
+   }
+   return length;
+}
+
+/*!
+ find key that is equal to str
+ */
+bool ByteTrie::find(const char* str, size_t size, size_t& value) const
+{
+   size_t node(getRoot());
+   for (size_t i(0); (i < size) && (NO_NODE != node); ++i) {
+      node = next(node, static_cast<unsigned char>(str[i]));
+   }
+   const size_t v(getValue(node));
+   if (NO_VALUE == v) {
+      return false;
+   }
+   value = v;
+   return true;
+}
+
+};  // namespace sinsy
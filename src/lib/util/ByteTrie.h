@@ -0,0 +1,144 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_BYTE_TRIE_H_
+#define SINSY_BYTE_TRIE_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "util_types.h"
+#include "DicImage.h"
+
+namespace sinsy
+{
+
+/*!
+ Trie of byte strings
+
+ Nodes and edges are stored in flat arrays built once from all keys,
+ and edges of each node are sorted by byte, so that lookup does not allocate memory.
+ The arrays can also be used in place from a mapped dictionary image.
+ */
+class ByteTrie
+{
+public:
+   typedef std::vector<std::pair<std::string, size_t> > KeyList;
+
+   //! index of no node
+   static const size_t NO_NODE;
+
+   //! no value
+   static const size_t NO_VALUE;
+
+   //! constructor
+   ByteTrie();
+
+   //! destructor
+   virtual ~ByteTrie();
+
+   //! clear
+   void clear();
+
+   //! build from pairs of key and value (keys are sorted, and each key must be unique)
+   void build(KeyList& keys);
+
+   //! write arrays to dictionary image
+   void write(DicImage::Writer& writer) const;
+
+   //! use arrays in dictionary image (image must outlive trie, and values must be less than valueNum)
+   void read(DicImage::Reader& reader, size_t valueNum);
+
+   //! get root node
+   size_t getRoot() const;
+
+   //! get child node for byte (return NO_NODE if there is no child)
+   size_t next(size_t node, unsigned char c) const;
+
+   //! get value of node (return NO_VALUE if node is not end of key)
+   size_t getValue(size_t node) const;
+
+   //! find longest key that is prefix of str (return matched length, or 0 if not found)
+   size_t findLongest(const char* str, size_t size, size_t& value) const;
+
+   //! find key that is equal to str
+   bool find(const char* str, size_t size, size_t& value) const;
+
+private:
+   //! copy constructor (donot use)
+   ByteTrie(const ByteTrie&);
+
+   //! assignment operator (donot use)
+   ByteTrie& operator=(const ByteTrie&);
+
+   //! add node for keys in [begin, end) which share first depth bytes
+   UINT32 addNode(const KeyList& keys, size_t begin, size_t end, size_t depth);
+
+   //! use owned arrays
+   void attachOwned();
+
+   //! nodes built by this trie (first edge, end of edges and value for each node)
+   std::vector<UINT32> ownedNodes;
+
+   //! bytes of edges built by this trie
+   std::vector<unsigned char> ownedEdgeBytes;
+
+   //! child nodes of edges built by this trie
+   std::vector<UINT32> ownedEdgeTargets;
+
+   //! nodes in use
+   const UINT32* nodes;
+
+   //! number of nodes
+   size_t nodeNum;
+
+   //! bytes of edges in use
+   const unsigned char* edgeBytes;
+
+   //! child nodes of edges in use
+   const UINT32* edgeTargets;
+
+   //! number of edges
+   size_t edgeNum;
+};
+
+};
+
+#endif // SINSY_BYTE_TRIE_H_
@@ -134,6 +134,34 @@ bool Configurations::read(const std::string& fpath)
    return true;
 }
 
+/*!
+ write configurations to dictionary image
+ */
+void Configurations::write(DicImage::Writer& writer) const
+{
+   writer.writeUInt32(static_cast<UINT32>(configs.size()));
+   for (Configs::const_iterator itr(configs.begin()); configs.end() != itr; ++itr) {
+      writer.writeString(itr->first);
+      writer.writeString(itr->second);
+   }
+}
+
+/*!
+ read configurations from dictionary image
+ */
+void Configurations::read(DicImage::Reader& reader)
+{
+   clear();
+   const size_t sz(reader.readUInt32());
+   std::string key;
+   std::string value;
+   for (size_t i(0); i < sz; ++i) {
+      reader.readString(key);
+      reader.readString(value);
+      configs.insert(std::make_pair(key, value));
+   }
+}
+
 /*!
  for std::string (need default)
  */
@@ -47,6 +47,7 @@
 #include <sstream>
 #include <algorithm>
 #include "util_types.h"
+#include "DicImage.h"
 
 namespace sinsy
 {
@@ -66,6 +67,12 @@ public:
    //! read configurations from file
    bool read(const std::string& fpath);
 
+   //! write configurations to dictionary image
+   void write(DicImage::Writer& writer) const;
+
+   //! read configurations from dictionary image
+   void read(DicImage::Reader& reader);
+
    //! get
    template<class T> T get(const std::string&, const T&) const;
 
@@ -0,0 +1,491 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstring>
+#include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "util_log.h"
+#include "StreamException.h"
+#include "DicImage.h"
+
+namespace sinsy
+{
+
+namespace
+{
+const char MAGIC[] = "SINSYDIC";
+const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+const UINT32 FORMAT_VERSION = 2;
+const UINT32 BYTE_ORDER_MARK = 0x01020304;
+const size_t SECTION_ALIGNMENT = 8;
+const size_t ARRAY_ALIGNMENT = sizeof(UINT32);
+const std::string SOURCES_SECTION("sources");
+
+/*!
+ get size of padding
+ */
+size_t getPaddingSize(size_t size, size_t alignment)
+{
+   return (alignment - (size % alignment)) % alignment;
+}
+
+/*!
+ read value at position (position may not be aligned)
+ */
+UINT32 getUInt32(const char* ptr)
+{
+   UINT32 value(0);
+   memcpy(&value, ptr, sizeof(value));
+   return value;
+}
+
+/*!
+ append value
+ */
+void appendUInt32(std::string& str, UINT32 value)
+{
+   str.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*!
+ get size and modification time of file
+
+ @return false if file is not found
+ */
+bool getFileStatus(const std::string& fpath, UINT64& size, UINT64& time)
+{
+   struct stat st;
+   if (0 != stat(fpath.c_str(), &st)) {
+      return false;
+   }
+   size = static_cast<UINT64>(st.st_size);
+   time = static_cast<UINT64>(st.st_mtime);
+   return true;
+}
+
+/*!
+ write 64bit value as two 32bit values
+ */
+void writeUInt64(DicImage::Writer& writer, UINT64 value)
+{
+   writer.writeUInt32(static_cast<UINT32>(value & 0xffffffffUL));
+   writer.writeUInt32(static_cast<UINT32>(value >> 32));
+}
+
+/*!
+ read 64bit value written by writeUInt64()
+ */
+UINT64 readUInt64(DicImage::Reader& reader)
+{
+   const UINT64 low(reader.readUInt32());
+   const UINT64 high(reader.readUInt32());
+   return (high << 32) | low;
+}
+};
+
+/*!
+ constructor
+ */
+DicImage::Reader::Reader(const char* data, size_t size) : begin(data), current(data), end(data + size)
+{
+}
+
+/*!
+ destructor
+ */
+DicImage::Reader::~Reader()
+{
+}
+
+/*!
+ @internal
+
+ skip padding for alignment
+ */
+void DicImage::Reader::align()
+{
+   const size_t padding(getPaddingSize(current - begin, ARRAY_ALIGNMENT));
+   if (static_cast<size_t>(end - current) < padding) {
+      throw StreamException("DicImage::Reader::align() unexpected end of section");
+   }
+   current += padding;
+}
+
+/*!
+ read value
+ */
+UINT32 DicImage::Reader::readUInt32()
+{
+   return *readUInt32Array(1);
+}
+
+/*!
+ read string (length prefixed)
+ */
+void DicImage::Reader::readString(std::string& str)
+{
+   const UINT32 size(readUInt32());
+   const unsigned char* bytes(readBytes(size));
+   str.assign(reinterpret_cast<const char*>(bytes), size);
+}
+
+/*!
+ read array of values
+
+ @param num number of values
+ @return    pointer to values in section
+ */
+const UINT32* DicImage::Reader::readUInt32Array(size_t num)
+{
+   align();
+   if (static_cast<size_t>(end - current) / sizeof(UINT32) < num) {
+      throw StreamException("DicImage::Reader::readUInt32Array() unexpected end of section");
+   }
+   const UINT32* values(reinterpret_cast<const UINT32*>(current));
+   current += num * sizeof(UINT32);
+   return values;
+}
+
+/*!
+ read bytes
+
+ @param num number of bytes
+ @return    pointer to bytes in section
+ */
+const unsigned char* DicImage::Reader::readBytes(size_t num)
+{
+   if (static_cast<size_t>(end - current) < num) {
+      throw StreamException("DicImage::Reader::readBytes() unexpected end of section");
+   }
+   const unsigned char* bytes(reinterpret_cast<const unsigned char*>(current));
+   current += num;
+   return bytes;
+}
+
+/*!
+ constructor
+ */
+DicImage::Writer::Writer()
+{
+}
+
+/*!
+ destructor
+ */
+DicImage::Writer::~Writer()
+{
+}
+
+/*!
+ @internal
+
+ add padding for alignment
+ */
+void DicImage::Writer::align()
+{
+   data.append(getPaddingSize(data.size(), ARRAY_ALIGNMENT), '\0');
+}
+
+/*!
+ write value
+ */
+void DicImage::Writer::writeUInt32(UINT32 value)
+{
+   writeUInt32Array(&value, 1);
+}
+
+/*!
+ write string (length prefixed)
+ */
+void DicImage::Writer::writeString(const std::string& str)
+{
+   writeUInt32(static_cast<UINT32>(str.size()));
+   data.append(str);
+}
+
+/*!
+ write array of values
+ */
+void DicImage::Writer::writeUInt32Array(const UINT32* values, size_t num)
+{
+   align();
+   if (0 < num) {
+      data.append(reinterpret_cast<const char*>(values), num * sizeof(UINT32));
+   }
+}
+
+/*!
+ write bytes
+ */
+void DicImage::Writer::writeBytes(const unsigned char* bytes, size_t num)
+{
+   if (0 < num) {
+      data.append(reinterpret_cast<const char*>(bytes), num);
+   }
+}
+
+/*!
+ get data
+ */
+const std::string& DicImage::Writer::getData() const
+{
+   return data;
+}
+
+/*!
+ constructor
+ */
+DicImage::DicImage() : imageTime(0)
+{
+}
+
+/*!
+ destructor
+ */
+DicImage::~DicImage()
+{
+   close();
+}
+
+/*!
+ map image file
+
+ @param fpath path of image file
+ @return      if success, true
+ */
+bool DicImage::open(const std::string& fpath)
+{
+   close();
+   if (!file.open(fpath)) {
+      return false;
+   }
+
+   const char* data(file.getData());
+   const size_t size(file.getSize());
+   const size_t headerSize(MAGIC_SIZE + sizeof(UINT32) * 3);
+   if ((size < headerSize) || (0 != memcmp(data, MAGIC, MAGIC_SIZE))) {
+      ERR_MSG("Not dictionary image : " << fpath);
+      close();
+      return false;
+   }
+   if (FORMAT_VERSION != getUInt32(data + MAGIC_SIZE)) {
+      ERR_MSG("Unsupported version of dictionary image : " << fpath);
+      close();
+      return false;
+   }
+   if (BYTE_ORDER_MARK != getUInt32(data + MAGIC_SIZE + sizeof(UINT32))) {
+      ERR_MSG("Dictionary image was compiled on a machine of different byte order : " << fpath);
+      close();
+      return false;
+   }
+
+   const UINT32 sectionNum(getUInt32(data + MAGIC_SIZE + sizeof(UINT32) * 2));
+   size_t pos(headerSize);
+   for (UINT32 i(0); i < sectionNum; ++i) {
+      if ((size < pos) || (size - pos < sizeof(UINT32) * 2)) {
+         ERR_MSG("Broken dictionary image : " << fpath);
+         close();
+         return false;
+      }
+      const size_t nameSize(getUInt32(data + pos));
+      const size_t dataSize(getUInt32(data + pos + sizeof(UINT32)));
+      pos += sizeof(UINT32) * 2;
+      if (size - pos < nameSize) {
+         ERR_MSG("Broken dictionary image : " << fpath);
+         close();
+         return false;
+      }
+      const std::string name(data + pos, nameSize);
+      pos += nameSize;
+      pos += getPaddingSize(pos, SECTION_ALIGNMENT);
+      if ((size < pos) || (size - pos < dataSize)) {
+         ERR_MSG("Broken dictionary image : " << fpath);
+         close();
+         return false;
+      }
+      sections[name] = std::make_pair(data + pos, dataSize);
+      pos += dataSize;
+      pos += getPaddingSize(pos, SECTION_ALIGNMENT);
+   }
+
+   UINT64 imageSize(0);
+   if (!getFileStatus(fpath, imageSize, imageTime)) {
+      imageTime = 0;
+   }
+   return true;
+}
+
+/*!
+ unmap
+ */
+void DicImage::close()
+{
+   sections.clear();
+   file.close();
+   imageTime = 0;
+}
+
+/*!
+ image is mapped or not
+ */
+bool DicImage::isValid() const
+{
+   return file.isValid();
+}
+
+/*!
+ find section
+
+ @param name name of section
+ @param data data of section
+ @param size size of data
+ @return     if found, true
+ */
+bool DicImage::findSection(const std::string& name, const char*& data, size_t& size) const
+{
+   Sections::const_iterator itr(sections.find(name));
+   if (sections.end() == itr) {
+      return false;
+   }
+   data = itr->second.first;
+   size = itr->second.second;
+   return true;
+}
+
+/*!
+ check that source files in directory have not been changed since image was compiled
+
+ Source file is regarded as changed if its size differs from recorded one,
+ or if it is modified after both the compilation and the image file
+ (image file installed after source files is still used).
+ Source files which are not found are ignored.
+
+ @param dirPath     directory of source files
+ @param changedFile name of changed source file (set if false is returned)
+ @return            true if no source file is changed
+ */
+bool DicImage::checkSources(const std::string& dirPath, std::string& changedFile) const
+{
+   const char* data(NULL);
+   size_t size(0);
+   if (!findSection(SOURCES_SECTION, data, size)) {
+      return true;
+   }
+   try {
+      Reader reader(data, size);
+      const UINT32 sourceNum(reader.readUInt32());
+      for (UINT32 i(0); i < sourceNum; ++i) {
+         std::string name;
+         reader.readString(name);
+         const UINT64 recordedSize(readUInt64(reader));
+         const UINT64 recordedTime(readUInt64(reader));
+         UINT64 sourceSize(0);
+         UINT64 sourceTime(0);
+         if (!getFileStatus(dirPath + "/" + name, sourceSize, sourceTime)) {
+            continue;
+         }
+         if ((sourceSize != recordedSize) || ((recordedTime < sourceTime) && (imageTime < sourceTime))) {
+            changedFile = name;
+            return false;
+         }
+      }
+   } catch (const StreamException&) {
+      changedFile = SOURCES_SECTION;
+      return false;
+   }
+   return true;
+}
+
+/*!
+ write image file
+
+ @param fpath    path of image file
+ @param sections pairs of name and data of sections
+ @param dirPath  directory of source files
+ @param sources  names of source files
+ @return         if success, true
+ */
+bool DicImage::write(const std::string& fpath, const SectionList& sections, const std::string& dirPath, const SourceList& sources)
+{
+   Writer sourceWriter;
+   sourceWriter.writeUInt32(static_cast<UINT32>(sources.size()));
+   for (SourceList::const_iterator itr(sources.begin()); sources.end() != itr; ++itr) {
+      UINT64 size(0);
+      UINT64 time(0);
+      if (!getFileStatus(dirPath + "/" + *itr, size, time)) {
+         ERR_MSG("Cannot get status of dictionary file : " << dirPath << "/" << *itr);
+         return false;
+      }
+      sourceWriter.writeString(*itr);
+      writeUInt64(sourceWriter, size);
+      writeUInt64(sourceWriter, time);
+   }
+   SectionList allSections(sections);
+   allSections.push_back(std::make_pair(SOURCES_SECTION, sourceWriter.getData()));
+
+   std::string image(MAGIC, MAGIC_SIZE);
+   appendUInt32(image, FORMAT_VERSION);
+   appendUInt32(image, BYTE_ORDER_MARK);
+   appendUInt32(image, static_cast<UINT32>(allSections.size()));
+   for (SectionList::const_iterator itr(allSections.begin()); allSections.end() != itr; ++itr) {
+      appendUInt32(image, static_cast<UINT32>(itr->first.size()));
+      appendUInt32(image, static_cast<UINT32>(itr->second.size()));
+      image.append(itr->first);
+      image.append(getPaddingSize(image.size(), SECTION_ALIGNMENT), '\0');
+      image.append(itr->second);
+      image.append(getPaddingSize(image.size(), SECTION_ALIGNMENT), '\0');
+   }
+
+   std::ofstream ofs(fpath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+   if (!ofs) {
+      ERR_MSG("Cannot open dictionary image file : " << fpath);
+      return false;
+   }
+   ofs.write(image.data(), image.size());
+   ofs.close();
+   if (!ofs) {
+      ERR_MSG("Cannot write dictionary image file : " << fpath);
+      return false;
+   }
+   return true;
+}
+
+};  // namespace sinsy
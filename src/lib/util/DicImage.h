@@ -0,0 +1,198 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_DIC_IMAGE_H_
+#define SINSY_DIC_IMAGE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include "util_types.h"
+#include "MappedFile.h"
+
+namespace sinsy
+{
+
+/*!
+ Binary image of dictionaries
+
+ Image consists of named sections, and each section is aligned to 8 bytes
+ so that arrays in it can be used directly from mapped memory.
+ Values are stored in byte order of the machine that compiled the image.
+ Sizes and modification times of source files are recorded in "sources" section,
+ so that the image is not used after the source files are edited.
+
+ header  : magic "SINSYDIC" (8 bytes), version, byte order mark, number of sections (UINT32 x 3)
+ section : length of name, size of data (UINT32 x 2), name, padding, data, padding
+ */
+class DicImage
+{
+public:
+   typedef std::vector<std::pair<std::string, std::string> > SectionList;
+   typedef std::vector<std::string> SourceList;
+
+   //! reader of section (StreamException is thrown if data is broken)
+   class Reader
+   {
+   public:
+      //! constructor
+      Reader(const char* data, size_t size);
+
+      //! destructor
+      virtual ~Reader();
+
+      //! read value
+      UINT32 readUInt32();
+
+      //! read string
+      void readString(std::string& str);
+
+      //! read array of values (array is not copied)
+      const UINT32* readUInt32Array(size_t num);
+
+      //! read bytes (bytes are not copied)
+      const unsigned char* readBytes(size_t num);
+
+   private:
+      //! copy constructor (donot use)
+      Reader(const Reader&);
+
+      //! assignment operator (donot use)
+      Reader& operator=(const Reader&);
+
+      //! skip padding for alignment
+      void align();
+
+      //! begin of section
+      const char* begin;
+
+      //! current position
+      const char* current;
+
+      //! end of section
+      const char* end;
+   };
+
+   //! writer of section
+   class Writer
+   {
+   public:
+      //! constructor
+      Writer();
+
+      //! destructor
+      virtual ~Writer();
+
+      //! write value
+      void writeUInt32(UINT32 value);
+
+      //! write string
+      void writeString(const std::string& str);
+
+      //! write array of values
+      void writeUInt32Array(const UINT32* values, size_t num);
+
+      //! write bytes
+      void writeBytes(const unsigned char* bytes, size_t num);
+
+      //! get data
+      const std::string& getData() const;
+
+   private:
+      //! copy constructor (donot use)
+      Writer(const Writer&);
+
+      //! assignment operator (donot use)
+      Writer& operator=(const Writer&);
+
+      //! add padding for alignment
+      void align();
+
+      //! data
+      std::string data;
+   };
+
+   //! constructor
+   DicImage();
+
+   //! destructor
+   virtual ~DicImage();
+
+   //! map image file
+   bool open(const std::string& fpath);
+
+   //! unmap
+   void close();
+
+   //! image is mapped or not
+   bool isValid() const;
+
+   //! find section
+   bool findSection(const std::string& name, const char*& data, size_t& size) const;
+
+   //! check that source files in directory have not been changed since image was compiled
+   bool checkSources(const std::string& dirPath, std::string& changedFile) const;
+
+   //! write image file (sizes and modification times of source files in directory are recorded)
+   static bool write(const std::string& fpath, const SectionList& sections, const std::string& dirPath, const SourceList& sources);
+
+private:
+   //! copy constructor (donot use)
+   DicImage(const DicImage&);
+
+   //! assignment operator (donot use)
+   DicImage& operator=(const DicImage&);
+
+   typedef std::map<std::string, std::pair<const char*, size_t> > Sections;
+
+   //! mapped file
+   MappedFile file;
+
+   //! sections
+   Sections sections;
+
+   //! modification time of image file
+   UINT64 imageTime;
+};
+
+};
+
+#endif // SINSY_DIC_IMAGE_H_
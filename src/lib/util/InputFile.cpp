@@ -76,14 +76,17 @@ InputFile::~InputFile()
  */
 size_t InputFile::read(void* buffer, size_t size) throw (StreamException)
 {
-   if(stream.fail()) {
-      throw StreamException("InputFile::read()");
-   }
    if (stream.eof()) {
       return 0;
    }
+   if(stream.fail()) {
+      throw StreamException("InputFile::read()");
+   }
    stream.read(static_cast<char*>(buffer), size);
    int ret = stream.gcount();
+   if ((0 == ret) && stream.eof()) {
+      return 0;
+   }
    if (ret <= 0) {
       ERR_MSG("File reading error (size: " << size << ")  result of gcount = " << ret);
       throw StreamException("InputFile::read()");
@@ -39,9 +39,11 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
+#include <map>
 #include <fstream>
 #include "MacronTable.h"
 #include "StringTokenizer.h"
+#include "StreamException.h"
 #include "util_log.h"
 #include "util_string.h"
 
@@ -51,6 +53,7 @@ namespace sinsy
 namespace
 {
 const std::string MACRON_DELIMITER = ",";
+const char PHONEME_SEPARATOR = '\0';
 
 /*!
  extract phoneme list from string
@@ -61,7 +64,22 @@ void extractPhonemeList(const std::string& str, MacronTable::PhonemeList& pl)
    size_t sz(st.size());
    pl.resize(sz);
    for (size_t i(0); i < sz; ++i) {
-      pl[i] = st.at(i);
+      pl[i] = PhonemeSymbol(st.at(i));
+   }
+}
+
+/*!
+ make key of trie from phoneme list (phonemes are joined and reversed)
+ */
+void makeReversedKey(const MacronTable::PhonemeList& pl, std::string& key)
+{
+   key.clear();
+   for (MacronTable::PhonemeList::const_reverse_iterator itr(pl.rbegin()); pl.rend() != itr; ++itr) {
+      if (pl.rbegin() != itr) {
+         key.push_back(PHONEME_SEPARATOR);
+      }
+      const std::string& phoneme(itr->getString());
+      key.append(phoneme.rbegin(), phoneme.rend());
    }
 }
 
@@ -87,12 +105,8 @@ MacronTable::~MacronTable()
 */
 void MacronTable::clear()
 {
-   const ConvertTable::iterator itrEnd(convertTable.end());
-   ConvertTable::iterator itr(convertTable.begin());
-   for (; itrEnd != itr; ++itr) {
-      delete itr->second;
-   }
-   convertTable.clear();
+   results.clear();
+   trie.clear();
 }
 
 /*!
@@ -113,6 +127,8 @@ bool MacronTable::read(const std::string& fname)
 
    clear();
 
+   typedef std::map<PhonemeList, Result> ConvertTable;
+   ConvertTable convertTable;
    std::string buffer;
 
    while (!ifs.eof()) {
@@ -132,40 +148,147 @@ bool MacronTable::read(const std::string& fname)
       extractPhonemeList(st.at(0), pl);
 
       // dst
-      Result* result(new Result);
-      extractPhonemeList(st.at(1), result->forward);
-      extractPhonemeList(st.at(2), result->backward);
-
-      if (false == convertTable.insert(std::make_pair(pl, result)).second) {
+      std::pair<ConvertTable::iterator, bool> inserted(convertTable.insert(std::make_pair(pl, Result())));
+      if (false == inserted.second) {
          ERR_MSG("Wrong macron table (There is a duplication : " << st.at(0) << ") : " << fname);
-         delete result;
          return false;
       }
+      extractPhonemeList(st.at(1), inserted.first->second.forward);
+      extractPhonemeList(st.at(2), inserted.first->second.backward);
+   }
+
+   // build trie for suffix match
+   ByteTrie::KeyList keys(convertTable.size());
+   results.reserve(convertTable.size());
+   for (ConvertTable::const_iterator itr(convertTable.begin()); convertTable.end() != itr; ++itr) {
+      makeReversedKey(itr->first, keys[results.size()].first);
+      keys[results.size()].second = results.size();
+      results.push_back(itr->second);
    }
+   trie.build(keys);
 
    return true;
 }
 
+/*!
+ write to dictionary image
+
+ Phonemes of results are stored once in a symbol list, and each result has arrays of phoneme IDs.
+ Keys are not stored because only the trie is needed to find them.
+ */
+void MacronTable::write(DicImage::Writer& writer) const
+{
+   typedef std::map<PhonemeSymbol, UINT32> SymbolMap;
+   SymbolMap symbolMap;
+   std::vector<PhonemeSymbol> symbols;
+   for (std::vector<Result>::const_iterator itr(results.begin()); results.end() != itr; ++itr) {
+      const PhonemeList* lists[] = {&itr->forward, &itr->backward};
+      for (size_t i(0); i < 2; ++i) {
+         for (PhonemeList::const_iterator pItr(lists[i]->begin()); lists[i]->end() != pItr; ++pItr) {
+            if (symbolMap.insert(std::make_pair(*pItr, static_cast<UINT32>(symbols.size()))).second) {
+               symbols.push_back(*pItr);
+            }
+         }
+      }
+   }
+
+   writer.writeUInt32(static_cast<UINT32>(symbols.size()));
+   for (std::vector<PhonemeSymbol>::const_iterator itr(symbols.begin()); symbols.end() != itr; ++itr) {
+      writer.writeString(itr->getString());
+   }
+
+   writer.writeUInt32(static_cast<UINT32>(results.size()));
+   std::vector<UINT32> ids;
+   for (std::vector<Result>::const_iterator itr(results.begin()); results.end() != itr; ++itr) {
+      const PhonemeList* lists[] = {&itr->forward, &itr->backward};
+      for (size_t i(0); i < 2; ++i) {
+         ids.resize(lists[i]->size());
+         for (size_t j(0); j < lists[i]->size(); ++j) {
+            ids[j] = symbolMap[(*lists[i])[j]];
+         }
+         writer.writeUInt32(static_cast<UINT32>(ids.size()));
+         writer.writeUInt32Array(ids.empty() ? NULL : &ids[0], ids.size());
+      }
+   }
+
+   trie.write(writer);
+}
+
+/*!
+ read from dictionary image
+
+ Trie is used in place, and results are made from arrays of phoneme IDs.
+ */
+void MacronTable::read(DicImage::Reader& reader)
+{
+   clear();
+
+   const size_t symbolNum(reader.readUInt32());
+   std::vector<PhonemeSymbol> symbols(symbolNum);
+   std::string symbol;
+   for (size_t i(0); i < symbolNum; ++i) {
+      reader.readString(symbol);
+      symbols[i] = PhonemeSymbol(symbol);
+   }
+
+   const size_t resultNum(reader.readUInt32());
+   results.resize(resultNum);
+   for (size_t i(0); i < resultNum; ++i) {
+      PhonemeList* lists[] = {&results[i].forward, &results[i].backward};
+      for (size_t j(0); j < 2; ++j) {
+         const size_t phonemeNum(reader.readUInt32());
+         const UINT32* ids(reader.readUInt32Array(phonemeNum));
+         lists[j]->reserve(phonemeNum);
+         for (size_t k(0); k < phonemeNum; ++k) {
+            if (symbolNum <= ids[k]) {
+               throw StreamException("MacronTable::read() invalid phoneme ID");
+            }
+            lists[j]->push_back(symbols[ids[k]]);
+         }
+      }
+   }
+
+   trie.read(reader, resultNum);
+}
+
 /*!
  divide phoneme set
+
+ The longest suffix of src in the table is found by walking the trie
+ from the last phoneme to the first one.
  */
-bool MacronTable::divide(const PhonemeList& src_, PhonemeList& dst1, PhonemeList& dst2) const
+bool MacronTable::divide(const PhonemeList& src, PhonemeList& dst1, PhonemeList& dst2) const
 {
-   PhonemeList src(src_);
-   dst1.clear();
-   dst2.clear();
-   while (!src.empty()) {
-      ConvertTable::const_iterator itr(convertTable.find(src));
-      if (convertTable.end() != itr) {
-         dst1.insert(dst1.end(), itr->second->forward.begin(), itr->second->forward.end());
-         dst2 = itr->second->backward;
-         return true;
+   size_t matchedIdx(0);
+   size_t matchedValue(ByteTrie::NO_VALUE);
+   size_t node(trie.getRoot());
+   for (size_t i(src.size()); (0 < i) && (ByteTrie::NO_NODE != node); --i) {
+      const std::string& phoneme(src[i - 1].getString());
+      if (i != src.size()) {
+         node = trie.next(node, PHONEME_SEPARATOR);
       }
-      dst1.push_back(src.front());
-      src.erase(src.begin());
+      for (std::string::const_reverse_iterator itr(phoneme.rbegin()); (phoneme.rend() != itr) && (ByteTrie::NO_NODE != node); ++itr) {
+         node = trie.next(node, static_cast<unsigned char>(*itr));
+      }
+      const size_t value(trie.getValue(node));
+      if (ByteTrie::NO_VALUE != value) {
+         matchedIdx = i - 1;
+         matchedValue = value;
+      }
+   }
+   if (ByteTrie::NO_VALUE == matchedValue) {
+      dst1.clear();
+      dst2.clear();
+      return false;
    }
-   dst1.clear();
-   return false;
+
+   // src may be same as dst1
+   const Result& result(results[matchedValue]);
+   PhonemeList head(src.begin(), src.begin() + matchedIdx);
+   dst1.swap(head);
+   dst1.insert(dst1.end(), result.forward.begin(), result.forward.end());
+   dst2 = result.backward;
+   return true;
 }
 
 };  // namespace sinsy
@@ -42,9 +42,10 @@
 #ifndef SINSY_MACRON_TABLE_H_
 #define SINSY_MACRON_TABLE_H_
 
-#include <map>
 #include <vector>
 #include <string>
+#include "ByteTrie.h"
+#include "PhonemeSymbol.h"
 
 namespace sinsy
 {
@@ -52,7 +53,7 @@ namespace sinsy
 class MacronTable
 {
 public:
-   typedef std::vector<std::string> PhonemeList;
+   typedef std::vector<PhonemeSymbol> PhonemeList;
 
    //! constructor
    MacronTable();
@@ -66,6 +67,12 @@ public:
    //! read from file
    bool read(const std::string& fname);
 
+   //! write to dictionary image
+   void write(DicImage::Writer& writer) const;
+
+   //! read from dictionary image (image must outlive table)
+   void read(DicImage::Reader& reader);
+
    //! divide phoneme set
    bool divide(const PhonemeList& src, PhonemeList& dst1, PhonemeList& dst2) const;
 
@@ -81,10 +88,11 @@ private:
    //! assignment operator (donot use)
    MacronTable& operator=(const MacronTable&);
 
-   typedef std::map<PhonemeList, Result*> ConvertTable;
+   //! results of convert table (indexed by values of trie)
+   std::vector<Result> results;
 
-   //! type of convert table
-   ConvertTable convertTable;
+   //! trie of reversed phoneme lists (to find longest suffix of phoneme list)
+   ByteTrie trie;
 };
 
 };
@@ -0,0 +1,199 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "util_log.h"
+#include "MappedFile.h"
+
+namespace sinsy
+{
+
+/*!
+ @internal
+
+ handle of mapping
+ */
+struct MappedFile::Handle {
+#ifdef _WIN32
+   HANDLE file;
+   HANDLE mapping;
+#else
+   int fd;
+#endif
+};
+
+/*!
+ constructor
+ */
+MappedFile::MappedFile() : handle(NULL), data(NULL), size(0)
+{
+}
+
+/*!
+ destructor
+ */
+MappedFile::~MappedFile()
+{
+   close();
+}
+
+/*!
+ map file into memory
+
+ @param fpath file path
+ @return true if success
+ */
+bool MappedFile::open(const std::string& fpath)
+{
+   close();
+   Handle* h(new Handle);
+#ifdef _WIN32
+   h->file = CreateFileA(fpath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+   if (INVALID_HANDLE_VALUE == h->file) {
+      delete h;
+      ERR_MSG("Cannot open file : " << fpath);
+      return false;
+   }
+   LARGE_INTEGER fileSize;
+   if (!GetFileSizeEx(h->file, &fileSize) || (0 == fileSize.QuadPart)) {
+      CloseHandle(h->file);
+      delete h;
+      ERR_MSG("Cannot map empty file : " << fpath);
+      return false;
+   }
+   h->mapping = CreateFileMappingA(h->file, NULL, PAGE_READONLY, 0, 0, NULL);
+   if (NULL == h->mapping) {
+      CloseHandle(h->file);
+      delete h;
+      ERR_MSG("Cannot map file : " << fpath);
+      return false;
+   }
+   void* p(MapViewOfFile(h->mapping, FILE_MAP_READ, 0, 0, 0));
+   if (NULL == p) {
+      CloseHandle(h->mapping);
+      CloseHandle(h->file);
+      delete h;
+      ERR_MSG("Cannot map file : " << fpath);
+      return false;
+   }
+   size = static_cast<size_t>(fileSize.QuadPart);
+#else
+   h->fd = ::open(fpath.c_str(), O_RDONLY);
+   if (h->fd < 0) {
+      delete h;
+      ERR_MSG("Cannot open file : " << fpath);
+      return false;
+   }
+   struct stat st;
+   if ((0 != fstat(h->fd, &st)) || (st.st_size <= 0)) {
+      ::close(h->fd);
+      delete h;
+      ERR_MSG("Cannot map empty file : " << fpath);
+      return false;
+   }
+   void* p(mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, h->fd, 0));
+   if (MAP_FAILED == p) {
+      ::close(h->fd);
+      delete h;
+      ERR_MSG("Cannot map file : " << fpath);
+      return false;
+   }
+   size = static_cast<size_t>(st.st_size);
+#endif
+   handle = h;
+   data = static_cast<const char*>(p);
+   return true;
+}
+
+/*!
+ unmap
+ */
+void MappedFile::close()
+{
+   if (NULL == handle) {
+      return;
+   }
+#ifdef _WIN32
+   UnmapViewOfFile(data);
+   CloseHandle(handle->mapping);
+   CloseHandle(handle->file);
+#else
+   munmap(const_cast<char*>(data), size);
+   ::close(handle->fd);
+#endif
+   delete handle;
+   handle = NULL;
+   data = NULL;
+   size = 0;
+}
+
+/*!
+ get mapped data
+ */
+const char* MappedFile::getData() const
+{
+   return data;
+}
+
+/*!
+ get size of data
+ */
+size_t MappedFile::getSize() const
+{
+   return size;
+}
+
+/*!
+ file is mapped or not
+ */
+bool MappedFile::isValid() const
+{
+   return (NULL != handle);
+}
+
+};  // namespace sinsy
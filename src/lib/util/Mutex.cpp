@@ -0,0 +1,219 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include <stdexcept>
+#include "Mutex.h"
+
+namespace sinsy
+{
+
+/*!
+ @internal
+
+ handle of mutex
+ */
+struct Mutex::Handle {
+#ifdef _WIN32
+   CRITICAL_SECTION mutex;
+#else
+   pthread_mutex_t mutex;
+#endif
+};
+
+/*!
+ @internal
+
+ handle of condition variable
+ */
+struct Condition::Handle {
+#ifdef _WIN32
+   CONDITION_VARIABLE cond;
+#else
+   pthread_cond_t cond;
+#endif
+};
+
+/*!
+ constructor
+ */
+Mutex::Mutex() : handle(new Handle)
+{
+#ifdef _WIN32
+   InitializeCriticalSection(&handle->mutex);
+#else
+   if (0 != pthread_mutex_init(&handle->mutex, NULL)) {
+      delete handle;
+      throw std::runtime_error("Mutex::Mutex() cannot initialize mutex");
+   }
+#endif
+}
+
+/*!
+ destructor
+ */
+Mutex::~Mutex()
+{
+#ifdef _WIN32
+   DeleteCriticalSection(&handle->mutex);
+#else
+   pthread_mutex_destroy(&handle->mutex);
+#endif
+   delete handle;
+}
+
+/*!
+ lock
+ */
+void Mutex::lock()
+{
+#ifdef _WIN32
+   EnterCriticalSection(&handle->mutex);
+#else
+   pthread_mutex_lock(&handle->mutex);
+#endif
+}
+
+/*!
+ unlock
+ */
+void Mutex::unlock()
+{
+#ifdef _WIN32
+   LeaveCriticalSection(&handle->mutex);
+#else
+   pthread_mutex_unlock(&handle->mutex);
+#endif
+}
+
+/*!
+ constructor
+ */
+Condition::Condition() : handle(new Handle)
+{
+#ifdef _WIN32
+   InitializeConditionVariable(&handle->cond);
+#else
+   if (0 != pthread_cond_init(&handle->cond, NULL)) {
+      delete handle;
+      throw std::runtime_error("Condition::Condition() cannot initialize condition variable");
+   }
+#endif
+}
+
+/*!
+ destructor
+ */
+Condition::~Condition()
+{
+#ifndef _WIN32
+   pthread_cond_destroy(&handle->cond);
+#endif
+   delete handle;
+}
+
+/*!
+ wait for signal
+ */
+void Condition::wait(Mutex& mutex)
+{
+#ifdef _WIN32
+   SleepConditionVariableCS(&handle->cond, &mutex.handle->mutex, INFINITE);
+#else
+   pthread_cond_wait(&handle->cond, &mutex.handle->mutex);
+#endif
+}
+
+/*!
+ wake up all waiting threads
+ */
+void Condition::broadcast()
+{
+#ifdef _WIN32
+   WakeAllConditionVariable(&handle->cond);
+#else
+   pthread_cond_broadcast(&handle->cond);
+#endif
+}
+
+/*!
+ constructor
+ */
+OnceFlag::OnceFlag() : value(0)
+{
+}
+
+/*!
+ destructor
+ */
+OnceFlag::~OnceFlag()
+{
+}
+
+/*!
+ flag is set or not (with memory barrier)
+ */
+bool OnceFlag::isSet() const
+{
+#ifdef _WIN32
+   return 0 != InterlockedCompareExchange(&value, 0, 0);
+#else
+   return 0 != __sync_fetch_and_add(&value, 0);
+#endif
+}
+
+/*!
+ set flag (with full memory barrier: data written before are visible before flag)
+ */
+void OnceFlag::set()
+{
+#ifdef _WIN32
+   InterlockedExchange(&value, 1);
+#else
+   // __sync_lock_test_and_set() is only an acquire barrier
+   __sync_val_compare_and_swap(&value, 0, 1);
+#endif
+}
+
+};  // namespace sinsy
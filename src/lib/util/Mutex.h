@@ -0,0 +1,167 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_MUTEX_H_
+#define SINSY_MUTEX_H_
+
+namespace sinsy
+{
+
+class Condition;
+
+class Mutex
+{
+public:
+   //! constructor
+   Mutex();
+
+   //! destructor
+   virtual ~Mutex();
+
+   //! lock
+   void lock();
+
+   //! unlock
+   void unlock();
+
+private:
+   //! copy constructor (donot use)
+   Mutex(const Mutex&);
+
+   //! assignment operator (donot use)
+   Mutex& operator=(const Mutex&);
+
+   //! handle of mutex
+   struct Handle;
+
+   //! handle
+   Handle* handle;
+
+   friend class Condition;
+};
+
+class MutexLock
+{
+public:
+   //! constructor (lock)
+   explicit MutexLock(Mutex& m) : mutex(m) {
+      mutex.lock();
+   }
+
+   //! destructor (unlock)
+   virtual ~MutexLock() {
+      mutex.unlock();
+   }
+
+private:
+   //! copy constructor (donot use)
+   MutexLock(const MutexLock&);
+
+   //! assignment operator (donot use)
+   MutexLock& operator=(const MutexLock&);
+
+   //! mutex
+   Mutex& mutex;
+};
+
+class Condition
+{
+public:
+   //! constructor
+   Condition();
+
+   //! destructor
+   virtual ~Condition();
+
+   //! wait for signal (mutex has to be locked)
+   void wait(Mutex& mutex);
+
+   //! wake up all waiting threads
+   void broadcast();
+
+private:
+   //! copy constructor (donot use)
+   Condition(const Condition&);
+
+   //! assignment operator (donot use)
+   Condition& operator=(const Condition&);
+
+   //! handle of condition variable
+   struct Handle;
+
+   //! handle
+   Handle* handle;
+};
+
+/*!
+ Flag which is set only once (e.g. after lazy initialization)
+
+ Reading the flag does not lock, and data written before set() is visible
+ to threads which read the flag as set.
+ */
+class OnceFlag
+{
+public:
+   //! constructor (not set)
+   OnceFlag();
+
+   //! destructor
+   virtual ~OnceFlag();
+
+   //! flag is set or not
+   bool isSet() const;
+
+   //! set flag
+   void set();
+
+private:
+   //! copy constructor (donot use)
+   OnceFlag(const OnceFlag&);
+
+   //! assignment operator (donot use)
+   OnceFlag& operator=(const OnceFlag&);
+
+   //! value (0 or 1)
+   mutable volatile long value;
+};
+
+};
+
+#endif // SINSY_MUTEX_H_
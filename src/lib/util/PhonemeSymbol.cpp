@@ -0,0 +1,212 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <map>
+#include "util_string.h"
+#include "Mutex.h"
+#include "PhonemeSymbol.h"
+
+namespace sinsy
+{
+
+/*!
+ entry of symbol table
+ */
+struct PhonemeSymbol::Entry {
+   std::string str; //!< string
+   size_t id; //!< ID
+};
+
+namespace
+{
+/*!
+ global symbol table
+ */
+class SymbolTable
+{
+public:
+   //! constructor
+   SymbolTable() {}
+
+   //! destructor
+   virtual ~SymbolTable() {
+      for (Entries::iterator itr(entries.begin()); entries.end() != itr; ++itr) {
+         delete itr->second;
+      }
+   }
+
+   //! register string and get its entry
+   const PhonemeSymbol::Entry* intern(const std::string& str) {
+      MutexLock lock(mutex);
+      Entries::const_iterator itr(entries.find(str));
+      if (entries.end() != itr) {
+         return itr->second;
+      }
+      PhonemeSymbol::Entry* entry(new PhonemeSymbol::Entry);
+      entry->str = str;
+      entry->id = entries.size() + 1;
+      entries.insert(std::make_pair(str, entry));
+      return entry;
+   }
+
+private:
+   //! copy constructor (donot use)
+   SymbolTable(const SymbolTable&);
+
+   //! assignment operator (donot use)
+   SymbolTable& operator=(const SymbolTable&);
+
+   typedef std::map<std::string, PhonemeSymbol::Entry*> Entries;
+
+   //! mutex
+   Mutex mutex;
+
+   //! entries
+   Entries entries;
+};
+
+/*!
+ get global symbol table
+
+ It is made on first use, so symbols can be made while static objects are initialized.
+ */
+SymbolTable& getSymbolTable()
+{
+   static SymbolTable table;
+   return table;
+}
+};
+
+/*!
+ constructor
+ */
+PhonemeSymbol::PhonemeSymbol() : entry(NULL)
+{
+}
+
+/*!
+ constructor
+
+ Symbol table is locked only while string is registered.
+ */
+PhonemeSymbol::PhonemeSymbol(const std::string& str) : entry(str.empty() ? NULL : getSymbolTable().intern(str))
+{
+}
+
+/*!
+ copy constructor
+ */
+PhonemeSymbol::PhonemeSymbol(const PhonemeSymbol& obj) : entry(obj.entry)
+{
+}
+
+/*!
+ destructor
+ */
+PhonemeSymbol::~PhonemeSymbol()
+{
+}
+
+/*!
+ assignment operator
+ */
+PhonemeSymbol& PhonemeSymbol::operator=(const PhonemeSymbol& obj)
+{
+   entry = obj.entry;
+   return *this;
+}
+
+/*!
+ equal
+ */
+bool PhonemeSymbol::operator==(const PhonemeSymbol& obj) const
+{
+   return entry == obj.entry;
+}
+
+/*!
+ not equal
+ */
+bool PhonemeSymbol::operator!=(const PhonemeSymbol& obj) const
+{
+   return entry != obj.entry;
+}
+
+/*!
+ less than
+ */
+bool PhonemeSymbol::operator<(const PhonemeSymbol& obj) const
+{
+   return getId() < obj.getId();
+}
+
+/*!
+ get ID
+ */
+size_t PhonemeSymbol::getId() const
+{
+   return (NULL == entry) ? 0 : entry->id;
+}
+
+/*!
+ get string
+ */
+const std::string& PhonemeSymbol::getString() const
+{
+   return (NULL == entry) ? NULL_STR : entry->str;
+}
+
+/*!
+ symbol is empty or not
+ */
+bool PhonemeSymbol::empty() const
+{
+   return NULL == entry;
+}
+
+/*!
+ to stream
+ */
+std::ostream& operator<<(std::ostream& os, const PhonemeSymbol& symbol)
+{
+   return os << symbol.getString();
+}
+
+};  // namespace sinsy
@@ -0,0 +1,107 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_PHONEME_SYMBOL_H_
+#define SINSY_PHONEME_SYMBOL_H_
+
+#include <string>
+#include <ostream>
+
+namespace sinsy
+{
+
+/*!
+ Interned symbol of phoneme (or type of phoneme)
+
+ Each string is registered to a global symbol table only once and gets a small ID,
+ so that symbols are compared and copied as integers.
+ Registered strings are never released, so references to them are always valid.
+ Empty string is the symbol whose ID is 0.
+ */
+class PhonemeSymbol
+{
+public:
+   //! constructor (empty symbol)
+   PhonemeSymbol();
+
+   //! constructor (string is registered if it has not been registered yet)
+   explicit PhonemeSymbol(const std::string& str);
+
+   //! copy constructor
+   PhonemeSymbol(const PhonemeSymbol& obj);
+
+   //! destructor
+   virtual ~PhonemeSymbol();
+
+   //! assignment operator
+   PhonemeSymbol& operator=(const PhonemeSymbol& obj);
+
+   //! equal
+   bool operator==(const PhonemeSymbol& obj) const;
+
+   //! not equal
+   bool operator!=(const PhonemeSymbol& obj) const;
+
+   //! less than (order of IDs)
+   bool operator<(const PhonemeSymbol& obj) const;
+
+   //! get ID
+   size_t getId() const;
+
+   //! get string
+   const std::string& getString() const;
+
+   //! symbol is empty or not
+   bool empty() const;
+
+   //! entry of symbol table
+   struct Entry;
+
+private:
+   //! entry (NULL if empty)
+   const Entry* entry;
+};
+
+//! to stream
+std::ostream& operator<<(std::ostream& os, const PhonemeSymbol& symbol);
+
+};
+
+#endif // SINSY_PHONEME_SYMBOL_H_
@@ -39,9 +39,11 @@
 /* POSSIBILITY OF SUCH DAMAGE.                                       */
 /* ----------------------------------------------------------------- */
 
+#include <map>
 #include <fstream>
 #include "PhonemeTable.h"
 #include "StringTokenizer.h"
+#include "StreamException.h"
 #include "util_log.h"
 #include "util_string.h"
 
@@ -138,12 +140,9 @@ PhonemeTable::~PhonemeTable()
 */
 void PhonemeTable::clear()
 {
-   ConvertTable::iterator itr(convertTable.begin());
-   ConvertTable::iterator itrEnd(convertTable.end());
-   for (; itr != itrEnd; ++itr) {
-      delete itr->second;
-   }
-   convertTable.clear();
+   syllables.clear();
+   phonemeLists.clear();
+   trie.clear();
 }
 
 /*!
@@ -162,6 +161,8 @@ bool PhonemeTable::read(const std::string& fname)
 
    clear();
 
+   typedef std::map<std::string, PhonemeList> ConvertTable;
+   ConvertTable convertTable;
    std::string buffer;
 
    while (!ifs.eof()) {
@@ -175,34 +176,120 @@ bool PhonemeTable::read(const std::string& fname)
          ERR_MSG("Wrong phoneme table (value is needed after key) : " << fname);
          return false;
       }
-      PhonemeList* pl(new PhonemeList);
-      pl->reserve(sz - 1);
-      for (size_t i(1); i < sz; ++i) {
-         pl->push_back(st.at(i));
-      }
-      if (false == convertTable.insert(std::make_pair(st.at(0), pl)).second) {
+      std::pair<ConvertTable::iterator, bool> inserted(convertTable.insert(std::make_pair(st.at(0), PhonemeList())));
+      if (false == inserted.second) {
          ERR_MSG("Wrong phoneme table (some syllables have same name : " << st.at(0) << ") : " << fname);
-         delete pl;
          return false;
       }
+      PhonemeList& pl(inserted.first->second);
+      pl.reserve(sz - 1);
+      for (size_t i(1); i < sz; ++i) {
+         pl.push_back(PhonemeSymbol(st.at(i)));
+      }
    }
+
+   // build trie for longest match
+   ByteTrie::KeyList keys;
+   keys.reserve(convertTable.size());
+   syllables.reserve(convertTable.size());
+   phonemeLists.reserve(convertTable.size());
+   for (ConvertTable::const_iterator itr(convertTable.begin()); convertTable.end() != itr; ++itr) {
+      keys.push_back(std::make_pair(itr->first, syllables.size()));
+      syllables.push_back(itr->first);
+      phonemeLists.push_back(itr->second);
+   }
+   trie.build(keys);
+
    return true;
 }
 
 /*!
- find from table
+ write to dictionary image
+
+ Phonemes are stored once in a symbol list, and each syllable has an array of phoneme IDs.
  */
-PhonemeTable::Result PhonemeTable::find(const std::string& syllable) const
+void PhonemeTable::write(DicImage::Writer& writer) const
 {
-   for (size_t sz(syllable.size()); 0 < sz ; --sz) {
-      std::string s(syllable.substr(0, sz));
+   typedef std::map<PhonemeSymbol, UINT32> SymbolMap;
+   SymbolMap symbolMap;
+   std::vector<PhonemeSymbol> symbols;
+   for (std::vector<PhonemeList>::const_iterator itr(phonemeLists.begin()); phonemeLists.end() != itr; ++itr) {
+      for (PhonemeList::const_iterator pItr(itr->begin()); itr->end() != pItr; ++pItr) {
+         if (symbolMap.insert(std::make_pair(*pItr, static_cast<UINT32>(symbols.size()))).second) {
+            symbols.push_back(*pItr);
+         }
+      }
+   }
+
+   writer.writeUInt32(static_cast<UINT32>(symbols.size()));
+   for (std::vector<PhonemeSymbol>::const_iterator itr(symbols.begin()); symbols.end() != itr; ++itr) {
+      writer.writeString(itr->getString());
+   }
 
-      ConvertTable::const_iterator itr(convertTable.find(s));
-      if (convertTable.end() != itr) {
-         return Result(itr->first, itr->second);
+   writer.writeUInt32(static_cast<UINT32>(syllables.size()));
+   std::vector<UINT32> ids;
+   for (size_t i(0); i < syllables.size(); ++i) {
+      writer.writeString(syllables[i]);
+      const PhonemeList& pl(phonemeLists[i]);
+      ids.resize(pl.size());
+      for (size_t j(0); j < pl.size(); ++j) {
+         ids[j] = symbolMap[pl[j]];
       }
+      writer.writeUInt32(static_cast<UINT32>(ids.size()));
+      writer.writeUInt32Array(ids.empty() ? NULL : &ids[0], ids.size());
+   }
+
+   trie.write(writer);
+}
+
+/*!
+ read from dictionary image
+
+ Trie is used in place, and phoneme lists are made from arrays of phoneme IDs
+ (IDs in image are local to the table, and they are mapped to global symbols).
+ */
+void PhonemeTable::read(DicImage::Reader& reader)
+{
+   clear();
+
+   const size_t symbolNum(reader.readUInt32());
+   std::vector<PhonemeSymbol> symbols(symbolNum);
+   std::string symbol;
+   for (size_t i(0); i < symbolNum; ++i) {
+      reader.readString(symbol);
+      symbols[i] = PhonemeSymbol(symbol);
+   }
+
+   const size_t syllableNum(reader.readUInt32());
+   syllables.resize(syllableNum);
+   phonemeLists.resize(syllableNum);
+   for (size_t i(0); i < syllableNum; ++i) {
+      reader.readString(syllables[i]);
+      const size_t phonemeNum(reader.readUInt32());
+      const UINT32* ids(reader.readUInt32Array(phonemeNum));
+      PhonemeList& pl(phonemeLists[i]);
+      pl.reserve(phonemeNum);
+      for (size_t j(0); j < phonemeNum; ++j) {
+         if (symbolNum <= ids[j]) {
+            throw StreamException("PhonemeTable::read() invalid phoneme ID");
+         }
+         pl.push_back(symbols[ids[j]]);
+      }
+   }
+
+   trie.read(reader, syllableNum);
+}
+
+/*!
+ find longest syllable that is prefix of given string
+ */
+PhonemeTable::Result PhonemeTable::find(const std::string& syllable) const
+{
+   size_t idx(0);
+   if (0 == trie.findLongest(syllable.data(), syllable.size(), idx)) {
+      return Result();
    }
-   return Result();
+   return Result(syllables[idx], &phonemeLists[idx]);
 }
 
 /*!
@@ -210,11 +297,11 @@ PhonemeTable::Result PhonemeTable::find(const std::string& syllable) const
  */
 PhonemeTable::Result PhonemeTable::match(const std::string& syllable) const
 {
-   ConvertTable::const_iterator itr(convertTable.find(syllable));
-   if (convertTable.end() != itr) {
-      return Result(itr->first, itr->second);
+   size_t idx(0);
+   if (!trie.find(syllable.data(), syllable.size(), idx)) {
+      return Result();
    }
-   return Result();
+   return Result(syllables[idx], &phonemeLists[idx]);
 }
 
 };  // namespace sinsy
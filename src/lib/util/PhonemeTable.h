@@ -42,9 +42,10 @@
 #ifndef SINSY_PHONEME_TABLE_H_
 #define SINSY_PHONEME_TABLE_H_
 
-#include <map>
 #include <vector>
 #include <string>
+#include "ByteTrie.h"
+#include "PhonemeSymbol.h"
 
 namespace sinsy
 {
@@ -52,7 +53,7 @@ namespace sinsy
 class PhonemeTable
 {
 public:
-   typedef std::vector<std::string> PhonemeList;
+   typedef std::vector<PhonemeSymbol> PhonemeList;
 
    class Result
    {
@@ -105,6 +106,12 @@ public:
    //! read from file
    bool read(const std::string& fname);
 
+   //! write to dictionary image
+   void write(DicImage::Writer& writer) const;
+
+   //! read from dictionary image (image must outlive table)
+   void read(DicImage::Reader& reader);
+
    //! find from table
    Result find(const std::string& syllable) const;
 
@@ -118,10 +125,14 @@ private:
    //! assignment operator (donot use)
    PhonemeTable& operator=(const PhonemeTable&);
 
-   typedef std::map<std::string, PhonemeList*> ConvertTable;
+   //! syllables (indexed by values of trie)
+   std::vector<std::string> syllables;
+
+   //! phoneme lists of syllables
+   std::vector<PhonemeList> phonemeLists;
 
-   //! convert table
-   ConvertTable convertTable;
+   //! trie of syllables
+   ByteTrie trie;
 };
 
 };
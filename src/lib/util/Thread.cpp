@@ -0,0 +1,169 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include "util_log.h"
+#include "Thread.h"
+
+namespace sinsy
+{
+
+/*!
+ @internal
+
+ handle of thread
+ */
+struct Thread::Handle {
+#ifdef _WIN32
+   HANDLE thread;
+#else
+   pthread_t thread;
+#endif
+};
+
+namespace
+{
+#ifdef _WIN32
+unsigned __stdcall runThread(void* arg)
+{
+   static_cast<IRunnable*>(arg)->run();
+   return 0;
+}
+#else
+void* runThread(void* arg)
+{
+   static_cast<IRunnable*>(arg)->run();
+   return NULL;
+}
+#endif
+};
+
+/*!
+ constructor
+ */
+Thread::Thread(IRunnable& r) : runnable(r), handle(NULL)
+{
+}
+
+/*!
+ destructor
+ */
+Thread::~Thread()
+{
+   join();
+}
+
+/*!
+ start thread
+
+ @return true if thread is started
+ */
+bool Thread::start()
+{
+   if (NULL != handle) {
+      ERR_MSG("Thread::start() thread is already started");
+      return false;
+   }
+   Handle* h(new Handle);
+#ifdef _WIN32
+   h->thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, runThread, &runnable, 0, NULL));
+   if (0 == h->thread) {
+      delete h;
+      ERR_MSG("Thread::start() cannot create thread");
+      return false;
+   }
+#else
+   if (0 != pthread_create(&h->thread, NULL, runThread, &runnable)) {
+      delete h;
+      ERR_MSG("Thread::start() cannot create thread");
+      return false;
+   }
+#endif
+   handle = h;
+   return true;
+}
+
+/*!
+ wait for thread
+ */
+void Thread::join()
+{
+   if (NULL == handle) {
+      return;
+   }
+#ifdef _WIN32
+   WaitForSingleObject(handle->thread, INFINITE);
+   CloseHandle(handle->thread);
+#else
+   pthread_join(handle->thread, NULL);
+#endif
+   delete handle;
+   handle = NULL;
+}
+
+/*!
+ get number of processors
+
+ @return number of processors (1 if unknown)
+ */
+size_t Thread::getProcessorNum()
+{
+#ifdef _WIN32
+   SYSTEM_INFO info;
+   GetSystemInfo(&info);
+   if (0 < info.dwNumberOfProcessors) {
+      return static_cast<size_t>(info.dwNumberOfProcessors);
+   }
+#elif defined(_SC_NPROCESSORS_ONLN)
+   long num(sysconf(_SC_NPROCESSORS_ONLN));
+   if (0 < num) {
+      return static_cast<size_t>(num);
+   }
+#endif
+   return 1;
+}
+
+};  // namespace sinsy
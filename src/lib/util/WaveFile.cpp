@@ -0,0 +1,231 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <algorithm>
+#include "util_types.h"
+#include "WaveFile.h"
+
+namespace sinsy
+{
+
+namespace
+{
+const size_t HEADER_SIZE = 44;
+const size_t BLOCK_SIZE = 1024;
+
+/*!
+ set little endian value to buffer
+ */
+void setLittleEndian(unsigned char* buffer, size_t value, size_t byte)
+{
+   for (size_t i(0); i < byte; ++i) {
+      buffer[i] = static_cast<unsigned char>((value >> (8 * i)) & 0xff);
+   }
+}
+};
+
+/*!
+ constructor
+ */
+WaveFile::WaveFile() : fp(NULL), buffer(NULL), samplingFrequency(0), sampleNum(0)
+{
+}
+
+/*!
+ destructor
+ */
+WaveFile::~WaveFile()
+{
+   close();
+}
+
+/*!
+ open RIFF format file
+
+ @param fpath file path
+ @param sf sampling frequency
+ @return true if success
+ */
+bool WaveFile::open(const std::string& fpath, size_t sf)
+{
+   close();
+   fp = fopen(fpath.c_str(), "wb");
+   if (NULL == fp) {
+      return false;
+   }
+   samplingFrequency = sf;
+   sampleNum = 0;
+   if (!writeHeader()) {
+      fclose(fp);
+      fp = NULL;
+      return false;
+   }
+   return true;
+}
+
+/*!
+ open memory buffer to store RIFF format data (contents of buffer are replaced)
+
+ @param b buffer
+ @param sf sampling frequency
+ @return true if success
+ */
+bool WaveFile::open(std::vector<char>& b, size_t sf)
+{
+   close();
+   buffer = &b;
+   buffer->clear();
+   samplingFrequency = sf;
+   sampleNum = 0;
+   return writeHeader();
+}
+
+/*!
+ write waveform (samples are clipped to 16bit)
+
+ @param waveform waveform
+ @param size number of samples
+ @return true if success
+ */
+bool WaveFile::write(const double* waveform, size_t size)
+{
+   if (!isValid()) {
+      return false;
+   }
+   unsigned char block[BLOCK_SIZE * 2];
+   size_t idx(0);
+   while (idx < size) {
+      size_t num(size - idx);
+      if (BLOCK_SIZE < num) {
+         num = BLOCK_SIZE;
+      }
+      for (size_t i(0); i < num; ++i) {
+         const double x(waveform[idx + i]);
+         INT16 value;
+         if (32767.0 < x) {
+            value = 32767;
+         } else if (x < -32768.0) {
+            value = -32768;
+         } else {
+            value = static_cast<INT16>(x);
+         }
+         setLittleEndian(block + i * 2, static_cast<UINT16>(value), 2);
+      }
+      if (!writeData(block, num * 2)) {
+         return false;
+      }
+      idx += num;
+   }
+   sampleNum += size;
+   return true;
+}
+
+/*!
+ close file
+ */
+void WaveFile::close()
+{
+   if (NULL != buffer) {
+      writeHeader();
+      buffer = NULL;
+      return;
+   }
+   if (NULL == fp) {
+      return;
+   }
+   if (0 == fseek(fp, 0, SEEK_SET)) {
+      writeHeader();
+   }
+   fclose(fp);
+   fp = NULL;
+}
+
+/*!
+ file or buffer is valid or not
+ */
+bool WaveFile::isValid() const
+{
+   return (NULL != fp) || (NULL != buffer);
+}
+
+/*!
+ @internal
+
+ write header
+ */
+bool WaveFile::writeHeader()
+{
+   const size_t dataSize(sampleNum * 2);
+   unsigned char header[HEADER_SIZE] = {
+      'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 16, 0,
+      'd', 'a', 't', 'a', 0, 0, 0, 0
+   };
+   setLittleEndian(header + 4, HEADER_SIZE - 8 + dataSize, 4);
+   setLittleEndian(header + 24, samplingFrequency, 4);
+   setLittleEndian(header + 28, samplingFrequency * 2, 4);
+   setLittleEndian(header + 40, dataSize, 4);
+   if (NULL != buffer) {
+      // header is at the beginning of buffer
+      if (buffer->size() < HEADER_SIZE) {
+         buffer->resize(HEADER_SIZE);
+      }
+      std::copy(header, header + HEADER_SIZE, buffer->begin());
+      return true;
+   }
+   return (1 == fwrite(header, HEADER_SIZE, 1, fp));
+}
+
+/*!
+ @internal
+
+ write data to file or buffer
+ */
+bool WaveFile::writeData(const unsigned char* data, size_t size)
+{
+   if (NULL != buffer) {
+      buffer->insert(buffer->end(), data, data + size);
+      return true;
+   }
+   return (fwrite(data, 1, size, fp) == size);
+}
+
+};  // namespace sinsy
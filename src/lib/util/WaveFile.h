@@ -0,0 +1,103 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_WAVE_FILE_H_
+#define SINSY_WAVE_FILE_H_
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace sinsy
+{
+
+class WaveFile
+{
+public:
+   //! constructor
+   WaveFile();
+
+   //! destructor
+   virtual ~WaveFile();
+
+   //! open RIFF format file (16bit, monaural)
+   bool open(const std::string& fpath, size_t samplingFrequency);
+
+   //! open memory buffer to store RIFF format data (16bit, monaural)
+   bool open(std::vector<char>& buffer, size_t samplingFrequency);
+
+   //! write waveform
+   bool write(const double* waveform, size_t size);
+
+   //! close (sizes in header are fixed)
+   void close();
+
+   //! file or buffer is valid or not
+   bool isValid() const;
+
+private:
+   //! copy constructor (donot use)
+   WaveFile(const WaveFile&);
+
+   //! assignment operator (donot use)
+   WaveFile& operator=(const WaveFile&);
+
+   //! write header
+   bool writeHeader();
+
+   //! write data to file or buffer
+   bool writeData(const unsigned char* data, size_t size);
+
+   //! file pointer
+   FILE* fp;
+
+   //! memory buffer (used instead of file)
+   std::vector<char>* buffer;
+
+   //! sampling frequency
+   size_t samplingFrequency;
+
+   //! number of written samples
+   size_t sampleNum;
+};
+
+};
+
+#endif // SINSY_WAVE_FILE_H_
@@ -113,6 +113,15 @@ XmlData::XmlData(const std::string& t, const std::string& d) : tag(t), data(d)
    toLower(tag);
 }
 
+/*!
+ constructor
+
+ @param t tag (lower-case)
+ */
+XmlData::XmlData(const XmlStringRef& t) : tag(t.data(), t.size())
+{
+}
+
 /*!
  copy constructor
  */
@@ -164,6 +173,14 @@ void XmlData::setData(const std::string& str)
    data = str;
 }
 
+/*!
+ set data
+ */
+void XmlData::setData(const XmlStringRef& str)
+{
+   data.assign(str.data(), str.size());
+}
+
 /*!
  add child
  */
@@ -199,6 +216,18 @@ bool XmlData::addAttribute(const std::string& k, const std::string& v)
    return true;
 }
 
+/*!
+ add attribute
+ */
+bool XmlData::addAttribute(const XmlStringRef& k, const XmlStringRef& v)
+{
+   if (!attributes.insert(std::make_pair(k.toString(), v.toString())).second) {
+      ERR_MSG("Failed to insert attribute (" << k.toString() << ", " << v.toString() << ")");
+      return false;
+   }
+   return true;
+}
+
 /*!
  get attribute
  */
@@ -48,6 +48,7 @@
 #include "StreamException.h"
 #include "IStringable.h"
 #include "Beat.h"
+#include "XmlStringRef.h"
 
 namespace sinsy
 {
@@ -62,6 +63,9 @@ public:
    //! constructor
    XmlData(const std::string& t, const std::string& d = "");
 
+   //! constructor (tag has to be lower-case)
+   explicit XmlData(const XmlStringRef& t);
+
    //! copy constructor
    XmlData(const XmlData&);
 
@@ -77,6 +81,9 @@ public:
    //! set data
    void setData(const std::string& str);
 
+   //! set data
+   void setData(const XmlStringRef& str);
+
    //! add child
    Children::iterator addChild(XmlData* child);
 
@@ -86,6 +93,9 @@ public:
    //! add attribute
    bool addAttribute(const std::string& k, const std::string& v);
 
+   //! add attribute (key and value have to be lower-case)
+   bool addAttribute(const XmlStringRef& k, const XmlStringRef& v);
+
    //! get attribute
    const std::string& getAttribute(const std::string& k) const;
 
@@ -45,6 +45,7 @@
 #include <vector>
 #include <string>
 #include "XmlData.h"
+#include "XmlTokenizer.h"
 
 namespace sinsy
 {
@@ -61,6 +62,9 @@ public:
    //! read xml from stream
    XmlData* read(IReadableStream& stream, std::string& encoding) throw (StreamException);
 
+   //! read an element whose start tag is the current tag of tokenizer
+   XmlData* readElement(XmlTokenizer& tokenizer) throw (StreamException);
+
 private:
    //! copy constructor (donot use)
    XmlParser(const XmlParser&);
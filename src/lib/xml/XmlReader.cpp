@@ -57,6 +57,7 @@
 #include "ScorePosition.h"
 #include "xml_tags.h"
 #include "util_score.h"
+#include "XmlTokenizer.h"
 
 namespace sinsy
 {
@@ -275,39 +276,25 @@ public:
    MeasureScore() {}
 
    //! destructor
-   virtual ~MeasureScore() {
-      clear();
-   }
-
-   //! clear
-   void clear() {
-      TempScore::clear();
-      noteAdders.clear();
-   }
-
-   //! add note
-   void addNote(const Note& note) {
-      XmlNoteAdder* n(new XmlNoteAdder(note));
-      tempList.push_back(n);
-      noteAdders.push_back(n);
-   }
+   virtual ~MeasureScore() {}
 
    //! adjust duration
    void adjustDuration(size_t duration) {
       size_t totalDur(0);
-      NoteAdders::iterator itrEnd(noteAdders.end());
-      for (NoteAdders::iterator itr(noteAdders.begin()); itrEnd != itr; ++itr) {
+      const size_t noteNum(getNoteNum());
+      for (size_t i(0); i < noteNum; ++i) {
+         Note& note(getNote(i));
          // measure cannot conclude this note, because duration of notes in this measure is too long
          if (duration == totalDur) {
             WARN_MSG("Number of notes in a measure is too large");
-            (*itr)->setDuration(0);
+            note.setDuration(0);
          } else {
-            size_t dur((*itr)->getDuration());
+            size_t dur(note.getDuration());
             totalDur += dur;
             // note duration is too long
             if (duration < totalDur) {
                WARN_MSG("Duration of notes in a measure is too long");
-               (*itr)->setDuration(dur + duration - totalDur);
+               note.setDuration(dur + duration - totalDur);
                totalDur = duration;
             }
          }
@@ -316,14 +303,22 @@ public:
       // duration of notes in this measure is too short
       if (totalDur < duration) {
          WARN_MSG("Duration of notes in a measure is too short");
-         if (noteAdders.empty()) {
+         if (0 == getNoteNum()) {
             Note note;
             note.setRest(true);
-            this->addNote(note);
+            moveNote(note);
          }
-         XmlNoteAdder* n(noteAdders.back());
-         size_t dur(n->getDuration());
-         n->setDuration(dur + duration - totalDur);
+         Note& note(getNote(getNoteNum() - 1));
+         size_t dur(note.getDuration());
+         note.setDuration(dur + duration - totalDur);
+      }
+   }
+
+protected:
+   //! write note (notes whose duration is zero are skipped)
+   virtual void writeNote(IScoreWritable& sm, const Note& note) const {
+      if (0 < note.getDuration()) {
+         sm.addNote(note);
       }
    }
 
@@ -333,42 +328,6 @@ private:
 
    //! assignment operator (donot use)
    MeasureScore& operator=(const MeasureScore&);
-
-   class XmlNoteAdder : public ITempData
-   {
-   public:
-      //! constructor
-      XmlNoteAdder(const Note& n) : note(n) {}
-
-      //! destructor
-      virtual ~XmlNoteAdder() {}
-
-      //! write to score
-      virtual void write(IScoreWritable& sm) const {
-         if (0 < note.getDuration()) {
-            sm.addNote(note);
-         }
-      }
-
-      //! get duration
-      size_t getDuration() const {
-         return note.getDuration();
-      }
-
-      //! set duration
-      void setDuration(size_t d) {
-         note.setDuration(d);
-      }
-
-   private:
-      //! note
-      Note note;
-   };
-
-   typedef std::vector<XmlNoteAdder*> NoteAdders;
-
-   //! list of note adders
-   NoteAdders noteAdders;
 };
 
 class XmlContainer
@@ -395,6 +354,18 @@ public:
       std::for_each(xmlData->childBegin(), xmlData->childEnd(), Adapter(container, &XmlContainer::convertScorePartwiseChildren));
    }
 
+   //! write a child of measure tag
+   void writeMeasureChild(const XmlData* data) {
+      convertMeasureChildren(data);
+   }
+
+   //! write notes in the measure which is concluded
+   void writeMeasureEnd() {
+      measureScore.adjustDuration(getMeasureDuration(beat));
+      scoreWritable << measureScore;
+      measureScore.clear();
+   }
+
 private:
    //! copy constructor (donot use)
    XmlContainer(const XmlContainer&);
@@ -502,7 +473,7 @@ private:
 
       note.setDuration(note.getDuration() * BASE_DIVISIONS / divisions); // divisions : 960
 
-      measureScore.addNote(note);
+      measureScore.moveNote(note);
    }
 
    //! convert attributes children
@@ -564,9 +535,7 @@ private:
    void convertPartChildren(const XmlData* data) {
       if (0 == data->getTag().compare(TAG_MEASURE)) {
          std::for_each(data->childBegin(), data->childEnd(), Adapter(*this, &XmlContainer::convertMeasureChildren));
-         measureScore.adjustDuration(getMeasureDuration(beat));
-         scoreWritable << measureScore;
-         measureScore.clear();
+         writeMeasureEnd();
       }
    }
 
@@ -601,6 +570,27 @@ private:
    double tempo;
 };
 
+/*!
+ skip an element whose start tag is the current tag of tokenizer
+ */
+void skipElement(XmlTokenizer& tokenizer)
+{
+   if (XmlTokenizer::TAG_TYPE_START != tokenizer.getType()) {
+      return;
+   }
+   size_t depth(1);
+   while (0 < depth) {
+      if (!tokenizer.next()) {
+         throw StreamException("skipElement() end of file");
+      }
+      if (XmlTokenizer::TAG_TYPE_START == tokenizer.getType()) {
+         ++depth;
+      } else if (XmlTokenizer::TAG_TYPE_END == tokenizer.getType()) {
+         --depth;
+      }
+   }
+}
+
 }; // namespace
 
 /*!
@@ -682,6 +672,94 @@ bool XmlReader::readXml(IReadableStream& stream)
    return true;
 }
 
+/*!
+ read xml from stream and write it to score
+
+ Only one child of measure tag is kept as xml data at a time,
+ and notes are written to score whenever measure tag is closed.
+
+ @param stream   input stream
+ @param writable score
+ @return if success, true
+ */
+bool XmlReader::readXml(IReadableStream& stream, IScoreWritable& writable)
+{
+   try {
+      XmlTokenizer tokenizer(stream);
+      XmlContainer container(writable);
+      XmlStringRef key;
+      XmlStringRef value;
+
+      // nested tags : <score-partwise> <part> <measure>
+      const std::string nestedTags[] = {TAG_SCORE_PARTWISE, TAG_PART, TAG_MEASURE};
+      const size_t nestedTagsSize(sizeof(nestedTags) / sizeof(nestedTags[0]));
+      size_t depth(0);
+
+      for ( ; ; ) {
+         if (!tokenizer.next()) {
+            throw StreamException("XmlReader::readXml() end of file");
+         }
+         const XmlStringRef& tag(tokenizer.getTag());
+         const XmlTokenizer::TagType type(tokenizer.getType());
+
+         if (XmlTokenizer::TAG_TYPE_DECLARATION == type) { // processing instruction
+            if ((0 == depth) && tag.equals("xml")) { // if <?xml ... ?> tag, read character encoding
+               while (tokenizer.nextAttribute(key, value)) {
+                  if (key.equals("encoding") && !value.empty()) {
+                     encoding = value.toString();
+                  }
+               }
+            }
+         } else if (XmlTokenizer::TAG_TYPE_END == type) { // end tag
+            if (0 == depth) {
+               throw StreamException("start tag is needed before end tag");
+            }
+            if (!tag.equals(nestedTags[depth - 1])) {
+               throw StreamException("start tag and end tag are not match");
+            }
+            if (nestedTagsSize == depth) {
+               container.writeMeasureEnd();
+            }
+            --depth;
+            if (0 == depth) {
+               break;
+            }
+         } else if (0 == depth) { // first tag
+            if (!tag.equals(TAG_SCORE_PARTWISE)) {
+               ERR_MSG("First tag of XML file is not equal to <score_partwise>");
+               throw std::runtime_error("First tag of XML file is not equal to <score_partwise>");
+            }
+            writable.setEncoding(encoding);
+            if (XmlTokenizer::TAG_TYPE_EMPTY == type) {
+               break;
+            }
+            ++depth;
+         } else if (nestedTagsSize == depth) { // child of measure tag
+            XmlData* data(parser.readElement(tokenizer));
+            try {
+               container.writeMeasureChild(data);
+            } catch (const std::exception&) {
+               delete data;
+               throw;
+            }
+            delete data;
+         } else if (tag.equals(nestedTags[depth])) {
+            if (XmlTokenizer::TAG_TYPE_START == type) {
+               ++depth;
+            } else if (nestedTagsSize == depth + 1) { // empty measure
+               container.writeMeasureEnd();
+            }
+         } else {
+            skipElement(tokenizer);
+         }
+      }
+   } catch (const std::exception& ex) {
+      ERR_MSG("XML file reading error : " << ex.what());
+      return false;
+   }
+   return true;
+}
+
 /*!
  get xml data
  */
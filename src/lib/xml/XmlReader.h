@@ -70,6 +70,9 @@ public:
    //! read xml from stream
    bool readXml(IReadableStream& stream);
 
+   //! read xml from stream and write it to score measure by measure (xml data is not kept)
+   bool readXml(IReadableStream& stream, IScoreWritable& writable);
+
    //! get xml data
    const XmlData* getXmlData() const;
 
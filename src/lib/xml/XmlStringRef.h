@@ -0,0 +1,116 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_XML_STRING_REF_H_
+#define SINSY_XML_STRING_REF_H_
+
+#include <string>
+#include <cstring>
+#include "util_types.h"
+
+namespace sinsy
+{
+
+/*!
+ reference to characters in a buffer (does not own the characters)
+ */
+class XmlStringRef
+{
+public:
+   //! constructor
+   XmlStringRef() : ptr(NULL), len(0) {}
+
+   //! constructor
+   XmlStringRef(const char* p, size_t l) : ptr(p), len(l) {}
+
+   //! copy constructor
+   XmlStringRef(const XmlStringRef& obj) : ptr(obj.ptr), len(obj.len) {}
+
+   //! destructor
+   virtual ~XmlStringRef() {}
+
+   //! assignment operator
+   XmlStringRef& operator=(const XmlStringRef& obj) {
+      ptr = obj.ptr;
+      len = obj.len;
+      return *this;
+   }
+
+   //! get pointer to first character
+   const char* data() const {
+      return ptr;
+   }
+
+   //! get number of characters
+   size_t size() const {
+      return len;
+   }
+
+   //! empty or not
+   bool empty() const {
+      return 0 == len;
+   }
+
+   //! equal to str or not
+   bool equals(const char* str) const {
+      return ((0 == len) || (0 == strncmp(ptr, str, len))) && ('\0' == str[len]);
+   }
+
+   //! equal to str or not
+   bool equals(const std::string& str) const {
+      return (len == str.size()) && (0 == str.compare(0, len, ptr, len));
+   }
+
+   //! convert to string
+   std::string toString() const {
+      return std::string(ptr, len);
+   }
+
+private:
+   //! pointer to first character
+   const char* ptr;
+
+   //! number of characters
+   size_t len;
+};
+
+};
+
+#endif // SINSY_XML_STRING_REF_H_
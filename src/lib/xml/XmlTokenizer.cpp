@@ -0,0 +1,361 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include "XmlTokenizer.h"
+#include "util_log.h"
+
+namespace sinsy
+{
+
+namespace
+{
+const char* LESS_THAN = "<";
+const char* GREATER_THAN = ">";
+const char* COMMENT_BEGIN = "!--";
+const char* COMMENT_END = "-->";
+const char* CDATA_BEGIN = "![CDATA[";
+const char* CDATA_END = "]]>";
+
+/*!
+ c is blank character or not (same as BLANK_STR)
+ */
+inline bool isBlankChar(char c)
+{
+   return (' ' == c) || ('\t' == c) || ('\r' == c) || ('\n' == c);
+}
+
+/*!
+ convert c to lower-case
+ */
+inline void toLowerChar(char& c)
+{
+   if (('A' <= c) && (c <= 'Z')) {
+      c = static_cast<char>(c - 'A' + 'a');
+   }
+}
+
+/*!
+ cut left and right blanks of [begin, end)
+ */
+void cutBlanks(const char* str, size_t& begin, size_t& end)
+{
+   while ((begin < end) && isBlankChar(str[begin])) {
+      ++begin;
+   }
+   while ((begin < end) && isBlankChar(str[end - 1])) {
+      --end;
+   }
+}
+
+/*!
+ [begin, end) of str starts with prefix or not
+ */
+bool startsWith(const char* str, size_t begin, size_t end, const char* prefix)
+{
+   const size_t sz(strlen(prefix));
+   return (sz <= end - begin) && (0 == strncmp(str + begin, prefix, sz));
+}
+
+};
+
+const size_t XmlTokenizer::DEFAULT_BUFFER_SIZE = 1024 * 1024;
+
+/*!
+ constructor
+
+ @param s  input stream
+ @param sz initial size of buffer
+ */
+XmlTokenizer::XmlTokenizer(IReadableStream& s, size_t sz) :
+   stream(s), buffer((0 < sz) ? sz : DEFAULT_BUFFER_SIZE), head(0), tail(0), eos(false),
+   type(TAG_TYPE_START), attributeIndex(0), attributeEnd(0)
+{
+}
+
+/*!
+ destructor
+ */
+XmlTokenizer::~XmlTokenizer()
+{
+}
+
+/*!
+ read next tag
+
+ @return false if stream ends before next tag
+ */
+bool XmlTokenizer::next() throw (StreamException)
+{
+   for ( ; ; ) {
+      const size_t lt(find(0, LESS_THAN, 1));
+      if (std::string::npos == lt) {
+         head = tail;
+         return false;
+      }
+      size_t gt(find(lt + 1, GREATER_THAN, 1));
+      if (std::string::npos == gt) {
+         throw StreamException("XmlTokenizer::next() tag is not closed");
+      }
+
+      // comments and CDATA may contain '>'
+      if (startsWith(&buffer[head], lt + 1, gt, COMMENT_BEGIN)) {
+         gt = find(lt + 1 + strlen(COMMENT_BEGIN), COMMENT_END, strlen(COMMENT_END));
+         if (std::string::npos == gt) {
+            throw StreamException("XmlTokenizer::next() comment is not closed");
+         }
+         head += gt + strlen(COMMENT_END);
+         continue;
+      } else if (startsWith(&buffer[head], lt + 1, gt, CDATA_BEGIN)) {
+         gt = find(lt + 1 + strlen(CDATA_BEGIN), CDATA_END, strlen(CDATA_END));
+         if (std::string::npos == gt) {
+            throw StreamException("XmlTokenizer::next() CDATA is not closed");
+         }
+         head += gt + strlen(CDATA_END);
+         continue;
+      }
+
+      // buffer is not moved any more in this tag
+      char* const base(&buffer[head]);
+
+      size_t textBegin(0);
+      size_t textEnd(lt);
+      cutBlanks(base, textBegin, textEnd);
+      text = XmlStringRef(base + textBegin, textEnd - textBegin);
+
+      size_t begin(lt + 1);
+      size_t end(gt);
+      cutBlanks(base, begin, end);
+      if (begin == end) {
+         throw StreamException("XmlTokenizer::next() tag is empty : <>");
+      }
+
+      if ('/' == base[begin]) { // end tag
+         type = TAG_TYPE_END;
+         ++begin;
+      } else if ('?' == base[begin]) { // processing instruction
+         type = TAG_TYPE_DECLARATION;
+         ++begin;
+         if ((begin < end) && ('?' == base[end - 1])) {
+            --end;
+         }
+      } else if ('!' == base[begin]) { // skip
+         head += gt + 1;
+         continue;
+      } else if ('/' == base[end - 1]) { // start tag which donot need end tag
+         type = TAG_TYPE_EMPTY;
+         --end;
+      } else { // start tag
+         type = TAG_TYPE_START;
+      }
+      cutBlanks(base, begin, end);
+
+      size_t idx(begin);
+      for (; (idx < end) && !isBlankChar(base[idx]); ++idx) {
+         toLowerChar(base[idx]);
+      }
+      tag = XmlStringRef(base + begin, idx - begin);
+
+      attributeIndex = head + idx;
+      attributeEnd = head + end;
+      head += gt + 1;
+      return true;
+   }
+}
+
+/*!
+ get type of current tag
+ */
+XmlTokenizer::TagType XmlTokenizer::getType() const
+{
+   return type;
+}
+
+/*!
+ get name of current tag
+ */
+const XmlStringRef& XmlTokenizer::getTag() const
+{
+   return tag;
+}
+
+/*!
+ get text between previous tag and current tag
+ */
+const XmlStringRef& XmlTokenizer::getText() const
+{
+   return text;
+}
+
+/*!
+ read next attribute of current tag
+
+ @param key   key of attribute (lower-case)
+ @param value value of attribute (lower-case)
+ @return false if there is no more attribute
+ */
+bool XmlTokenizer::nextAttribute(XmlStringRef& key, XmlStringRef& value) throw (StreamException)
+{
+   char* const base(buffer.empty() ? NULL : &buffer[0]);
+   size_t idx(attributeIndex);
+   while ((idx < attributeEnd) && isBlankChar(base[idx])) {
+      ++idx;
+   }
+   if (attributeEnd <= idx) {
+      attributeIndex = attributeEnd;
+      return false;
+   }
+
+   // search '='
+   size_t at(idx);
+   while ((at < attributeEnd) && ('=' != base[at])) {
+      ++at;
+   }
+   if (attributeEnd == at) {
+      throw StreamException("XmlTokenizer::nextAttribute() '=' is not exist");
+   }
+   if (at == idx) {
+      throw StreamException("XmlTokenizer::nextAttribute() '=' is at the head of attribute");
+   }
+   size_t keyEnd(at);
+   cutBlanks(base, idx, keyEnd);
+   for (size_t i(idx); i < keyEnd; ++i) {
+      toLowerChar(base[i]);
+   }
+   key = XmlStringRef(base + idx, keyEnd - idx);
+
+   // attribute value must start with ' or "
+   idx = at + 1;
+   while ((idx < attributeEnd) && isBlankChar(base[idx])) {
+      ++idx;
+   }
+   if ((attributeEnd <= idx) || (('\'' != base[idx]) && ('\"' != base[idx]))) {
+      throw StreamException("xml attribute value needs \" or \'");
+   }
+   const char quotation(base[idx]);
+   ++idx;
+   const size_t start(idx);
+   while ((idx < attributeEnd) && (quotation != base[idx])) {
+      toLowerChar(base[idx]);
+      ++idx;
+   }
+   if (attributeEnd == idx) {
+      throw StreamException("xml attribute value needs \" or \'");
+   }
+   value = XmlStringRef(base + start, idx - start);
+
+   attributeIndex = idx + 1;
+   return true;
+}
+
+/*!
+ @internal
+
+ find str from unread data in buffer
+
+ @param index   index to start searching (relative to head of unread data)
+ @param str     string to search
+ @param strSize size of str
+ @return        index of str (relative to head of unread data), or std::string::npos if not found
+ */
+size_t XmlTokenizer::find(size_t index, const char* str, size_t strSize) throw (StreamException)
+{
+   for ( ; ; ) {
+      const size_t sz(tail - head);
+      if (index + strSize <= sz) {
+         const char* const begin(&buffer[head]);
+         const char* const end(begin + sz);
+         const char* itr(NULL);
+         if (1 == strSize) {
+            itr = static_cast<const char*>(memchr(begin + index, str[0], sz - index));
+            if (NULL == itr) {
+               itr = end;
+            }
+         } else {
+            itr = std::search(begin + index, end, str, str + strSize);
+         }
+         if (end != itr) {
+            return itr - begin;
+         }
+         index = sz - strSize + 1;
+      }
+      if (!fill()) {
+         return std::string::npos;
+      }
+   }
+}
+
+/*!
+ @internal
+
+ read more data from stream
+
+ @return false if stream ends
+ */
+bool XmlTokenizer::fill() throw (StreamException)
+{
+   if (eos) {
+      return false;
+   }
+
+   // move unread data to the head of buffer
+   if (0 < head) {
+      if (head < tail) {
+         memmove(&buffer[0], &buffer[head], tail - head);
+      }
+      tail -= head;
+      head = 0;
+   }
+   if (tail == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+   }
+
+   const size_t result(stream.read(&buffer[tail], buffer.size() - tail));
+   if (0 == result) {
+      eos = true;
+      return false;
+   }
+   tail += result;
+   return true;
+}
+
+};  // namespace sinsy
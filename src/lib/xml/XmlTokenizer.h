@@ -0,0 +1,139 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#ifndef SINSY_XML_TOKENIZER_H_
+#define SINSY_XML_TOKENIZER_H_
+
+#include <vector>
+#include "IReadableStream.h"
+#include "XmlStringRef.h"
+
+namespace sinsy
+{
+
+/*!
+ tokenizer of xml
+
+ Reads the stream in large blocks into an internal buffer and splits it into tags.
+ Tag names and attributes are converted to lower-case in place, and all of them are
+ handed out as XmlStringRef that refer to the buffer. They are valid until next() is called.
+ */
+class XmlTokenizer
+{
+public:
+   //! type of tag
+   enum TagType {
+      TAG_TYPE_START, //!< start tag : <tag>
+      TAG_TYPE_END, //!< end tag : </tag>
+      TAG_TYPE_EMPTY, //!< start tag which donot need end tag : <tag/>
+      TAG_TYPE_DECLARATION //!< processing instruction : <?tag ?>
+   };
+
+   //! default size of buffer
+   static const size_t DEFAULT_BUFFER_SIZE;
+
+   //! constructor
+   explicit XmlTokenizer(IReadableStream& stream, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+   //! destructor
+   virtual ~XmlTokenizer();
+
+   //! read next tag (comments and declarations of document type are skipped)
+   bool next() throw (StreamException);
+
+   //! get type of current tag
+   TagType getType() const;
+
+   //! get name of current tag
+   const XmlStringRef& getTag() const;
+
+   //! get text between previous tag and current tag
+   const XmlStringRef& getText() const;
+
+   //! read next attribute of current tag
+   bool nextAttribute(XmlStringRef& key, XmlStringRef& value) throw (StreamException);
+
+private:
+   //! copy constructor (donot use)
+   XmlTokenizer(const XmlTokenizer&);
+
+   //! assignment operator (donot use)
+   XmlTokenizer& operator=(const XmlTokenizer&);
+
+   //! find str from buffer (if not found, read more data from stream)
+   size_t find(size_t index, const char* str, size_t strSize) throw (StreamException);
+
+   //! read more data from stream
+   bool fill() throw (StreamException);
+
+   //! stream
+   IReadableStream& stream;
+
+   //! buffer
+   std::vector<char> buffer;
+
+   //! head of unread data in buffer
+   size_t head;
+
+   //! tail of data in buffer
+   size_t tail;
+
+   //! stream is end or not
+   bool eos;
+
+   //! type of current tag
+   TagType type;
+
+   //! name of current tag
+   XmlStringRef tag;
+
+   //! text between previous tag and current tag
+   XmlStringRef text;
+
+   //! index of next attribute in buffer
+   size_t attributeIndex;
+
+   //! end of attributes in buffer
+   size_t attributeEnd;
+};
+
+};
+
+#endif // SINSY_XML_TOKENIZER_H_
@@ -0,0 +1,144 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sinsy.h"
+
+namespace
+{
+const char VALID_SCORE[] =
+   "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+   "<score-partwise><part id=\"P1\">"
+   "<measure number=\"1\"><attributes><divisions>1</divisions>"
+   "<time><beats>4</beats><beat-type>4</beat-type></time></attributes>"
+   "<note><pitch><step>C</step><octave>4</octave></pitch><duration>2</duration><lyric><text>a</text></lyric></note>"
+   "<note><pitch><step>D</step><octave>4</octave></pitch><duration>2</duration><lyric><text>i</text></lyric></note>"
+   "</measure>"
+   "<measure number=\"2\">"
+   "<note><pitch><step>E</step><octave>4</octave></pitch><duration>4</duration><lyric><text>u</text></lyric></note>"
+   "</measure>"
+   "</part></score-partwise>\n";
+
+//! first measure is complete, but document is broken in second measure
+const char BROKEN_SCORE[] =
+   "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+   "<score-partwise><part id=\"P1\">"
+   "<measure number=\"1\"><attributes><divisions>1</divisions></attributes>"
+   "<note><pitch><step>G</step><octave>4</octave></pitch><duration>4</duration><lyric><text>o</text></lyric></note>"
+   "</measure>"
+   "<measure number=\"2\">"
+   "<note><pitch><step>A</step><octave>4</octave>";
+
+class NoteCollector : public sinsy::IScore
+{
+public:
+   virtual bool setEncoding(const std::string&) {
+      return true;
+   }
+   virtual bool addKeyMark(sinsy::ModeType, int) {
+      return true;
+   }
+   virtual bool addBeatMark(size_t, size_t) {
+      return true;
+   }
+   virtual bool addTempoMark(double) {
+      return true;
+   }
+   virtual bool addSuddenDynamicsMark(sinsy::SuddenDynamicsType) {
+      return true;
+   }
+   virtual bool addGradualDynamicsMark(sinsy::GradualDynamicsType) {
+      return true;
+   }
+   virtual bool addNote(size_t duration, const std::string& lyric, size_t pitch, bool, bool, sinsy::TieType, sinsy::SlurType, sinsy::SyllabicType, bool) {
+      notes.push_back(Entry(duration, pitch, lyric));
+      return true;
+   }
+   virtual bool addRest(size_t duration) {
+      notes.push_back(Entry(duration, 0, "(rest)"));
+      return true;
+   }
+
+   struct Entry {
+      Entry(size_t d, size_t p, const std::string& l) : duration(d), pitch(p), lyric(l) {}
+      bool operator==(const Entry& e) const {
+         return (duration == e.duration) && (pitch == e.pitch) && (lyric == e.lyric);
+      }
+      size_t duration;
+      size_t pitch;
+      std::string lyric;
+   };
+
+   std::vector<Entry> notes;
+};
+
+int check(bool f, const char* message)
+{
+   if (!f) {
+      std::cerr << "FAILED: " << message << std::endl;
+      return 1;
+   }
+   return 0;
+}
+};
+
+int main()
+{
+   int failures(0);
+   sinsy::Sinsy sinsy;
+
+   failures += check(sinsy.loadScoreFromMusicXMLData(VALID_SCORE, strlen(VALID_SCORE)), "valid score is loaded");
+
+   NoteCollector before;
+   sinsy.toScore(before);
+   failures += check(3 == before.notes.size(), "valid score has three notes");
+
+   failures += check(!sinsy.loadScoreFromMusicXMLData(BROKEN_SCORE, strlen(BROKEN_SCORE)), "broken score is rejected");
+
+   NoteCollector after;
+   sinsy.toScore(after);
+   failures += check(before.notes == after.notes, "score loaded before is kept after failed load");
+
+   return (0 == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,213 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sinsy.h"
+#include "ToolThread.h"
+
+namespace
+{
+const size_t THREAD_NUM = 8;
+const size_t ITERATION_NUM = 20;
+const size_t ENCODING_NUM = 3;
+const size_t NOTE_NUM = 4;
+const char* ENCODINGS[ENCODING_NUM] = {"utf_8", "shift_jis", "euc_jp"};
+
+// ka sa ta na in each encoding
+const char* LYRICS[ENCODING_NUM][NOTE_NUM] = {
+   {"\xE3\x81\x8B", "\xE3\x81\x95", "\xE3\x81\x9F", "\xE3\x81\xAA"},
+   {"\x82\xA9", "\x82\xB3", "\x82\xBD", "\x82\xC8"},
+   {"\xA4\xAB", "\xA4\xB5", "\xA4\xBF", "\xA4\xCA"}
+};
+
+//! add score of encoding
+bool addScore(sinsy::Sinsy& sinsy, size_t encoding)
+{
+   if (!sinsy.setEncoding(ENCODINGS[encoding])) {
+      return false;
+   }
+   sinsy.addRest(1920);
+   for (size_t i(0); i < NOTE_NUM; ++i) {
+      sinsy.addNote(960, LYRICS[encoding][i], 60 + i, false, false, sinsy::TIETYPE_NONE, sinsy::SLURTYPE_NONE, sinsy::SYLLABICTYPE_SINGLE);
+   }
+   sinsy.addRest(1920);
+   return true;
+}
+
+//! make labels of score
+std::string makeLabels(sinsy::Sinsy& sinsy)
+{
+   sinsy::LabelStrings* label(sinsy.createLabelData(false, 1, 1));
+   if (NULL == label) {
+      return std::string();
+   }
+   std::string str;
+   for (size_t i(0); i < label->size(); ++i) {
+      str += label->getData()[i];
+      str += '\n';
+   }
+   delete label;
+   return str;
+}
+
+//! start gate: all threads use dictionaries for the first time at once
+class Gate
+{
+public:
+   //! constructor
+   Gate() : opened(false) {}
+
+   //! wait until opened
+   void wait() {
+      sinsy::ToolLock lock(mutex);
+      while (!opened) {
+         condition.wait(mutex);
+      }
+   }
+
+   //! open
+   void open() {
+      sinsy::ToolLock lock(mutex);
+      opened = true;
+      condition.broadcast();
+   }
+
+private:
+   sinsy::ToolMutex mutex;
+   sinsy::ToolCondition condition;
+   bool opened;
+};
+
+//! converts lyrics with shared languages
+class Worker : public sinsy::IToolRunnable
+{
+public:
+   //! constructor
+   Worker(const sinsy::Languages& l, size_t e, const std::string& r, Gate& g) : languages(l), encoding(e), reference(r), gate(g), failures(0) {}
+
+   //! run
+   virtual void run() {
+      sinsy::Sinsy sinsy;
+      if (!sinsy.setLanguages(languages) || !addScore(sinsy, encoding)) {
+         failures = ITERATION_NUM;
+         return;
+      }
+      gate.wait();
+      for (size_t i(0); i < ITERATION_NUM; ++i) {
+         if (makeLabels(sinsy) != reference) {
+            ++failures;
+         }
+      }
+   }
+
+   //! get number of failed conversions
+   size_t getFailures() const {
+      return failures;
+   }
+
+private:
+   const sinsy::Languages& languages;
+   const size_t encoding;
+   const std::string& reference;
+   Gate& gate;
+   size_t failures;
+};
+};
+
+int main()
+{
+   const char* dicDir(getenv("SINSY_TEST_DIC_DIR"));
+   if (NULL == dicDir) {
+      std::cerr << "SINSY_TEST_DIC_DIR is needed: skipped" << std::endl;
+      return 77;
+   }
+
+   // reference labels made by Sinsy objects which have their own dictionaries
+   std::vector<std::string> references(ENCODING_NUM);
+   for (size_t i(0); i < ENCODING_NUM; ++i) {
+      sinsy::Sinsy sinsy;
+      if (!sinsy.setLanguages("j", dicDir) || !addScore(sinsy, i)) {
+         std::cerr << "Cannot set up Sinsy" << std::endl;
+         return EXIT_FAILURE;
+      }
+      references[i] = makeLabels(sinsy);
+      if (std::string::npos == references[i].find("-k+a")) {
+         std::cerr << "FAILED: lyrics in " << ENCODINGS[i] << " are not converted" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+
+   // dictionaries are not preloaded, so they are loaded while threads are converting lyrics
+   sinsy::Languages languages;
+   if (!languages.set("j", dicDir)) {
+      std::cerr << "Cannot set languages" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   Gate gate;
+   std::vector<Worker*> workers;
+   std::vector<sinsy::ToolThread*> threads;
+   for (size_t i(0); i < THREAD_NUM; ++i) {
+      workers.push_back(new Worker(languages, i % ENCODING_NUM, references[i % ENCODING_NUM], gate));
+      threads.push_back(new sinsy::ToolThread(*workers.back()));
+      if (!threads.back()->start()) {
+         std::cerr << "Cannot start thread" << std::endl;
+         gate.open();
+         return EXIT_FAILURE;
+      }
+   }
+   gate.open();
+
+   size_t failures(0);
+   for (size_t i(0); i < THREAD_NUM; ++i) {
+      threads[i]->join();
+      failures += workers[i]->getFailures();
+      delete threads[i];
+      delete workers[i];
+   }
+   if (0 != failures) {
+      std::cerr << "FAILED: " << failures << " of " << (THREAD_NUM * ITERATION_NUM) << " conversions differ from reference" << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
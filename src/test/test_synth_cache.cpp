@@ -0,0 +1,159 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SynthCacheImpl.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const size_t SAMPLE_NUM = 100;
+const size_t MAX_MEMORY_SIZE = 2000; // two waveforms (and keys) are kept in memory
+
+//! waveform which is different for each value
+std::vector<double> makeWaveform(double value)
+{
+   return std::vector<double>(SAMPLE_NUM, value);
+}
+
+//! store waveform
+void store(sinsy::SynthCacheImpl& cache, const std::string& key, double value)
+{
+   const std::vector<double> waveform(makeWaveform(value));
+   cache.store(key, &waveform[0], waveform.size());
+}
+
+//! waveform of key is found and has value
+bool found(sinsy::SynthCacheImpl& cache, const std::string& key, double value)
+{
+   std::vector<double> waveform;
+   return cache.find(key, waveform) && (makeWaveform(value) == waveform);
+}
+
+int check(bool f, const char* message)
+{
+   if (!f) {
+      std::cerr << "FAILED: " << message << std::endl;
+      return 1;
+   }
+   return 0;
+}
+
+#ifndef _WIN32
+//! count files in directory (all files are removed if removeFlag is true)
+size_t countFiles(const std::string& dir, const std::string& extension, bool removeFlag)
+{
+   size_t count(0);
+   DIR* d(opendir(dir.c_str()));
+   if (NULL == d) {
+      return 0;
+   }
+   for (struct dirent* e(readdir(d)); NULL != e; e = readdir(d)) {
+      const std::string name(e->d_name);
+      if (("." == name) || (".." == name)) {
+         continue;
+      }
+      if ((extension.size() <= name.size()) && (0 == name.compare(name.size() - extension.size(), extension.size(), extension))) {
+         ++count;
+      }
+      if (removeFlag) {
+         std::remove((dir + "/" + name).c_str());
+      }
+   }
+   closedir(d);
+   return count;
+}
+#endif
+};
+
+int main()
+{
+   int failures(0);
+
+   // same key is stored twice: waveform is kept once and becomes most recently used
+   {
+      sinsy::SynthCacheImpl cache;
+      cache.setMaxMemorySize(MAX_MEMORY_SIZE);
+      store(cache, "a", 1.0);
+      store(cache, "b", 2.0);
+      store(cache, "a", 1.0);
+      store(cache, "c", 3.0);
+      failures += check(found(cache, "a", 1.0), "waveform stored twice is kept");
+      failures += check(!found(cache, "b", 2.0), "least recently used waveform is evicted");
+      failures += check(found(cache, "c", 3.0), "new waveform is kept");
+   }
+
+#ifndef _WIN32
+   // evicted waveforms are spilled only to spill directory
+   char dirTemplate[] = "/tmp/sinsy_test_cache_XXXXXX";
+   const char* dir(mkdtemp(dirTemplate));
+   if (NULL == dir) {
+      std::cerr << "Cannot make temporary directory" << std::endl;
+      return EXIT_FAILURE;
+   }
+   {
+      sinsy::SynthCacheImpl cache;
+      cache.setMaxMemorySize(MAX_MEMORY_SIZE);
+      cache.setSpillDirectory(dir, 1024 * 1024);
+      store(cache, "a", 1.0);
+      store(cache, "a", 1.0);
+      store(cache, "b", 2.0);
+      store(cache, "b", 2.0);
+      store(cache, "c", 3.0);
+      failures += check(1 == countFiles(dir, ".pcm", false), "only evicted waveform is spilled");
+      failures += check(0 == countFiles(dir, ".tmp", false), "no temporary file is left");
+      cache.clear();
+      failures += check(found(cache, "a", 1.0), "spilled waveform is read");
+      failures += check(!found(cache, "b", 2.0), "cleared waveform is not spilled");
+   }
+   countFiles(dir, "", true);
+   rmdir(dir);
+#endif
+
+   return (0 == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,185 @@
+/* ----------------------------------------------------------------- */
+/*           The HMM-Based Singing Voice Synthesis System "Sinsy"    */
+/*           developed by Sinsy Working Group                        */
+/*           http://sinsy.sourceforge.net/                           */
+/* ----------------------------------------------------------------- */
+/*                                                                   */
+/*  Copyright (c) 2009-2015  Nagoya Institute of Technology          */
+/*                           Department of Computer Science          */
+/*                                                                   */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/* - Redistributions of source code must retain the above copyright  */
+/*   notice, this list of conditions and the following disclaimer.   */
+/* - Redistributions in binary form must reproduce the above         */
+/*   copyright notice, this list of conditions and the following     */
+/*   disclaimer in the documentation and/or other materials provided */
+/*   with the distribution.                                          */
+/* - Neither the name of the Sinsy working group nor the names of    */
+/*   its contributors may be used to endorse or promote products     */
+/*   derived from this software without specific prior written       */
+/*   permission.                                                     */
+/*                                                                   */
+/* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND            */
+/* CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,       */
+/* INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF          */
+/* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE          */
+/* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS */
+/* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,          */
+/* EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED   */
+/* TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     */
+/* DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON */
+/* ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,   */
+/* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY    */
+/* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE           */
+/* POSSIBILITY OF SUCH DAMAGE.                                       */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sinsy.h"
+
+namespace
+{
+const size_t PHRASE_NUM = 4;
+const size_t NOTE_NUM_PER_PHRASE = 4;
+const char* LYRICS[NOTE_NUM_PER_PHRASE] = {"\xE3\x81\x8B", "\xE3\x81\x95", "\xE3\x81\x9F", "\xE3\x81\xAA"}; // ka sa ta na (UTF-8)
+
+//! add phrase of notes followed by rest
+void addPhrase(sinsy::Sinsy& sinsy, size_t pitch)
+{
+   for (size_t i(0); i < NOTE_NUM_PER_PHRASE; ++i) {
+      sinsy.addNote(960, LYRICS[i], pitch + i, false, false, sinsy::TIETYPE_NONE, sinsy::SLURTYPE_NONE, sinsy::SYLLABICTYPE_SINGLE);
+   }
+   sinsy.addRest(960);
+}
+
+//! synthesize with session
+bool synthesize(sinsy::Sinsy& sinsy, sinsy::SynthSession& session)
+{
+   std::vector<double> waveform;
+   sinsy::SynthCondition condition;
+   condition.setWaveformBuffer(waveform);
+   return sinsy.synthesize(condition, session) && !waveform.empty();
+}
+
+//! RIFF format data in save buffer has same samples as 16bit waveform buffer
+bool saveBufferMatches(sinsy::Sinsy& sinsy, bool phraseSplitFlag)
+{
+   std::vector<short> waveform;
+   std::vector<char> data;
+   sinsy::SynthCondition condition;
+   if (phraseSplitFlag) {
+      condition.setPhraseSplitFlag();
+   }
+   condition.setWaveformBuffer(waveform);
+   condition.setSaveBuffer(data);
+   if (!sinsy.synthesize(condition) || waveform.empty() || (data.size() != 44 + waveform.size() * 2)) {
+      return false;
+   }
+   if (0 != std::string(data.begin(), data.begin() + 4).compare("RIFF")) {
+      return false;
+   }
+   for (size_t i(0); i < waveform.size(); ++i) {
+      const unsigned short value(static_cast<unsigned short>(waveform[i]));
+      if ((static_cast<unsigned char>(data[44 + i * 2]) != (value & 0xff)) || (static_cast<unsigned char>(data[45 + i * 2]) != (value >> 8))) {
+         return false;
+      }
+   }
+   return true;
+}
+
+int check(bool f, const char* message)
+{
+   if (!f) {
+      std::cerr << "FAILED: " << message << std::endl;
+      return 1;
+   }
+   return 0;
+}
+};
+
+int main()
+{
+   const char* dicDir(getenv("SINSY_TEST_DIC_DIR"));
+   const char* voicePath(getenv("SINSY_TEST_VOICE"));
+   if ((NULL == dicDir) || (NULL == voicePath) || ('\0' == *voicePath)) {
+      std::cerr << "SINSY_TEST_DIC_DIR and SINSY_TEST_VOICE are needed: skipped" << std::endl;
+      return 77;
+   }
+
+   sinsy::Sinsy sinsy;
+   std::vector<std::string> voices(1, voicePath);
+   if (!sinsy.setLanguages("j", dicDir) || !sinsy.loadVoices(voices) || !sinsy.setEncoding("utf_8")) {
+      std::cerr << "Cannot set up Sinsy" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   sinsy.addTempoMark(120.0);
+   sinsy.addRest(960);
+   for (size_t i(0); i < PHRASE_NUM; ++i) {
+      addPhrase(sinsy, 60 + i);
+   }
+
+   int failures(0);
+   sinsy::SynthSession session;
+
+   failures += check(synthesize(sinsy, session), "first synthesis");
+   const size_t phraseNum(session.getSynthesizedPhraseNum());
+   failures += check(PHRASE_NUM <= phraseNum, "score is split into phrases");
+   failures += check(0 == session.getReusedPhraseNum(), "nothing is reused by first synthesis");
+
+   // same score: everything is reused
+   failures += check(synthesize(sinsy, session), "synthesis of same score");
+   failures += check(0 == session.getSynthesizedPhraseNum(), "same score is not synthesized again");
+   failures += check(phraseNum == session.getReusedPhraseNum(), "all phrases are reused");
+
+   // note appended to end of score: only last phrases are synthesized again
+   sinsy.addNote(960, LYRICS[0], 67, false, false, sinsy::TIETYPE_NONE, sinsy::SLURTYPE_NONE, sinsy::SYLLABICTYPE_SINGLE);
+   failures += check(synthesize(sinsy, session), "synthesis after appending note");
+   failures += check(PHRASE_NUM - 2 <= session.getReusedPhraseNum(), "phrases before edited ones are reused after appending note");
+   failures += check(session.getSynthesizedPhraseNum() <= 3, "only phrases near appended note are synthesized");
+
+   // new phrase appended (number of phrases in song is changed)
+   sinsy.addRest(960);
+   addPhrase(sinsy, 70);
+   failures += check(synthesize(sinsy, session), "synthesis after appending phrase");
+   failures += check(PHRASE_NUM - 1 <= session.getReusedPhraseNum(), "phrases before new phrase are reused");
+
+   // same phrase repeated at same position in measures: synthesized only once unless first, last or next to them
+   sinsy::SynthSession repeatedSession;
+   sinsy.clearScore();
+   sinsy.addTempoMark(120.0);
+   sinsy.addRest(3840);
+   for (size_t i(0); i < PHRASE_NUM + 2; ++i) {
+      for (size_t j(0); j < 3; ++j) {
+         sinsy.addNote(960, LYRICS[j], 60, false, false, sinsy::TIETYPE_NONE, sinsy::SLURTYPE_NONE, sinsy::SYLLABICTYPE_SINGLE);
+      }
+      sinsy.addRest(960);
+   }
+   failures += check(synthesize(sinsy, repeatedSession), "synthesis of repeated phrases");
+   failures += check(0 < repeatedSession.getReusedPhraseNum(), "repeated phrases are synthesized only once");
+
+   // exact flag: phrases are synthesized again if song-wide fields are changed
+   sinsy::SynthSession exactSession;
+   exactSession.setExactFlag();
+   failures += check(synthesize(sinsy, exactSession), "first synthesis with exact flag");
+   const size_t exactPhraseNum(exactSession.getSynthesizedPhraseNum());
+   failures += check(synthesize(sinsy, exactSession), "synthesis of same score with exact flag");
+   failures += check(0 == exactSession.getSynthesizedPhraseNum(), "same score is not synthesized again with exact flag");
+   sinsy.addRest(960);
+   addPhrase(sinsy, 70);
+   failures += check(synthesize(sinsy, exactSession), "synthesis after appending phrase with exact flag");
+   failures += check(exactPhraseNum < exactSession.getSynthesizedPhraseNum(), "phrases are synthesized again after number of phrases is changed with exact flag");
+
+   // RIFF format data is saved to memory buffer
+   failures += check(saveBufferMatches(sinsy, false), "RIFF format data is saved to buffer");
+   failures += check(saveBufferMatches(sinsy, true), "RIFF format data is saved to buffer phrase by phrase");
+
+   return (0 == failures) ? EXIT_SUCCESS : EXIT_FAILURE;
+}